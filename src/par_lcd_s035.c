@@ -8,6 +8,7 @@
 #include "fsl_debug_console.h"
 #include "fsl_dbi_flexio_edma.h"
 #include "fsl_flexio_mculcd.h"
+#include "fsl_flexio_mculcd_edma.h"
 #include "fsl_gpio.h"
 #include "fsl_st7796s.h"
 #include "pin_mux.h"
@@ -35,10 +36,45 @@
 #define TOF_FLEXIO_RX_END          7u
 #define TOF_FLEXIO_TIMER           0u
 
+/* Queued fills: each job selects its window once and then streams the
+ * repeated colour as chained MEMORY_WRITE_CONTINUE DMA chunks. The done
+ * callback only chains the chunks of the job in flight; the next job's
+ * window select and buffer refill run in the foreground, from the queueing
+ * and waiting calls, so the caller only blocks when the queue is full.
+ */
+#ifndef PAR_LCD_FILL_QUEUE_LEN
+#define PAR_LCD_FILL_QUEUE_LEN 32u
+#endif
+
+#ifndef PAR_LCD_FILL_CHUNK_PX
+#define PAR_LCD_FILL_CHUNK_PX (TOF_LCD_WIDTH * 4u)
+#endif
+
+#define PAR_LCD_WAIT_SPIN_MAX 60000000u
+
+typedef struct
+{
+    uint16_t x0;
+    uint16_t y0;
+    uint16_t x1;
+    uint16_t y1;
+    uint16_t rgb565;
+} par_lcd_fill_job_t;
+
 static volatile bool s_mem_write_done = false;
 static st7796s_handle_t s_lcd;
 static dbi_flexio_edma_xfer_handle_t s_dbi;
 
+static par_lcd_fill_job_t s_fill_queue[PAR_LCD_FILL_QUEUE_LEN];
+static volatile uint32_t s_fill_head = 0u;
+static volatile uint32_t s_fill_tail = 0u;
+static volatile bool s_fill_active = false;
+static uint32_t s_fill_remaining = 0u;
+static uint16_t s_fill_buf[PAR_LCD_FILL_CHUNK_PX];
+static uint16_t s_fill_buf_color = 0u;
+static uint32_t s_fill_buf_count = 0u;
+static volatile uint32_t s_fill_dropped = 0u;
+
 static void tof_set_cs(bool set)
 {
     GPIO_PinWrite(TOF_LCD_CS_GPIO, TOF_LCD_CS_PIN, set ? 1u : 0u);
@@ -49,10 +85,75 @@ static void tof_set_rs(bool set)
     GPIO_PinWrite(TOF_LCD_RS_GPIO, TOF_LCD_RS_PIN, set ? 1u : 0u);
 }
 
+/* Push the next chunk of the job in flight. Runs from the memory-done
+ * callback, and from the foreground for a job's first chunk; s_fill_active
+ * owns the bus between the two.
+ */
+static void par_lcd_fill_issue(uint32_t cmd)
+{
+    const uint32_t chunk = (s_fill_remaining < PAR_LCD_FILL_CHUNK_PX) ? s_fill_remaining : PAR_LCD_FILL_CHUNK_PX;
+    s_fill_remaining -= chunk;
+    if (g_dbiFlexioEdmaXferOps.writeMemory(&s_dbi, cmd, s_fill_buf, chunk * 2u) != kStatus_Success)
+    {
+        /* Drop the rest of this job rather than waiting on a callback that
+         * will never arrive.
+         */
+        s_fill_remaining = 0u;
+        s_fill_dropped++;
+        s_fill_active = false;
+    }
+}
+
+/* Start the oldest queued job; foreground only, with the bus idle. */
+static bool par_lcd_fill_start(void)
+{
+    const uint32_t tail = s_fill_tail;
+    if (tail == s_fill_head)
+    {
+        return false;
+    }
+
+    const par_lcd_fill_job_t *job = &s_fill_queue[tail % PAR_LCD_FILL_QUEUE_LEN];
+    const uint32_t w = (uint32_t)job->x1 - (uint32_t)job->x0 + 1u;
+    const uint32_t h = (uint32_t)job->y1 - (uint32_t)job->y0 + 1u;
+    const uint32_t n = w * h;
+    const uint32_t need = (n < PAR_LCD_FILL_CHUNK_PX) ? n : PAR_LCD_FILL_CHUNK_PX;
+
+    /* No chunk is in flight, so the buffer is free to refill. */
+    if (job->rgb565 != s_fill_buf_color)
+    {
+        s_fill_buf_color = job->rgb565;
+        s_fill_buf_count = 0u;
+    }
+    while (s_fill_buf_count < need)
+    {
+        s_fill_buf[s_fill_buf_count++] = s_fill_buf_color;
+    }
+
+    ST7796S_SelectArea(&s_lcd, job->x0, job->y0, job->x1, job->y1);
+    s_fill_remaining = n;
+    s_fill_tail = tail + 1u;
+    s_fill_active = true;
+    par_lcd_fill_issue((uint32_t)kMIPI_DBI_WriteMemoryStart);
+    return true;
+}
+
 static void tof_dbi_done_cb(status_t status, void *userData)
 {
     (void)status;
     (void)userData;
+    if (s_fill_active)
+    {
+        if (s_fill_remaining > 0u)
+        {
+            par_lcd_fill_issue((uint32_t)kMIPI_DBI_WriteMemoryContinue);
+        }
+        else
+        {
+            s_fill_active = false;
+        }
+        return;
+    }
     s_mem_write_done = true;
 }
 
@@ -77,7 +178,7 @@ static void tof_lcd_wait_write_done(void)
     uint32_t spin = 0;
     while (!s_mem_write_done)
     {
-        if (++spin > 60000000u)
+        if (++spin > PAR_LCD_WAIT_SPIN_MAX)
         {
             s_mem_write_done = true;
             break;
@@ -86,6 +187,14 @@ static void tof_lcd_wait_write_done(void)
     }
 }
 
+static void tof_lcd_clip(int32_t *x0, int32_t *y0, int32_t *x1, int32_t *y1)
+{
+    if (*x0 < 0) *x0 = 0;
+    if (*y0 < 0) *y0 = 0;
+    if (*x1 >= (int32_t)TOF_LCD_WIDTH) *x1 = (int32_t)TOF_LCD_WIDTH - 1;
+    if (*y1 >= (int32_t)TOF_LCD_HEIGHT) *y1 = (int32_t)TOF_LCD_HEIGHT - 1;
+}
+
 bool par_lcd_s035_init(void)
 {
     BOARD_InitLcdPins();
@@ -135,64 +244,120 @@ bool par_lcd_s035_init(void)
     return true;
 }
 
-void par_lcd_s035_fill(uint16_t rgb565)
+bool par_lcd_s035_busy(void)
 {
-    static uint16_t line[TOF_LCD_WIDTH];
-    for (uint32_t i = 0; i < TOF_LCD_WIDTH; i++)
+    if (!s_fill_active)
     {
-        line[i] = rgb565;
+        (void)par_lcd_fill_start();
     }
+    return s_fill_active;
+}
 
-    for (uint32_t y = 0; y < TOF_LCD_HEIGHT; y++)
+void par_lcd_s035_wait_idle(void)
+{
+    uint32_t spin = 0u;
+    for (;;)
     {
-        ST7796S_SelectArea(&s_lcd, 0u, (uint16_t)y, TOF_LCD_WIDTH - 1u, (uint16_t)y);
-        s_mem_write_done = false;
-        ST7796S_WritePixels(&s_lcd, line, TOF_LCD_WIDTH);
-        tof_lcd_wait_write_done();
+        if (!s_fill_active)
+        {
+            if (!par_lcd_fill_start())
+            {
+                break;
+            }
+            spin = 0u;
+            continue;
+        }
+
+        if (++spin > PAR_LCD_WAIT_SPIN_MAX)
+        {
+            /* Stop the DMA and FlexIO before giving the bus back, so the
+             * next window select cannot land in the middle of a transfer.
+             */
+            uint32_t primask = DisableGlobalIRQ();
+            FLEXIO_MCULCD_TransferAbortEDMA(&s_flexio_lcd, &s_dbi.flexioHandle);
+            const uint32_t dropped = 1u + (s_fill_head - s_fill_tail);
+            s_fill_dropped += dropped;
+            s_fill_tail = s_fill_head;
+            s_fill_remaining = 0u;
+            s_fill_active = false;
+            EnableGlobalIRQ(primask);
+            PRINTF("TOF LCD: fill timeout, dropped %u jobs\r\n", (unsigned)dropped);
+            break;
+        }
+        __NOP();
     }
 }
 
+uint32_t par_lcd_s035_take_dropped_fills(void)
+{
+    uint32_t primask = DisableGlobalIRQ();
+    const uint32_t dropped = s_fill_dropped;
+    s_fill_dropped = 0u;
+    EnableGlobalIRQ(primask);
+    return dropped;
+}
+
+void par_lcd_s035_fill(uint16_t rgb565)
+{
+    par_lcd_s035_fill_rect(0, 0, (int32_t)TOF_LCD_WIDTH - 1, (int32_t)TOF_LCD_HEIGHT - 1, rgb565);
+}
+
 void par_lcd_s035_blit_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t *rgb565)
 {
     if (!rgb565) return;
     if (x1 < x0 || y1 < y0) return;
-    if (x0 < 0) x0 = 0;
-    if (y0 < 0) y0 = 0;
-    if (x1 >= (int32_t)TOF_LCD_WIDTH) x1 = (int32_t)TOF_LCD_WIDTH - 1;
-    if (y1 >= (int32_t)TOF_LCD_HEIGHT) y1 = (int32_t)TOF_LCD_HEIGHT - 1;
+    tof_lcd_clip(&x0, &y0, &x1, &y1);
 
     uint32_t w = (uint32_t)(x1 - x0 + 1);
     uint32_t h = (uint32_t)(y1 - y0 + 1);
     uint32_t n = w * h;
 
+    par_lcd_s035_wait_idle();
     ST7796S_SelectArea(&s_lcd, (uint16_t)x0, (uint16_t)y0, (uint16_t)x1, (uint16_t)y1);
     s_mem_write_done = false;
     ST7796S_WritePixels(&s_lcd, rgb565, n);
     tof_lcd_wait_write_done();
 }
 
-void par_lcd_s035_fill_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t rgb565)
+void par_lcd_s035_fill_rect_async(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t rgb565)
 {
     if (x1 < x0 || y1 < y0) return;
-    if (x0 < 0) x0 = 0;
-    if (y0 < 0) y0 = 0;
-    if (x1 >= (int32_t)TOF_LCD_WIDTH) x1 = (int32_t)TOF_LCD_WIDTH - 1;
-    if (y1 >= (int32_t)TOF_LCD_HEIGHT) y1 = (int32_t)TOF_LCD_HEIGHT - 1;
-
-    uint32_t w = (uint32_t)(x1 - x0 + 1);
-    static uint16_t row[TOF_LCD_WIDTH];
-    if (w > TOF_LCD_WIDTH) w = TOF_LCD_WIDTH;
+    tof_lcd_clip(&x0, &y0, &x1, &y1);
+    if (x1 < x0 || y1 < y0) return;
 
-    for (uint32_t i = 0; i < w; i++)
+    /* Wait for a free slot, starting queued jobs as the bus frees up. */
+    uint32_t spin = 0u;
+    while ((s_fill_head - s_fill_tail) >= PAR_LCD_FILL_QUEUE_LEN)
     {
-        row[i] = rgb565;
+        if (!s_fill_active)
+        {
+            (void)par_lcd_fill_start();
+            continue;
+        }
+        if (++spin > PAR_LCD_WAIT_SPIN_MAX)
+        {
+            par_lcd_s035_wait_idle();
+            break;
+        }
+        __NOP();
     }
 
-    for (int32_t y = y0; y <= y1; y++)
+    par_lcd_fill_job_t *job = &s_fill_queue[s_fill_head % PAR_LCD_FILL_QUEUE_LEN];
+    job->x0 = (uint16_t)x0;
+    job->y0 = (uint16_t)y0;
+    job->x1 = (uint16_t)x1;
+    job->y1 = (uint16_t)y1;
+    job->rgb565 = rgb565;
+
+    s_fill_head = s_fill_head + 1u;
+    if (!s_fill_active)
     {
-        ST7796S_SelectArea(&s_lcd, (uint16_t)x0, (uint16_t)y, (uint16_t)x1, (uint16_t)y);
-        s_mem_write_done = false;
-        ST7796S_WritePixels(&s_lcd, row, w);
-        tof_lcd_wait_write_done();
+        (void)par_lcd_fill_start();
     }
 }
+
+void par_lcd_s035_fill_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t rgb565)
+{
+    par_lcd_s035_fill_rect_async(x0, y0, x1, y1, rgb565);
+    par_lcd_s035_wait_idle();
+}
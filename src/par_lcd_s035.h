@@ -7,3 +7,19 @@ bool par_lcd_s035_init(void);
 void par_lcd_s035_fill(uint16_t rgb565);
 void par_lcd_s035_blit_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t *rgb565);
 void par_lcd_s035_fill_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t rgb565);
+/* Queue a solid fill and return once it is queued. The job in flight runs
+ * in the background; the next one starts on a later call into the driver
+ * (queueing, busy, wait_idle). Blocking calls above drain the queue before
+ * touching the bus.
+ */
+void par_lcd_s035_fill_rect_async(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t rgb565);
+/* True while a fill is in flight; starts the next queued job first. */
+bool par_lcd_s035_busy(void);
+/* Drain the queue. A transfer that does not complete is aborted and the
+ * remaining jobs are dropped.
+ */
+void par_lcd_s035_wait_idle(void);
+/* Fill jobs dropped since the last call: aborted on a wait_idle timeout or
+ * refused by the DMA.
+ */
+uint32_t par_lcd_s035_take_dropped_fills(void);
@@ -1,23 +1,298 @@
 #include "platform/display_hal.h"
 
+#include <string.h>
+
 #include "par_lcd_s035.h"
 
+/* Display list: solid fills are recorded for the whole frame and resolved
+ * row by row at flush time, so each pixel is pushed once with its final
+ * colour. Identical runs on consecutive rows are merged back into
+ * rectangles before they are queued as DMA fills. Blits reference caller
+ * memory, so they flush the list and go straight to the panel.
+ */
+#ifndef DISPLAY_HAL_LIST_ENABLE
+#define DISPLAY_HAL_LIST_ENABLE 1
+#endif
+
+#ifndef DISPLAY_HAL_LIST_MAX_OPS
+#define DISPLAY_HAL_LIST_MAX_OPS 1024u
+#endif
+
+#ifndef DISPLAY_HAL_LIST_BAND_ROWS
+#define DISPLAY_HAL_LIST_BAND_ROWS 16
+#endif
+
+#ifndef DISPLAY_HAL_LIST_MAX_RUNS
+#define DISPLAY_HAL_LIST_MAX_RUNS 128u
+#endif
+
+typedef struct
+{
+    int16_t x0;
+    int16_t y0;
+    int16_t x1;
+    int16_t y1;
+    uint16_t rgb565;
+} display_list_op_t;
+
+typedef struct
+{
+    int16_t x0;
+    int16_t x1;
+    int16_t y0;
+    uint16_t rgb565;
+} display_list_run_t;
+
+static display_hal_frame_stats_t s_frame_stats;
+static display_hal_frame_stats_t s_cur_stats;
+
+#if DISPLAY_HAL_LIST_ENABLE
+static display_list_op_t s_ops[DISPLAY_HAL_LIST_MAX_OPS];
+static uint32_t s_op_count = 0u;
+static uint16_t s_band_ops[DISPLAY_HAL_LIST_MAX_OPS];
+static uint16_t s_row_color[TOF_LCD_W];
+static uint8_t s_row_cover[TOF_LCD_W];
+static display_list_run_t s_runs[2][DISPLAY_HAL_LIST_MAX_RUNS];
+#endif
+
+static void display_hal_push_fill(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t rgb565)
+{
+    s_cur_stats.bytes_pushed += (uint32_t)(x1 - x0 + 1) * (uint32_t)(y1 - y0 + 1) * 2u;
+    s_cur_stats.transfers++;
+    par_lcd_s035_fill_rect_async(x0, y0, x1, y1, rgb565);
+}
+
+#if DISPLAY_HAL_LIST_ENABLE
+static void display_list_emit(const display_list_run_t *r, int32_t y_last)
+{
+    display_hal_push_fill(r->x0, r->y0, r->x1, y_last, r->rgb565);
+}
+
+static void display_list_flush(void)
+{
+    if (s_op_count == 0u)
+    {
+        return;
+    }
+
+    int32_t min_y = TOF_LCD_H;
+    int32_t max_y = -1;
+    for (uint32_t i = 0u; i < s_op_count; i++)
+    {
+        if (s_ops[i].y0 < min_y) min_y = s_ops[i].y0;
+        if (s_ops[i].y1 > max_y) max_y = s_ops[i].y1;
+    }
+
+    /* Runs still open from the previous row, and the runs of this row. */
+    display_list_run_t *prev = s_runs[0];
+    display_list_run_t *cur = s_runs[1];
+    uint32_t prev_n = 0u;
+
+    const int32_t band0 = min_y - (min_y % DISPLAY_HAL_LIST_BAND_ROWS);
+    for (int32_t by = band0; by <= max_y; by += DISPLAY_HAL_LIST_BAND_ROWS)
+    {
+        const int32_t by1 = by + DISPLAY_HAL_LIST_BAND_ROWS - 1;
+        uint32_t band_n = 0u;
+        for (uint32_t i = 0u; i < s_op_count; i++)
+        {
+            if (s_ops[i].y1 >= by && s_ops[i].y0 <= by1)
+            {
+                s_band_ops[band_n++] = (uint16_t)i;
+            }
+        }
+
+        for (int32_t y = by; y <= by1; y++)
+        {
+            int32_t row_x0 = TOF_LCD_W;
+            int32_t row_x1 = -1;
+            for (uint32_t k = 0u; k < band_n; k++)
+            {
+                const display_list_op_t *op = &s_ops[s_band_ops[k]];
+                if (y < op->y0 || y > op->y1)
+                {
+                    continue;
+                }
+                if (op->x0 < row_x0)
+                {
+                    if (row_x1 >= 0)
+                    {
+                        memset(&s_row_cover[op->x0], 0, (size_t)(row_x0 - op->x0));
+                    }
+                    row_x0 = op->x0;
+                }
+                if (op->x1 > row_x1)
+                {
+                    if (row_x1 >= 0)
+                    {
+                        memset(&s_row_cover[row_x1 + 1], 0, (size_t)(op->x1 - row_x1));
+                    }
+                    row_x1 = op->x1;
+                }
+                for (int32_t x = op->x0; x <= op->x1; x++)
+                {
+                    s_row_color[x] = op->rgb565;
+                    s_row_cover[x] = 1u;
+                }
+            }
+
+            /* Split the row into covered runs of one colour and merge each
+             * with an identical run on the row above.
+             */
+            uint32_t cur_n = 0u;
+            uint32_t p = 0u;
+            int32_t x = row_x0;
+            while (x <= row_x1)
+            {
+                if (!s_row_cover[x])
+                {
+                    x++;
+                    continue;
+                }
+                const uint16_t c = s_row_color[x];
+                const int32_t rx0 = x;
+                while (x <= row_x1 && s_row_cover[x] && s_row_color[x] == c)
+                {
+                    x++;
+                }
+                const int32_t rx1 = x - 1;
+
+                while (p < prev_n && prev[p].x0 < rx0)
+                {
+                    display_list_emit(&prev[p++], y - 1);
+                }
+                int32_t ry0 = y;
+                if (p < prev_n && prev[p].x0 == rx0 && prev[p].x1 == rx1 && prev[p].rgb565 == c)
+                {
+                    ry0 = prev[p++].y0;
+                }
+
+                if (cur_n < DISPLAY_HAL_LIST_MAX_RUNS)
+                {
+                    cur[cur_n].x0 = (int16_t)rx0;
+                    cur[cur_n].x1 = (int16_t)rx1;
+                    cur[cur_n].y0 = (int16_t)ry0;
+                    cur[cur_n].rgb565 = c;
+                    cur_n++;
+                }
+                else
+                {
+                    display_hal_push_fill(rx0, ry0, rx1, y, c);
+                }
+            }
+            while (p < prev_n)
+            {
+                display_list_emit(&prev[p++], y - 1);
+            }
+
+            display_list_run_t *t = prev;
+            prev = cur;
+            cur = t;
+            prev_n = cur_n;
+        }
+    }
+
+    for (uint32_t p = 0u; p < prev_n; p++)
+    {
+        display_list_emit(&prev[p], max_y);
+    }
+    s_op_count = 0u;
+}
+#endif
+
 bool display_hal_init(void)
 {
+    memset(&s_frame_stats, 0, sizeof(s_frame_stats));
+    memset(&s_cur_stats, 0, sizeof(s_cur_stats));
     return par_lcd_s035_init();
 }
 
 void display_hal_fill(uint16_t rgb565)
 {
-    par_lcd_s035_fill(rgb565);
+#if DISPLAY_HAL_LIST_ENABLE
+    /* Everything recorded so far is hidden by a full-screen fill. */
+    s_op_count = 0u;
+#endif
+    display_hal_fill_rect(0, 0, TOF_LCD_W - 1, TOF_LCD_H - 1, rgb565);
 }
 
 void display_hal_blit_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t *rgb565)
 {
+    if (rgb565 && x1 >= x0 && y1 >= y0)
+    {
+        const uint32_t bytes = (uint32_t)(x1 - x0 + 1) * (uint32_t)(y1 - y0 + 1) * 2u;
+        s_cur_stats.bytes_requested += bytes;
+        s_cur_stats.bytes_pushed += bytes;
+        s_cur_stats.transfers++;
+    }
+#if DISPLAY_HAL_LIST_ENABLE
+    display_list_flush();
+#endif
     par_lcd_s035_blit_rect(x0, y0, x1, y1, rgb565);
 }
 
 void display_hal_fill_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t rgb565)
 {
-    par_lcd_s035_fill_rect(x0, y0, x1, y1, rgb565);
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= TOF_LCD_W) x1 = TOF_LCD_W - 1;
+    if (y1 >= TOF_LCD_H) y1 = TOF_LCD_H - 1;
+    if (x1 < x0 || y1 < y0) return;
+
+    s_cur_stats.bytes_requested += (uint32_t)(x1 - x0 + 1) * (uint32_t)(y1 - y0 + 1) * 2u;
+#if DISPLAY_HAL_LIST_ENABLE
+    if (s_op_count >= DISPLAY_HAL_LIST_MAX_OPS)
+    {
+        s_cur_stats.list_overflows++;
+        display_list_flush();
+    }
+    display_list_op_t *op = &s_ops[s_op_count++];
+    op->x0 = (int16_t)x0;
+    op->y0 = (int16_t)y0;
+    op->x1 = (int16_t)x1;
+    op->y1 = (int16_t)y1;
+    op->rgb565 = rgb565;
+#else
+    display_hal_push_fill(x0, y0, x1, y1, rgb565);
+#endif
+}
+
+void display_hal_flush(void)
+{
+#if DISPLAY_HAL_LIST_ENABLE
+    display_list_flush();
+#endif
+}
+
+void display_hal_frame_end(void)
+{
+    display_hal_flush();
+    s_cur_stats.dropped_fills = par_lcd_s035_take_dropped_fills();
+    s_cur_stats.frame = s_frame_stats.frame + 1u;
+    s_frame_stats = s_cur_stats;
+    memset(&s_cur_stats, 0, sizeof(s_cur_stats));
+}
+
+void display_hal_get_frame_stats(display_hal_frame_stats_t *out)
+{
+    if (out)
+    {
+        *out = s_frame_stats;
+    }
+}
+
+bool display_hal_busy(void)
+{
+#if DISPLAY_HAL_LIST_ENABLE
+    if (s_op_count > 0u)
+    {
+        return true;
+    }
+#endif
+    return par_lcd_s035_busy();
+}
+
+void display_hal_wait_idle(void)
+{
+    display_hal_flush();
+    par_lcd_s035_wait_idle();
 }
@@ -6,7 +6,28 @@
 #define TOF_LCD_W 480
 #define TOF_LCD_H 320
 
+typedef struct
+{
+    uint32_t frame;
+    uint32_t bytes_requested; /* pixels the drawing code asked for, x2 */
+    uint32_t bytes_pushed;    /* pixels that actually went over the bus, x2 */
+    uint32_t transfers;
+    uint32_t list_overflows;
+    uint32_t dropped_fills; /* fill jobs the bus driver dropped */
+} display_hal_frame_stats_t;
+
 bool display_hal_init(void);
+/* Fills are recorded in the display list and reach the panel at the next
+ * flush; blits flush the list first and return once the caller's buffer
+ * has been written.
+ */
 void display_hal_fill(uint16_t rgb565);
 void display_hal_blit_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t *rgb565);
 void display_hal_fill_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t rgb565);
+void display_hal_flush(void);
+/* Flush and latch the per-frame byte counters. */
+void display_hal_frame_end(void);
+void display_hal_get_frame_stats(display_hal_frame_stats_t *out);
+/* Fence: true while recorded or queued fills have not reached the panel. */
+bool display_hal_busy(void);
+void display_hal_wait_idle(void);
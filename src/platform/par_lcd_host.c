@@ -0,0 +1,137 @@
+#include "platform/par_lcd_host.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "par_lcd_s035.h"
+#include "platform/display_hal.h"
+
+static uint16_t s_fb[TOF_LCD_H * TOF_LCD_W];
+static par_lcd_host_stats_t s_stats;
+
+static bool par_lcd_host_clip(int32_t *x0, int32_t *y0, int32_t *x1, int32_t *y1)
+{
+    if (*x0 < 0) *x0 = 0;
+    if (*y0 < 0) *y0 = 0;
+    if (*x1 >= TOF_LCD_W) *x1 = TOF_LCD_W - 1;
+    if (*y1 >= TOF_LCD_H) *y1 = TOF_LCD_H - 1;
+    return (*x1 >= *x0) && (*y1 >= *y0);
+}
+
+bool par_lcd_s035_init(void)
+{
+    memset(s_fb, 0, sizeof(s_fb));
+    memset(&s_stats, 0, sizeof(s_stats));
+    return true;
+}
+
+bool par_lcd_s035_busy(void)
+{
+    return false;
+}
+
+void par_lcd_s035_wait_idle(void)
+{
+}
+
+uint32_t par_lcd_s035_take_dropped_fills(void)
+{
+    return 0u;
+}
+
+void par_lcd_s035_fill(uint16_t rgb565)
+{
+    par_lcd_s035_fill_rect(0, 0, TOF_LCD_W - 1, TOF_LCD_H - 1, rgb565);
+}
+
+void par_lcd_s035_blit_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t *rgb565)
+{
+    if (!rgb565) return;
+    if (x1 < x0 || y1 < y0) return;
+    if (!par_lcd_host_clip(&x0, &y0, &x1, &y1)) return;
+
+    /* Like the panel, the clipped window is streamed from the start of the
+     * buffer.
+     */
+    const uint32_t w = (uint32_t)(x1 - x0 + 1);
+    const uint16_t *src = rgb565;
+    for (int32_t y = y0; y <= y1; y++)
+    {
+        memcpy(&s_fb[(y * TOF_LCD_W) + x0], src, w * sizeof(uint16_t));
+        src += w;
+    }
+
+    s_stats.blit_calls++;
+    s_stats.window_selects++;
+    s_stats.pixels += w * (uint32_t)(y1 - y0 + 1);
+}
+
+void par_lcd_s035_fill_rect_async(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t rgb565)
+{
+    s_stats.fill_calls++;
+    if (x1 < x0 || y1 < y0) return;
+    if (!par_lcd_host_clip(&x0, &y0, &x1, &y1)) return;
+
+    for (int32_t y = y0; y <= y1; y++)
+    {
+        uint16_t *dst = &s_fb[(y * TOF_LCD_W) + x0];
+        for (int32_t x = x0; x <= x1; x++)
+        {
+            *dst++ = rgb565;
+        }
+    }
+
+    s_stats.window_selects++;
+    s_stats.pixels += (uint32_t)(x1 - x0 + 1) * (uint32_t)(y1 - y0 + 1);
+}
+
+void par_lcd_s035_fill_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t rgb565)
+{
+    par_lcd_s035_fill_rect_async(x0, y0, x1, y1, rgb565);
+}
+
+const uint16_t *par_lcd_host_framebuffer(void)
+{
+    return s_fb;
+}
+
+void par_lcd_host_take_stats(par_lcd_host_stats_t *out)
+{
+    if (out)
+    {
+        *out = s_stats;
+    }
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+bool par_lcd_host_write_ppm(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f)
+    {
+        return false;
+    }
+
+    bool ok = fprintf(f, "P6\n%d %d\n255\n", TOF_LCD_W, TOF_LCD_H) > 0;
+    uint8_t row[TOF_LCD_W * 3];
+    for (int32_t y = 0; ok && y < TOF_LCD_H; y++)
+    {
+        for (int32_t x = 0; x < TOF_LCD_W; x++)
+        {
+            const uint16_t c = s_fb[(y * TOF_LCD_W) + x];
+            const uint32_t r5 = (c >> 11) & 0x1Fu;
+            const uint32_t g6 = (c >> 5) & 0x3Fu;
+            const uint32_t b5 = c & 0x1Fu;
+            row[(x * 3) + 0] = (uint8_t)((r5 << 3) | (r5 >> 2));
+            row[(x * 3) + 1] = (uint8_t)((g6 << 2) | (g6 >> 4));
+            row[(x * 3) + 2] = (uint8_t)((b5 << 3) | (b5 >> 2));
+        }
+        ok = fwrite(row, sizeof(row), 1u, f) == 1u;
+    }
+
+    if (fclose(f) != 0)
+    {
+        ok = false;
+    }
+    return ok;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Host stand-in for par_lcd_s035.c: implements the par_lcd_s035_* API on
+ * an in-memory 480x320 RGB565 framebuffer so display_hal.c and the drawing
+ * code above it run on Linux. Link it instead of par_lcd_s035.c.
+ */
+
+typedef struct
+{
+    uint32_t fill_calls;     /* fill_rect / fill_rect_async / fill */
+    uint32_t blit_calls;
+    uint32_t pixels;         /* pixels written after clipping */
+    uint32_t window_selects; /* one per queued fill job or blit, as on the panel */
+} par_lcd_host_stats_t;
+
+const uint16_t *par_lcd_host_framebuffer(void);
+/* Copy the counters gathered since the last call and reset them; call once
+ * per frame for per-frame numbers.
+ */
+void par_lcd_host_take_stats(par_lcd_host_stats_t *out);
+/* Write the framebuffer as a binary PPM (P6); false on I/O error. */
+bool par_lcd_host_write_ppm(const char *path);
@@ -0,0 +1,249 @@
+#include "tof_source.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Replay backend for host runs: streams a serial log (AI_F64 lines) or a
+ * binary capture file through the demo pipeline, one record per tick at
+ * most, either on the recorded timeline or as fast as the pipeline takes it.
+ */
+
+#define TOF_REPLAY_MAGIC "TOFC"
+#define TOF_REPLAY_VERSION 1u
+#define TOF_REPLAY_RECORD_SIZE 400u
+#define TOF_REPLAY_LINE_MAX 1024u
+
+typedef enum
+{
+    kTofReplayText = 0,
+    kTofReplayBinary,
+} tof_replay_format_t;
+
+static const char *s_path = NULL;
+static bool s_realtime = false;
+static uint32_t s_tick_us = 1u;
+
+static FILE *s_file = NULL;
+static tof_replay_format_t s_format = kTofReplayText;
+static uint32_t s_frames = 0u;
+static bool s_eof_reported = false;
+static uint32_t s_last_tick = 0u;
+static bool s_last_tick_valid = false;
+
+/* Pending record and the timeline anchor for realtime replay. */
+static tof_source_frame_t s_next;
+static uint32_t s_next_t_us = 0u;
+static bool s_next_valid = false;
+static uint32_t s_first_t_us = 0u;
+static uint32_t s_first_tick = 0u;
+static bool s_anchored = false;
+
+void tof_source_replay_configure(const char *path, bool realtime, uint32_t tick_us)
+{
+    s_path = path;
+    s_realtime = realtime;
+    s_tick_us = (tick_us > 0u) ? tick_us : 1u;
+}
+
+static uint32_t tof_replay_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool tof_replay_open(void)
+{
+    if (s_file)
+    {
+        fclose(s_file);
+        s_file = NULL;
+    }
+    s_frames = 0u;
+    s_eof_reported = false;
+    s_last_tick_valid = false;
+    s_next_valid = false;
+    s_anchored = false;
+
+    if (!s_path)
+    {
+        return false;
+    }
+    s_file = fopen(s_path, "rb");
+    if (!s_file)
+    {
+        printf("TOF replay: cannot open %s\r\n", s_path);
+        return false;
+    }
+
+    uint8_t header[8];
+    s_format = kTofReplayText;
+    if (fread(header, 1u, sizeof(header), s_file) == sizeof(header) &&
+        memcmp(header, TOF_REPLAY_MAGIC, 4u) == 0)
+    {
+        const uint32_t version = (uint32_t)header[4] | ((uint32_t)header[5] << 8);
+        const uint32_t record_size = (uint32_t)header[6] | ((uint32_t)header[7] << 8);
+        if (version != TOF_REPLAY_VERSION || record_size != TOF_REPLAY_RECORD_SIZE)
+        {
+            printf("TOF replay: unsupported capture v%u/%u\r\n", (unsigned)version, (unsigned)record_size);
+            fclose(s_file);
+            s_file = NULL;
+            return false;
+        }
+        s_format = kTofReplayBinary;
+    }
+    else
+    {
+        rewind(s_file);
+    }
+
+    printf("TOF replay: %s (%s, %s)\r\n",
+           s_path,
+           (s_format == kTofReplayBinary) ? "binary" : "AI_F64 log",
+           s_realtime ? "realtime" : "unthrottled");
+    return true;
+}
+
+static bool tof_replay_next_binary(tof_source_frame_t *out, uint32_t *t_us)
+{
+    uint8_t rec[TOF_REPLAY_RECORD_SIZE];
+    if (fread(rec, 1u, sizeof(rec), s_file) != sizeof(rec))
+    {
+        return false;
+    }
+
+    const uint8_t *p = rec;
+    *t_us = tof_replay_le32(p);
+    const uint8_t flags = p[4];
+    p += 8u;
+    out->zone_mask = (uint64_t)tof_replay_le32(p) | ((uint64_t)tof_replay_le32(p + 4u) << 32);
+    p += 8u;
+    for (uint32_t r = 0u; r < 2u; r++)
+    {
+        for (uint32_t i = 0u; i < 64u; i++)
+        {
+            out->ret.mm[r][i] = (uint16_t)((uint16_t)p[0] | ((uint16_t)p[1] << 8));
+            p += 2u;
+        }
+    }
+    memcpy(out->ret.conf, p, sizeof(out->ret.conf));
+    out->complete = (flags & 0x01u) != 0u;
+    out->has_conf = (flags & 0x02u) != 0u;
+    return true;
+}
+
+static bool tof_replay_next_text(tof_source_frame_t *out, uint32_t *t_us)
+{
+    char line[TOF_REPLAY_LINE_MAX];
+    while (fgets(line, sizeof(line), s_file))
+    {
+        /* Capture tools may prefix host timestamps; find the marker. */
+        const char *p = strstr(line, "AI_F64,t=");
+        if (!p)
+        {
+            continue;
+        }
+
+        char *end = NULL;
+        const unsigned long t = strtoul(p + 9, &end, 10);
+        uint32_t count = 0u;
+        while (end && *end == ',' && count < 64u)
+        {
+            const char *start = end + 1;
+            const unsigned long v = strtoul(start, &end, 10);
+            if (end == start)
+            {
+                break;
+            }
+            out->ret.mm[0][count++] = (uint16_t)((v > 0xFFFFu) ? 0xFFFFu : v);
+        }
+        if (count != 64u)
+        {
+            continue;
+        }
+
+        /* AI_F64 carries whole frames stamped in device ticks. */
+        *t_us = (uint32_t)t * s_tick_us;
+        out->zone_mask = ~(uint64_t)0u;
+        out->complete = true;
+        out->has_conf = false;
+        return true;
+    }
+    return false;
+}
+
+static bool tof_replay_read(tof_source_frame_t *out, uint32_t tick)
+{
+    if (!s_file)
+    {
+        return false;
+    }
+
+    /* One record per tick, so every record is drawn and modelled as the
+     * live sensor's would be instead of being folded into a burst.
+     */
+    if (s_last_tick_valid && s_last_tick == tick)
+    {
+        return false;
+    }
+
+    if (!s_next_valid)
+    {
+        memset(&s_next, 0, sizeof(s_next));
+        s_next_valid = (s_format == kTofReplayBinary) ? tof_replay_next_binary(&s_next, &s_next_t_us)
+                                                      : tof_replay_next_text(&s_next, &s_next_t_us);
+        if (!s_next_valid)
+        {
+            if (!s_eof_reported)
+            {
+                s_eof_reported = true;
+                printf("TOF replay: end of capture after %u frames\r\n", (unsigned)s_frames);
+            }
+            return false;
+        }
+    }
+
+    if (s_realtime)
+    {
+        if (!s_anchored)
+        {
+            s_anchored = true;
+            s_first_t_us = s_next_t_us;
+            s_first_tick = tick;
+        }
+        const uint64_t due_us = (uint64_t)(uint32_t)(s_next_t_us - s_first_t_us);
+        const uint64_t now_us = (uint64_t)(uint32_t)(tick - s_first_tick) * s_tick_us;
+        if (due_us > now_us)
+        {
+            return false;
+        }
+    }
+
+    *out = s_next;
+    s_next_valid = false;
+    s_last_tick = tick;
+    s_last_tick_valid = true;
+    s_frames++;
+    return true;
+}
+
+static bool tof_replay_finished(void)
+{
+    return !s_file || s_eof_reported;
+}
+
+uint32_t tof_source_replay_frames(void)
+{
+    return s_frames;
+}
+
+const tof_source_t g_tof_source_replay = {
+    .name = "replay",
+    .open = tof_replay_open,
+    .read = tof_replay_read,
+    /* A capture is never restarted: zero-valid streaks and the gap at
+     * end of file are part of the recording.
+     */
+    .restart = NULL,
+    .recover = NULL,
+    .finished = tof_replay_finished,
+};
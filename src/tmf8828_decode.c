@@ -0,0 +1,661 @@
+#include "tmf8828_decode.h"
+
+#include <string.h>
+
+#define TMF8828_RESULT_CID 0x10u /* CMD_MEASURE echoed in byte 0 */
+
+#define TMF8828_OBJ1_OFFSET       24u
+#define TMF8828_OBJ_ENTRY_SIZE    6u
+#define TMF8828_OBJ_ENTRIES_RAW   18u
+#define TMF8828_MIN_CONFIDENCE    0u
+#define TMF8828_CLOSE_CAL_MAX_MM  120u
+#define TMF8828_TOO_CLOSE_MM      50u
+#define TMF8828_ZONE_HOLD_FRAMES  10u
+#define TMF8828_DUAL_OBJ_SPLIT_MM 300u
+#define TMF8828_EXPECTED_MIN_MM   50u
+#define TMF8828_EXPECTED_MAX_MM   150u
+/* Drop out-of-range updates when the previously published zone value was in-range.
+ * This suppresses near/far range toggling artifacts under close-hand occlusion.
+ */
+#ifndef TMF8828_RANGE_GLITCH_REJECT
+#define TMF8828_RANGE_GLITCH_REJECT 1u
+#endif
+/* Object selection policy for the published return when both are valid:
+ * 0: nearest valid return
+ * 1: prefer obj0; use obj1 only when obj0 is invalid
+ * 2: strict obj0 only (ignore obj1 even if obj0 invalid)
+ * The other return is kept for tmf8828_quick_read_dual.
+ */
+#ifndef TMF8828_OBJECT_SELECT_POLICY
+#define TMF8828_OBJECT_SELECT_POLICY 2u
+#endif
+
+#ifndef TMF8828_TRACE_GRIDS
+#define TMF8828_TRACE_GRIDS 0
+#endif
+
+#ifndef TMF8828_PACKET_DIAG
+#define TMF8828_PACKET_DIAG 0
+#endif
+
+#if TMF8828_PACKET_DIAG || TMF8828_TRACE_GRIDS
+#include "fsl_debug_console.h"
+#endif
+
+/* Tunable close-range linear calibration:
+ * corrected_mm = raw_mm * SCALE_Q10 / 1024 + OFFSET_MM
+ */
+#ifndef TMF8828_CLOSE_CAL_SCALE_Q10
+#define TMF8828_CLOSE_CAL_SCALE_Q10 1024
+#endif
+
+#ifndef TMF8828_CLOSE_CAL_OFFSET_MM
+#define TMF8828_CLOSE_CAL_OFFSET_MM 0
+#endif
+
+/* (capture, raw object slot) -> 8x8 grid index, folded at compile time for
+ * the selected TMF8828_ZONE_MAP_MODE and capture remap. Raw slots 8 and 17
+ * are unused in 8x8 mode and map to TMF8828_SLOT_UNUSED.
+ */
+#define TMF8828_SLOT_UNUSED 0xFFu
+
+#define TMF_CAP_REMAP(c) \
+    ((((c) == 0u) ? TMF8828_CAPTURE_REMAP_0 : \
+      ((c) == 1u) ? TMF8828_CAPTURE_REMAP_1 : \
+      ((c) == 2u) ? TMF8828_CAPTURE_REMAP_2 : TMF8828_CAPTURE_REMAP_3) & 0x3u)
+
+#if (TMF8828_ZONE_MAP_MODE == 1u)
+#define TMF_ZONE_X(cap, z) (((z) & 0x3u) + (((cap) & 0x1u) << 2u))
+#define TMF_ZONE_Y(cap, z) ((((z) >> 2u) & 0x3u) + ((((cap) >> 1u) & 0x1u) << 2u))
+#elif (TMF8828_ZONE_MAP_MODE == 2u)
+#define TMF_ZONE_X(cap, z) ((z) & 0x7u)
+#define TMF_ZONE_Y(cap, z) ((((z) >> 3u) & 0x1u) + ((cap) << 1u))
+#elif (TMF8828_ZONE_MAP_MODE == 3u)
+#define TMF_ZONE_X(cap, z) ((((z) >> 3u) & 0x1u) + ((cap) << 1u))
+#define TMF_ZONE_Y(cap, z) ((z) & 0x7u)
+#else
+/* Interleaved: 4x4 local zones, capture selects the x/y phase. */
+#define TMF_ZONE_X(cap, z) ((((z) & 0x3u) << 1u) | ((cap) & 0x1u))
+#define TMF_ZONE_Y(cap, z) (((((z) >> 2u) & 0x3u) << 1u) | (((cap) >> 1u) & 0x1u))
+#endif
+
+#define TMF_SLOT_ZONE(r) (((r) < 8u) ? (r) : ((r) - 1u))
+#define TMF_SLOT_GRID(c, r) \
+    ((((r) == 8u) || ((r) == 17u)) ? \
+         TMF8828_SLOT_UNUSED : \
+         (uint8_t)((TMF_ZONE_Y(TMF_CAP_REMAP(c), TMF_SLOT_ZONE(r)) * 8u) + \
+                   TMF_ZONE_X(TMF_CAP_REMAP(c), TMF_SLOT_ZONE(r))))
+#define TMF_SLOT_ROW(c) \
+    { \
+        TMF_SLOT_GRID(c, 0u), TMF_SLOT_GRID(c, 1u), TMF_SLOT_GRID(c, 2u), TMF_SLOT_GRID(c, 3u), \
+        TMF_SLOT_GRID(c, 4u), TMF_SLOT_GRID(c, 5u), TMF_SLOT_GRID(c, 6u), TMF_SLOT_GRID(c, 7u), \
+        TMF_SLOT_GRID(c, 8u), TMF_SLOT_GRID(c, 9u), TMF_SLOT_GRID(c, 10u), TMF_SLOT_GRID(c, 11u), \
+        TMF_SLOT_GRID(c, 12u), TMF_SLOT_GRID(c, 13u), TMF_SLOT_GRID(c, 14u), TMF_SLOT_GRID(c, 15u), \
+        TMF_SLOT_GRID(c, 16u), TMF_SLOT_GRID(c, 17u), \
+    }
+
+static const uint8_t s_slot_grid[TMF8828_CAPTURE_COUNT_8X8][TMF8828_OBJ_ENTRIES_RAW] = {
+    TMF_SLOT_ROW(0u),
+    TMF_SLOT_ROW(1u),
+    TMF_SLOT_ROW(2u),
+    TMF_SLOT_ROW(3u),
+};
+
+static uint16_t tmf_apply_close_calibration(uint16_t raw_mm)
+{
+    if (raw_mm == 0u || raw_mm > TMF8828_CLOSE_CAL_MAX_MM)
+    {
+        return raw_mm;
+    }
+
+    int32_t corrected = (int32_t)(((int32_t)raw_mm * (int32_t)TMF8828_CLOSE_CAL_SCALE_Q10 + 512) / 1024);
+    corrected += (int32_t)TMF8828_CLOSE_CAL_OFFSET_MM;
+
+    if (corrected < 0)
+    {
+        corrected = 0;
+    }
+    if (corrected > 65535)
+    {
+        corrected = 65535;
+    }
+
+    return (uint16_t)corrected;
+}
+
+static uint16_t tmf_decode_distance_mm(uint8_t b0, uint8_t b1)
+{
+    /* Some host examples/documentation encode object distance words with
+     * inconsistent byte-order descriptions. Prefer little-endian, but fall
+     * back to big-endian when LE is implausible.
+     */
+    const uint16_t raw_le = (uint16_t)b0 | ((uint16_t)b1 << 8);
+    const uint16_t raw_be = (uint16_t)b1 | ((uint16_t)b0 << 8);
+
+    const uint16_t d_le = tmf_apply_close_calibration(raw_le);
+    if (d_le > 0u && d_le < 12000u)
+    {
+        return d_le;
+    }
+
+    const uint16_t d_be = tmf_apply_close_calibration(raw_be);
+    if (d_be > 0u && d_be < 12000u)
+    {
+        return d_be;
+    }
+
+    if (d_le == 0u || d_be == 0u)
+    {
+        return 0u;
+    }
+
+    return 0u;
+}
+
+static void tmf_fill_sparse_zones(uint16_t frame[64])
+{
+    uint16_t src[64];
+    memcpy(src, frame, sizeof(src));
+
+    for (uint32_t y = 0u; y < 8u; y++)
+    {
+        for (uint32_t x = 0u; x < 8u; x++)
+        {
+            const uint32_t idx = (y * 8u) + x;
+            if (src[idx] > 0u && src[idx] < 12000u)
+            {
+                continue;
+            }
+
+            uint32_t sum = 0u;
+            uint32_t count = 0u;
+            for (int32_t dy = -1; dy <= 1; dy++)
+            {
+                for (int32_t dx = -1; dx <= 1; dx++)
+                {
+                    if (dx == 0 && dy == 0)
+                    {
+                        continue;
+                    }
+
+                    const int32_t nx = (int32_t)x + dx;
+                    const int32_t ny = (int32_t)y + dy;
+                    if (nx < 0 || nx >= 8 || ny < 0 || ny >= 8)
+                    {
+                        continue;
+                    }
+
+                    const uint16_t v = src[(uint32_t)ny * 8u + (uint32_t)nx];
+                    if (v > 0u && v < 12000u)
+                    {
+                        sum += v;
+                        count++;
+                    }
+                }
+            }
+
+            /* Corners only have 3 neighbors; allow fill when at least two are valid
+             * to avoid persistent dead corner cells under close-range occlusion.
+             */
+            if (count >= 2u)
+            {
+                frame[idx] = (uint16_t)(sum / count);
+            }
+        }
+    }
+}
+
+void tmf8828_decoder_reset(tmf8828_decoder_t *dec)
+{
+    if (dec)
+    {
+        memset(dec, 0, sizeof(*dec));
+    }
+}
+
+bool tmf8828_decode_result(tmf8828_decoder_t *dec,
+                           const uint8_t frame[TMF8828_RESULT_SIZE],
+                           uint16_t out_mm[64],
+                           uint8_t *out_conf,
+                           bool *out_complete)
+{
+    if (!dec || !frame || !out_mm || frame[0] != TMF8828_RESULT_CID)
+    {
+        return false;
+    }
+
+    const uint8_t result_number = frame[4];
+    const uint8_t capture = (uint8_t)(result_number & 0x03u);
+    const uint8_t sequence = (uint8_t)(result_number >> 2u);
+
+    if (capture >= TMF8828_CAPTURE_COUNT_8X8)
+    {
+        return false;
+    }
+
+    if (!dec->capture_sequence_valid)
+    {
+        dec->capture_sequence = sequence;
+        dec->capture_sequence_valid = true;
+        dec->capture_mask = 0u;
+        dec->sequence_updated_total = 0u;
+    }
+    else if (sequence != dec->capture_sequence)
+    {
+        /* Start a new 8x8 assembly window when sequence id changes. */
+        dec->capture_sequence = sequence;
+        dec->capture_mask = 0u;
+        dec->sequence_updated_total = 0u;
+    }
+
+    uint32_t updated_zones = 0u;
+    uint32_t zone_out = 0u;
+    uint16_t candidate_zone_mm[TMF8828_ZONE_COUNT_8X8];
+    uint8_t candidate_mode[TMF8828_ZONE_COUNT_8X8];
+    uint8_t candidate_conf[TMF8828_ZONE_COUNT_8X8];
+    uint8_t candidate_dst[TMF8828_ZONE_COUNT_8X8];
+    uint16_t candidate_alt_mm[TMF8828_ZONE_COUNT_8X8];
+    uint8_t candidate_alt_conf[TMF8828_ZONE_COUNT_8X8];
+    bool packet_any_signal = false;
+    bool suppress_empty_packet = false;
+    memset(candidate_zone_mm, 0, sizeof(candidate_zone_mm));
+    memset(candidate_mode, 0, sizeof(candidate_mode));
+    memset(candidate_conf, 0, sizeof(candidate_conf));
+    memset(candidate_alt_mm, 0, sizeof(candidate_alt_mm));
+    memset(candidate_alt_conf, 0, sizeof(candidate_alt_conf));
+#if TMF8828_PACKET_DIAG
+    uint32_t raw_slots_used = 0u;
+    uint32_t raw_slots_skipped = 0u;
+    uint32_t raw_valid_mm_samples = 0u;
+    uint16_t raw_min_mm = 0xFFFFu;
+    uint16_t raw_max_mm = 0u;
+    uint32_t conf_sum = 0u;
+    uint32_t conf_samples = 0u;
+    uint8_t conf_min = 0xFFu;
+    uint8_t conf_max = 0u;
+    uint32_t obj0_selected = 0u;
+    uint32_t obj1_selected = 0u;
+    uint32_t dual_obj_zones = 0u;
+    uint32_t dual_obj_split = 0u;
+    uint32_t range_glitch_reject = 0u;
+#endif
+
+    const uint8_t *slot_grid = s_slot_grid[capture];
+    for (uint32_t raw_idx = 0; raw_idx < TMF8828_OBJ_ENTRIES_RAW; raw_idx++)
+    {
+        const uint8_t dst = slot_grid[raw_idx];
+        if (dst >= 64u)
+        {
+#if TMF8828_PACKET_DIAG
+            raw_slots_skipped++;
+#endif
+            continue;
+        }
+
+#if TMF8828_PACKET_DIAG
+        raw_slots_used++;
+#endif
+        candidate_dst[zone_out] = dst;
+
+        const uint32_t off = TMF8828_OBJ1_OFFSET + (raw_idx * TMF8828_OBJ_ENTRY_SIZE);
+        /* Object-entry layout used by current target firmware:
+         * confidence, distance_lsb, distance_msb.
+         */
+        const uint8_t obj0_conf = frame[off + 0u];
+        const uint16_t obj0_dist_raw = (uint16_t)frame[off + 1u] | ((uint16_t)frame[off + 2u] << 8);
+        const uint8_t obj1_conf = frame[off + 3u];
+        const uint16_t obj1_dist_raw = (uint16_t)frame[off + 4u] | ((uint16_t)frame[off + 5u] << 8);
+        if (obj0_conf > 0u || obj1_conf > 0u || obj0_dist_raw > 0u || obj1_dist_raw > 0u)
+        {
+            packet_any_signal = true;
+        }
+
+        const uint16_t d0 = tmf_decode_distance_mm(frame[off + 1u], frame[off + 2u]);
+        const uint16_t d1 = tmf_decode_distance_mm(frame[off + 4u], frame[off + 5u]);
+        const bool d0_valid = (d0 > 0u && d0 < 12000u);
+        const bool d1_valid = (d1 > 0u && d1 < 12000u);
+
+#if TMF8828_PACKET_DIAG
+        conf_sum += (uint32_t)obj0_conf + (uint32_t)obj1_conf;
+        conf_samples += 2u;
+        if (obj0_conf < conf_min)
+        {
+            conf_min = obj0_conf;
+        }
+        if (obj1_conf < conf_min)
+        {
+            conf_min = obj1_conf;
+        }
+        if (obj0_conf > conf_max)
+        {
+            conf_max = obj0_conf;
+        }
+        if (obj1_conf > conf_max)
+        {
+            conf_max = obj1_conf;
+        }
+
+        if (d0_valid)
+        {
+            raw_valid_mm_samples++;
+            if (d0 < raw_min_mm)
+            {
+                raw_min_mm = d0;
+            }
+            if (d0 > raw_max_mm)
+            {
+                raw_max_mm = d0;
+            }
+        }
+        if (d1_valid)
+        {
+            raw_valid_mm_samples++;
+            if (d1 < raw_min_mm)
+            {
+                raw_min_mm = d1;
+            }
+            if (d1 > raw_max_mm)
+            {
+                raw_max_mm = d1;
+            }
+        }
+#endif
+
+        const bool obj0_ok = (d0_valid && d0 > 0u && obj0_conf >= TMF8828_MIN_CONFIDENCE);
+        const bool obj1_ok = (d1_valid && d1 > 0u && obj1_conf >= TMF8828_MIN_CONFIDENCE);
+        uint16_t chosen = 0u;
+        uint8_t chosen_obj = 0u;
+
+        if (obj0_ok && obj1_ok)
+        {
+#if TMF8828_PACKET_DIAG
+            dual_obj_zones++;
+            const uint16_t diff = (d0 > d1) ? (uint16_t)(d0 - d1) : (uint16_t)(d1 - d0);
+            if (diff >= TMF8828_DUAL_OBJ_SPLIT_MM)
+            {
+                dual_obj_split++;
+            }
+#endif
+#if (TMF8828_OBJECT_SELECT_POLICY == 0u)
+            if (d0 <= d1)
+            {
+                chosen = d0;
+                chosen_obj = 0u;
+            }
+            else
+            {
+                chosen = d1;
+                chosen_obj = 1u;
+            }
+#else
+            chosen = d0;
+            chosen_obj = 0u;
+#endif
+        }
+        else if (obj0_ok)
+        {
+            chosen = d0;
+            chosen_obj = 0u;
+        }
+#if (TMF8828_OBJECT_SELECT_POLICY != 2u)
+        else if (obj1_ok)
+        {
+            chosen = d1;
+            chosen_obj = 1u;
+        }
+#endif
+
+        /* Keep the return that was not published as the alternate. */
+        if (chosen > 0u && chosen_obj == 1u)
+        {
+            if (obj0_ok)
+            {
+                candidate_alt_mm[zone_out] = d0;
+                candidate_alt_conf[zone_out] = obj0_conf;
+            }
+        }
+        else if (obj1_ok)
+        {
+            candidate_alt_mm[zone_out] = d1;
+            candidate_alt_conf[zone_out] = obj1_conf;
+        }
+
+        if (chosen > 0u)
+        {
+            candidate_zone_mm[zone_out] = chosen;
+            candidate_mode[zone_out] = 1u;
+            candidate_conf[zone_out] = (chosen_obj == 0u) ? obj0_conf : obj1_conf;
+#if TMF8828_PACKET_DIAG
+            if (chosen_obj == 0u)
+            {
+                obj0_selected++;
+            }
+            else
+            {
+                obj1_selected++;
+            }
+#endif
+        }
+        else if (((obj0_dist_raw == 0u) && (obj0_conf > 0u)) ||
+                 ((obj1_dist_raw == 0u) && (obj1_conf > 0u)))
+        {
+            /* Close saturation often reports 0mm with non-zero confidence. */
+            candidate_zone_mm[zone_out] = TMF8828_TOO_CLOSE_MM;
+            candidate_mode[zone_out] = 1u;
+            candidate_conf[zone_out] = (obj0_dist_raw == 0u && obj0_conf > 0u) ? obj0_conf : obj1_conf;
+        }
+        else
+        {
+            candidate_mode[zone_out] = 2u;
+        }
+
+        zone_out++;
+    }
+
+    if (!packet_any_signal && dec->sequence_updated_total > 0u)
+    {
+        /* Occasionally a subcapture payload is all-zero while neighboring
+         * subcaptures in the same sequence are valid. Keep the last-good zones.
+         */
+        suppress_empty_packet = true;
+    }
+
+    uint16_t published_before[64];
+    uint64_t measured_mask = 0u;
+    memcpy(published_before, dec->last_mm, sizeof(published_before));
+
+    for (uint32_t z = 0u; z < zone_out; z++)
+    {
+        const uint32_t dst = candidate_dst[z];
+        measured_mask |= (uint64_t)1u << dst;
+
+        if (!suppress_empty_packet)
+        {
+            dec->alt_mm[dst] = candidate_alt_mm[z];
+            dec->alt_conf[dst] = candidate_alt_conf[z];
+        }
+
+        if (candidate_mode[z] == 1u)
+        {
+            uint16_t mm = candidate_zone_mm[z];
+#if TMF8828_RANGE_GLITCH_REJECT
+            const uint16_t prev = dec->last_mm[dst];
+            const bool mm_in_range = (mm >= TMF8828_EXPECTED_MIN_MM && mm <= TMF8828_EXPECTED_MAX_MM);
+            const bool prev_in_range = (prev >= TMF8828_EXPECTED_MIN_MM && prev <= TMF8828_EXPECTED_MAX_MM);
+            if (!mm_in_range && prev_in_range)
+            {
+#if TMF8828_PACKET_DIAG
+                range_glitch_reject++;
+#endif
+                continue;
+            }
+#endif
+            dec->capture_mm[capture][z] = mm;
+            dec->last_mm[dst] = mm;
+            dec->last_conf[dst] = candidate_conf[z];
+            dec->invalid_streak[dst] = 0u;
+            updated_zones++;
+        }
+        else
+        {
+            dec->capture_mm[capture][z] = 0u;
+            if (suppress_empty_packet)
+            {
+                continue;
+            }
+
+            if (dec->last_mm[dst] > 0u && dec->invalid_streak[dst] < TMF8828_ZONE_HOLD_FRAMES)
+            {
+                /* Held value: its confidence fades with every missed capture. */
+                dec->invalid_streak[dst]++;
+                dec->last_conf[dst] = (uint8_t)(dec->last_conf[dst] / 2u);
+            }
+            else
+            {
+                dec->last_mm[dst] = 0u;
+                dec->last_conf[dst] = 0u;
+                if (dec->invalid_streak[dst] < 255u)
+                {
+                    dec->invalid_streak[dst]++;
+                }
+            }
+        }
+    }
+
+    if (dec->sequence_updated_total <= (uint16_t)(0xFFFFu - updated_zones))
+    {
+        dec->sequence_updated_total = (uint16_t)(dec->sequence_updated_total + updated_zones);
+    }
+    else
+    {
+        dec->sequence_updated_total = 0xFFFFu;
+    }
+
+    dec->capture_mask |= (uint8_t)(1u << capture);
+    const uint8_t capture_mask_for_log = dec->capture_mask;
+    const bool complete_cycle = (capture_mask_for_log == 0x0Fu);
+    if (complete_cycle)
+    {
+        dec->capture_mask = 0u;
+    }
+
+#if TMF8828_PACKET_DIAG
+    uint32_t valid_before_fill = 0u;
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        if (dec->last_mm[i] > 0u && dec->last_mm[i] < 12000u)
+        {
+            valid_before_fill++;
+        }
+    }
+#endif
+
+    memcpy(out_mm, dec->last_mm, sizeof(dec->last_mm));
+    if (out_conf)
+    {
+        /* Zones filled from neighbours below had no return: confidence 0. */
+        memcpy(out_conf, dec->last_conf, sizeof(dec->last_conf));
+    }
+    if (updated_zones > 0u)
+    {
+        tmf_fill_sparse_zones(out_mm);
+        memcpy(dec->last_mm, out_mm, sizeof(dec->last_mm));
+    }
+
+    uint64_t changed_mask = 0u;
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        if (out_mm[i] != published_before[i])
+        {
+            changed_mask |= (uint64_t)1u << i;
+        }
+    }
+    dec->update.zone_mask = measured_mask;
+    dec->update.changed_mask = changed_mask;
+    dec->update.capture = capture;
+    dec->update.complete = complete_cycle;
+
+#if TMF8828_PACKET_DIAG
+    uint32_t valid_after_fill = 0u;
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        if (out_mm[i] > 0u && out_mm[i] < 12000u)
+        {
+            valid_after_fill++;
+        }
+    }
+#endif
+
+#if TMF8828_PACKET_DIAG
+    const uint16_t diag_min_mm = (raw_valid_mm_samples > 0u) ? raw_min_mm : 0u;
+    const uint16_t diag_max_mm = (raw_valid_mm_samples > 0u) ? raw_max_mm : 0u;
+    const uint8_t diag_conf_min = (conf_samples > 0u) ? conf_min : 0u;
+    const uint8_t diag_conf_max = (conf_samples > 0u) ? conf_max : 0u;
+    const uint32_t diag_conf_avg =
+        (conf_samples > 0u) ? (uint32_t)((conf_sum + (conf_samples / 2u)) / conf_samples) : 0u;
+
+    PRINTF("TOF PKT r=%u s=%u c=%u ru=%u rs=%u vp=%u va=%u d=%u-%u cf=%u-%u/%u u=%u ob=%u/%u ds=%u/%u rg=%u%s%s\r\n",
+           (unsigned)result_number,
+           (unsigned)sequence,
+           (unsigned)capture,
+           (unsigned)raw_slots_used,
+           (unsigned)raw_slots_skipped,
+           (unsigned)valid_before_fill,
+           (unsigned)valid_after_fill,
+           (unsigned)diag_min_mm,
+           (unsigned)diag_max_mm,
+           (unsigned)diag_conf_min,
+           (unsigned)diag_conf_max,
+           (unsigned)diag_conf_avg,
+           (unsigned)updated_zones,
+           (unsigned)obj0_selected,
+           (unsigned)obj1_selected,
+           (unsigned)dual_obj_split,
+           (unsigned)dual_obj_zones,
+           (unsigned)range_glitch_reject,
+           complete_cycle ? " complete" : "",
+           suppress_empty_packet ? " drop0" : "");
+#endif
+
+#if TMF8828_TRACE_GRIDS
+    uint32_t valid_zones = 0u;
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        const uint16_t v = out_mm[i];
+        if (v > 0u && v < 12000u)
+        {
+            valid_zones++;
+        }
+    }
+
+    const uint32_t captures_seen =
+        ((capture_mask_for_log & 0x1u) ? 1u : 0u) +
+        ((capture_mask_for_log & 0x2u) ? 1u : 0u) +
+        ((capture_mask_for_log & 0x4u) ? 1u : 0u) +
+        ((capture_mask_for_log & 0x8u) ? 1u : 0u);
+    const uint32_t packets_seen = captures_seen * TMF8828_ZONE_COUNT_8X8;
+
+    PRINTF("TOF DBG: seq=%u cap=%u mask=0x%01x packets=%u/64 valid=%u updated=%u%s\r\n",
+           (unsigned)sequence,
+           (unsigned)capture,
+           (unsigned)capture_mask_for_log,
+           (unsigned)packets_seen,
+           (unsigned)valid_zones,
+           (unsigned)dec->sequence_updated_total,
+           complete_cycle ? " complete" : "");
+
+#endif
+
+    if (complete_cycle)
+    {
+        dec->grid_counter++;
+        dec->sequence_updated_total = 0u;
+    }
+
+    if (out_complete)
+    {
+        *out_complete = complete_cycle;
+    }
+
+    return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tmf8828_quick.h"
+
+/* TMF8828 8x8 result-block decoder: sub-capture assembly, object selection,
+ * glitch rejection, hold and sparse fill. No bus access; all state lives in
+ * tmf8828_decoder_t, so it runs off-target as well.
+ */
+
+#define TMF8828_RESULT_SIZE       132u
+#define TMF8828_ZONE_COUNT_8X8    16u
+#define TMF8828_CAPTURE_COUNT_8X8 4u
+
+/* 8x8 capture-to-zone map modes:
+ * 0: interleaved 4x4 phases (default)
+ * 1: 4x4 quadrants
+ * 2: 8x2 row bands per capture
+ * 3: 2x8 column bands per capture
+ */
+#ifndef TMF8828_ZONE_MAP_MODE
+#define TMF8828_ZONE_MAP_MODE 1u
+#endif
+
+#ifndef TMF8828_CAPTURE_REMAP_0
+#define TMF8828_CAPTURE_REMAP_0 1u
+#endif
+#ifndef TMF8828_CAPTURE_REMAP_1
+#define TMF8828_CAPTURE_REMAP_1 3u
+#endif
+#ifndef TMF8828_CAPTURE_REMAP_2
+#define TMF8828_CAPTURE_REMAP_2 0u
+#endif
+#ifndef TMF8828_CAPTURE_REMAP_3
+#define TMF8828_CAPTURE_REMAP_3 2u
+#endif
+
+typedef struct
+{
+    uint16_t capture_mm[TMF8828_CAPTURE_COUNT_8X8][TMF8828_ZONE_COUNT_8X8];
+    uint16_t last_mm[64];   /* published grid */
+    uint8_t last_conf[64];
+    uint16_t alt_mm[64];    /* return not published, see tmf8828_dual_frame_t */
+    uint8_t alt_conf[64];
+    uint8_t invalid_streak[64];
+    uint16_t sequence_updated_total;
+    uint8_t capture_mask;
+    uint8_t capture_sequence;
+    bool capture_sequence_valid;
+    uint32_t grid_counter;
+    tmf8828_update_t update; /* timestamp_us is left to the caller */
+} tmf8828_decoder_t;
+
+void tmf8828_decoder_reset(tmf8828_decoder_t *dec);
+/* Decode one result block (one sub-capture) into the 8x8 grid. Returns false
+ * without touching dec when the block is not a measurement result.
+ */
+bool tmf8828_decode_result(tmf8828_decoder_t *dec,
+                           const uint8_t frame[TMF8828_RESULT_SIZE],
+                           uint16_t out_mm[64],
+                           uint8_t *out_conf,
+                           bool *out_complete);
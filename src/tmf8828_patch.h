@@ -458,3 +458,17 @@ static const uint8_t g_tmf8828_patch_data[TMF8828_PATCH_SIZE] = {
     0xDCu, 0x96u, 0x62u, 0xA0u, 0xBAu, 0xA9u, 0xD9u, 0xB2u, 0xAEu, 0xBBu, 0x2Bu, 0xC4u, 0x3Fu, 0xCCu, 0xE9u, 0xD3u,
     0x2Eu, 0xDBu, 0x06u, 0xE2u, 0x8Bu, 0xE8u, 0xB8u, 0xEEu, 0xA9u, 0xF4u, 0x68u, 0xFAu, 0xFFu, 0xFFu, 0x00u, 0x00u,
 };
+
+/* Byte sums (mod 256) of g_tmf8828_patch_data per bootloader chunk, so WR_RAM
+ * checksums need no pass over the payload at download time. Generated by
+ * tools/gen_tmf8828_patch_sums.c.
+ */
+#define TMF8828_PATCH_CHUNK_SIZE 128u
+#define TMF8828_PATCH_CHUNKS 57u
+
+static const uint8_t g_tmf8828_patch_chunk_sum[TMF8828_PATCH_CHUNKS] = {
+    0x1Eu, 0xDDu, 0x31u, 0x35u, 0x78u, 0x37u, 0xE2u, 0xB7u, 0xC5u, 0x5Eu, 0x47u, 0x8Du, 0x26u, 0x30u, 0x2Eu, 0xE6u,
+    0x26u, 0x2Du, 0x95u, 0x8Cu, 0x7Cu, 0x30u, 0x6Du, 0xDDu, 0x60u, 0x25u, 0xD2u, 0xB7u, 0x55u, 0xF7u, 0x72u, 0xDDu,
+    0x4Fu, 0x7Au, 0xA1u, 0xC9u, 0xA6u, 0x87u, 0x9Fu, 0x49u, 0x78u, 0x7Au, 0x25u, 0xBAu, 0x55u, 0xC8u, 0xCCu, 0x88u,
+    0xCDu, 0x32u, 0x12u, 0xB2u, 0x54u, 0x94u, 0xE0u, 0x6Eu, 0x9Au,
+};
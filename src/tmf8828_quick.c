@@ -9,6 +9,7 @@
 #include "fsl_lpi2c.h"
 #include "fsl_port.h"
 
+#include "tmf8828_decode.h"
 #include "tmf8828_patch.h"
 
 #define TMF8828_REG_APPID        0x00u
@@ -42,34 +43,9 @@
 
 #define TMF8828_INT_RESULT_READY  0x02u
 #define TMF8828_BOOT_CHUNK_SIZE   0x80u
+#define TMF8828_I2C_BAUD_HZ       400000u
+#define TMF8828_I2C_FMP_BAUD_HZ   1000000u
 
-#define TMF8828_FRAME_SIZE        132u
-#define TMF8828_OBJ1_OFFSET       24u
-#define TMF8828_OBJ_ENTRY_SIZE    6u
-#define TMF8828_OBJ_ENTRIES_RAW   18u
-#define TMF8828_ZONE_COUNT_8X8    16u
-#define TMF8828_CAPTURE_COUNT_8X8 4u
-#define TMF8828_MIN_CONFIDENCE    0u
-#define TMF8828_CLOSE_CAL_MAX_MM  120u
-#define TMF8828_TOO_CLOSE_MM      50u
-#define TMF8828_ZONE_HOLD_FRAMES  10u
-#define TMF8828_DUAL_OBJ_SPLIT_MM 300u
-#define TMF8828_EXPECTED_MIN_MM   50u
-#define TMF8828_EXPECTED_MAX_MM   150u
-/* Drop out-of-range updates when the previously published zone value was in-range.
- * This suppresses near/far range toggling artifacts under close-hand occlusion.
- */
-#ifndef TMF8828_RANGE_GLITCH_REJECT
-#define TMF8828_RANGE_GLITCH_REJECT 1u
-#endif
-/* Object selection policy when both object returns are valid:
- * 0: nearest valid return
- * 1: prefer obj0; use obj1 only when obj0 is invalid
- * 2: strict obj0 only (ignore obj1 even if obj0 invalid)
- */
-#ifndef TMF8828_OBJECT_SELECT_POLICY
-#define TMF8828_OBJECT_SELECT_POLICY 2u
-#endif
 #ifndef TMF8828_MEAS_PERIOD_MS
 #define TMF8828_MEAS_PERIOD_MS    24u
 #endif
@@ -80,35 +56,28 @@
 #define TMF8828_PERSISTENCE       0u
 #define TMF8828_ALG_SETTING0      0x84u
 
-/* 8x8 capture-to-zone map modes:
- * 0: interleaved 4x4 phases (default)
- * 1: 4x4 quadrants
- * 2: 8x2 row bands per capture
- * 3: 2x8 column bands per capture
+/* Status polls (bootloader, CPU ready, commands) start at POLL_MIN_US and
+ * double up to POLL_MAX_US, so fast responses are seen within tens of us.
  */
-#ifndef TMF8828_ZONE_MAP_MODE
-#define TMF8828_ZONE_MAP_MODE 1u
-#endif
-
-#ifndef TMF8828_CAPTURE_REMAP_0
-#define TMF8828_CAPTURE_REMAP_0 1u
-#endif
-#ifndef TMF8828_CAPTURE_REMAP_1
-#define TMF8828_CAPTURE_REMAP_1 3u
+#ifndef TMF8828_POLL_MIN_US
+#define TMF8828_POLL_MIN_US 20u
 #endif
-#ifndef TMF8828_CAPTURE_REMAP_2
-#define TMF8828_CAPTURE_REMAP_2 0u
-#endif
-#ifndef TMF8828_CAPTURE_REMAP_3
-#define TMF8828_CAPTURE_REMAP_3 2u
+#ifndef TMF8828_POLL_MAX_US
+#define TMF8828_POLL_MAX_US 1000u
 #endif
 
-#ifndef TMF8828_TRACE_GRIDS
-#define TMF8828_TRACE_GRIDS 0
+/* Switch the sensor bus to Fast-mode Plus (1 MHz) for the patch download.
+ * Needs FM+-capable pull-ups and every device on the bus to tolerate it.
+ */
+#ifndef TMF8828_BL_FAST_MODE_PLUS
+#define TMF8828_BL_FAST_MODE_PLUS 0u
 #endif
 
-#ifndef TMF8828_PACKET_DIAG
-#define TMF8828_PACKET_DIAG 0
+#if (TMF8828_PATCH_CHUNK_SIZE != TMF8828_BOOT_CHUNK_SIZE)
+#error "tmf8828_patch.h chunk sums do not match TMF8828_BOOT_CHUNK_SIZE"
+#endif
+#if (TMF8828_PATCH_CHUNKS != ((TMF8828_PATCH_SIZE + TMF8828_PATCH_CHUNK_SIZE - 1u) / TMF8828_PATCH_CHUNK_SIZE))
+#error "tmf8828_patch.h chunk sums do not cover TMF8828_PATCH_SIZE; rerun tools/gen_tmf8828_patch_sums.c"
 #endif
 
 /* TMF8828 shield EN is typically routed on Arduino D6 (P1_2 on FRDM-MCXN947). */
@@ -116,17 +85,29 @@
 #define TMF8828_EN_GPIO GPIO1
 #define TMF8828_EN_PIN  2u
 
-/* Tunable close-range linear calibration:
- * corrected_mm = raw_mm * SCALE_Q10 / 1024 + OFFSET_MM
+/* Measurement-path transfers (INT_STATUS poll, INT clear, result read) run
+ * as chained non-blocking transfers on the LPI2C interrupt handle and land in
+ * a ring of frame slots. tmf8828_quick_read_8x8 consumes a slot fetched in
+ * the background when there is one; otherwise it starts a poll and returns,
+ * and a hit chains into the result read while the caller renders, for the
+ * next call to consume. Reads never wait on the bus. Bring-up, bootloader
+ * and config traffic stays blocking. 0 restores the blocking poll + read on
+ * every call.
  */
-#ifndef TMF8828_CLOSE_CAL_SCALE_Q10
-#define TMF8828_CLOSE_CAL_SCALE_Q10 1024
+#ifndef TMF8828_ASYNC_I2C
+#define TMF8828_ASYNC_I2C 1u
 #endif
 
-#ifndef TMF8828_CLOSE_CAL_OFFSET_MM
-#define TMF8828_CLOSE_CAL_OFFSET_MM 0
+#ifndef TMF8828_FRAME_RING_SLOTS
+#define TMF8828_FRAME_RING_SLOTS 8u
 #endif
 
+#if ((TMF8828_FRAME_RING_SLOTS & (TMF8828_FRAME_RING_SLOTS - 1u)) != 0u)
+#error "TMF8828_FRAME_RING_SLOTS must be a power of two"
+#endif
+
+#define TMF8828_ASYNC_MAX_OPS 2u
+
 typedef struct
 {
     LPI2C_Type *base;
@@ -147,16 +128,62 @@ static uint8_t s_active_addr = TMF8828_I2C_ADDR;
 static bool s_sensor_ready = false;
 static tmf8828_info_t s_info;
 
-static uint16_t s_capture_mm[TMF8828_CAPTURE_COUNT_8X8][TMF8828_ZONE_COUNT_8X8];
-static uint8_t s_capture_mask = 0u;
-static uint8_t s_capture_sequence = 0u;
-static bool s_capture_sequence_valid = false;
-static uint16_t s_last_frame_mm[64];
-static uint8_t s_zone_invalid_streak[64];
-static uint16_t s_sequence_updated_total = 0u;
-static uint32_t s_grid_counter = 0u;
+static tmf8828_decoder_t s_decoder;
 static const uint8_t s_probe_addrs[] = {TMF8828_I2C_ADDR, 0x42u, 0x43u};
 
+static uint32_t s_boot_start_cycles = 0u;
+static bool s_boot_report_pending = false;
+
+static tmf8828_acq_stats_t s_acq_stats;
+static uint32_t s_acq_latency_sum_us = 0u;
+static uint32_t s_acq_read_sum_us = 0u;
+static uint8_t s_last_result_number = 0u;
+static bool s_last_result_valid = false;
+static uint32_t s_clock_cycles = 0u;
+static uint32_t s_clock_us = 0u;
+
+#if TMF8828_ASYNC_I2C
+typedef void (*tmf_async_done_t)(status_t status);
+
+typedef struct
+{
+    lpi2c_direction_t dir;
+    uint8_t reg;
+    uint8_t *data;
+    uint32_t len;
+} tmf_i2c_op_t;
+
+typedef struct
+{
+    uint32_t ready_cycles;
+    uint8_t data[TMF8828_RESULT_SIZE];
+} tmf_frame_slot_t;
+
+static lpi2c_master_handle_t s_async_handle;
+static lpi2c_master_transfer_t s_async_xfer;
+static LPI2C_Type *s_async_base = NULL;
+static tmf_i2c_op_t s_async_ops[TMF8828_ASYNC_MAX_OPS];
+static uint32_t s_async_count = 0u;
+static uint32_t s_async_next = 0u;
+static tmf_async_done_t s_async_done = NULL;
+static volatile bool s_async_busy = false;
+static volatile uint32_t s_async_submits = 0u;
+static volatile uint32_t s_async_budget_us = 0u;
+
+/* Single producer (LPI2C completion) / single consumer (main loop) ring. */
+static tmf_frame_slot_t s_ring[TMF8828_FRAME_RING_SLOTS];
+static volatile uint32_t s_ring_head = 0u;
+static volatile uint32_t s_ring_tail = 0u;
+
+static uint8_t s_acq_clear = TMF8828_INT_RESULT_READY;
+static uint8_t s_acq_int_status = 0u;
+static volatile bool s_acq_running = false;
+static volatile bool s_acq_pending = false;
+static volatile bool s_acq_bus_locked = false;
+static volatile uint32_t s_acq_ready_cycles = 0u;
+static uint32_t s_acq_slot_cycles = 0u;
+#endif
+
 static void tmf_force_i2c_clock(uint32_t flexcomm_idx)
 {
     switch (flexcomm_idx)
@@ -322,40 +349,6 @@ static bool tmf_recover_bus(uint32_t bus_idx)
     return true;
 }
 
-static uint32_t tmf_zone_index_8x8(uint32_t capture, uint32_t zone16)
-{
-    static const uint8_t cap_remap[TMF8828_CAPTURE_COUNT_8X8] = {
-        (uint8_t)(TMF8828_CAPTURE_REMAP_0 & 0x3u),
-        (uint8_t)(TMF8828_CAPTURE_REMAP_1 & 0x3u),
-        (uint8_t)(TMF8828_CAPTURE_REMAP_2 & 0x3u),
-        (uint8_t)(TMF8828_CAPTURE_REMAP_3 & 0x3u),
-    };
-
-    const uint32_t cap = cap_remap[capture & 0x3u];
-    uint32_t x = 0u;
-    uint32_t y = 0u;
-
-#if (TMF8828_ZONE_MAP_MODE == 1u)
-    x = (zone16 & 0x3u) + ((cap & 0x1u) << 2u);
-    y = ((zone16 >> 2u) & 0x3u) + (((cap >> 1u) & 0x1u) << 2u);
-#elif (TMF8828_ZONE_MAP_MODE == 2u)
-    x = zone16 & 0x7u;
-    y = ((zone16 >> 3u) & 0x1u) + (cap << 1u);
-#elif (TMF8828_ZONE_MAP_MODE == 3u)
-    x = ((zone16 >> 3u) & 0x1u) + (cap << 1u);
-    y = zone16 & 0x7u;
-#else
-    const uint32_t phase_x = cap & 0x1u;
-    const uint32_t phase_y = (cap >> 1u) & 0x1u;
-    const uint32_t local_x = zone16 & 0x3u;      /* 4 columns per subcapture */
-    const uint32_t local_y = (zone16 >> 2u) & 0x3u; /* 4 rows per subcapture */
-    x = (local_x << 1u) | phase_x;
-    y = (local_y << 1u) | phase_y;
-#endif
-
-    return (y * 8u) + x;
-}
-
 static uint32_t tmf_i2c_get_freq(uint32_t bus_idx)
 {
     return CLOCK_GetLPFlexCommClkFreq(s_buses[bus_idx].flexcomm_idx);
@@ -375,7 +368,7 @@ static bool tmf_i2c_init_bus(uint32_t bus_idx)
 
     lpi2c_master_config_t cfg;
     LPI2C_MasterGetDefaultConfig(&cfg);
-    cfg.baudRate_Hz = 400000u;
+    cfg.baudRate_Hz = TMF8828_I2C_BAUD_HZ;
 
     tmf_force_i2c_clock(s_buses[bus_idx].flexcomm_idx);
 
@@ -391,6 +384,13 @@ static bool tmf_i2c_init_bus(uint32_t bus_idx)
     return true;
 }
 
+#if TMF8828_BL_FAST_MODE_PLUS
+static void tmf_i2c_set_baud(uint32_t baud_hz)
+{
+    LPI2C_MasterSetBaudRate(s_buses[s_active_bus].base, tmf_i2c_get_freq((uint32_t)s_active_bus), baud_hz);
+}
+#endif
+
 static bool tmf_i2c_write_on_bus_addr(uint32_t bus_idx, uint8_t addr, uint8_t reg, const uint8_t *data, uint32_t len)
 {
     lpi2c_master_transfer_t xfer;
@@ -461,6 +461,135 @@ static bool tmf_rd8(uint8_t reg, uint8_t *v)
     return tmf_i2c_read(reg, v, 1u);
 }
 
+#if TMF8828_ASYNC_I2C
+static status_t tmf_i2c_async_start_op(const tmf_i2c_op_t *op)
+{
+    memset(&s_async_xfer, 0, sizeof(s_async_xfer));
+    s_async_xfer.slaveAddress = s_active_addr;
+    s_async_xfer.direction = op->dir;
+    s_async_xfer.subaddress = op->reg;
+    s_async_xfer.subaddressSize = 1u;
+    s_async_xfer.data = op->data;
+    s_async_xfer.dataSize = op->len;
+    s_async_xfer.flags = kLPI2C_TransferDefaultFlag;
+    return LPI2C_MasterTransferNonBlocking(s_async_base, &s_async_handle, &s_async_xfer);
+}
+
+/* LPI2C completion: start the next op of the chain, or report the chain done
+ * (successfully or at its first failure).
+ */
+static void tmf_i2c_async_transfer_cb(LPI2C_Type *base, lpi2c_master_handle_t *handle, status_t status, void *user_data)
+{
+    (void)base;
+    (void)handle;
+    (void)user_data;
+
+    if ((status == kStatus_Success) && (s_async_next < s_async_count))
+    {
+        status = tmf_i2c_async_start_op(&s_async_ops[s_async_next++]);
+        if (status == kStatus_Success)
+        {
+            return;
+        }
+    }
+
+    const tmf_async_done_t done = s_async_done;
+    s_async_busy = false;
+    if (done)
+    {
+        done(status);
+    }
+}
+
+static void tmf_i2c_async_open(void)
+{
+    s_async_base = s_buses[s_active_bus].base;
+    s_async_busy = false;
+    LPI2C_MasterTransferCreateHandle(s_async_base, &s_async_handle, tmf_i2c_async_transfer_cb, NULL);
+}
+
+/* Upper bound for one chain on the bus: every op is address, register,
+ * repeated-start address and its data at 9 clocks per byte, doubled for clock
+ * stretching and interrupt latency, plus a fixed 500 us.
+ */
+static uint32_t tmf_i2c_async_budget_us(const tmf_i2c_op_t *ops, uint32_t count)
+{
+    uint32_t bytes = 0u;
+    for (uint32_t i = 0u; i < count; i++)
+    {
+        bytes += 3u + ops[i].len;
+    }
+    const uint32_t bus_us = (uint32_t)(((uint64_t)bytes * 9u * 1000000u) / TMF8828_I2C_BAUD_HZ);
+    return (2u * bus_us) + 500u;
+}
+
+/* Queue up to TMF8828_ASYNC_MAX_OPS register transfers to run back to back;
+ * done runs from the LPI2C interrupt. Call from interrupt context or with
+ * interrupts masked.
+ */
+static bool tmf_i2c_async_submit(const tmf_i2c_op_t *ops, uint32_t count, tmf_async_done_t done)
+{
+    if (!s_async_base || s_async_busy || count == 0u || count > TMF8828_ASYNC_MAX_OPS)
+    {
+        return false;
+    }
+
+    memcpy(s_async_ops, ops, count * sizeof(ops[0]));
+    s_async_count = count;
+    s_async_next = 1u;
+    s_async_done = done;
+    s_async_budget_us = tmf_i2c_async_budget_us(ops, count);
+    s_async_submits++;
+    s_async_busy = true;
+    if (tmf_i2c_async_start_op(&s_async_ops[0]) != kStatus_Success)
+    {
+        s_async_busy = false;
+        return false;
+    }
+    return true;
+}
+
+/* Wait until the bus is idle, including chains a completion submits from the
+ * LPI2C interrupt (an INT_STATUS hit chaining into the result read). Each
+ * chain gets its own budget; returns false if one overran it.
+ */
+static bool tmf_i2c_async_wait_idle(void)
+{
+    uint32_t submits = s_async_submits;
+    uint32_t waited_us = 0u;
+    while (s_async_busy)
+    {
+        if (s_async_submits != submits)
+        {
+            submits = s_async_submits;
+            waited_us = 0u;
+        }
+        if (waited_us >= s_async_budget_us)
+        {
+            return false;
+        }
+        SDK_DelayAtLeastUs(10u, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
+        waited_us += 10u;
+    }
+    return true;
+}
+
+static void tmf_i2c_async_close(void)
+{
+    if (!s_async_base)
+    {
+        return;
+    }
+
+    if (!tmf_i2c_async_wait_idle())
+    {
+        LPI2C_MasterTransferAbort(s_async_base, &s_async_handle);
+        s_async_busy = false;
+    }
+    s_async_base = NULL;
+}
+#endif
+
 static bool tmf_probe_bus(uint32_t bus_idx, uint8_t addr, uint8_t *chip_id, uint8_t *rev_id)
 {
     uint8_t id = 0u;
@@ -563,9 +692,58 @@ static bool tmf_select_bus(uint8_t *chip_id, uint8_t *rev_id)
     return false;
 }
 
+static void tmf_cycle_counter_init(void)
+{
+#if defined(DCB)
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+#else
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#endif
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static uint32_t tmf_cycles_now(void)
+{
+    return DWT->CYCCNT;
+}
+
+static uint32_t tmf_cycles_to_us(uint32_t cycles)
+{
+    const uint32_t per_us = SystemCoreClock / 1000000u;
+    return (per_us > 0u) ? (cycles / per_us) : 0u;
+}
+
+/* Microsecond clock extended from the cycle counter. Stays exact as long as
+ * it is sampled at least once per counter wrap.
+ */
+static uint32_t tmf_clock_us(uint32_t cycles)
+{
+    const uint32_t per_us = SystemCoreClock / 1000000u;
+    const uint32_t elapsed = cycles - s_clock_cycles;
+    if (per_us > 0u && elapsed < 0x80000000u)
+    {
+        const uint32_t us = elapsed / per_us;
+        s_clock_us += us;
+        s_clock_cycles += us * per_us;
+    }
+    return s_clock_us;
+}
+
+/* Sleep for the current poll delay, add it to *waited_us and double the
+ * delay for the next poll.
+ */
+static void tmf_poll_backoff(uint32_t *delay_us, uint32_t *waited_us)
+{
+    SDK_DelayAtLeastUs(*delay_us, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
+    *waited_us += *delay_us;
+    *delay_us = ((*delay_us * 2u) > TMF8828_POLL_MAX_US) ? TMF8828_POLL_MAX_US : (*delay_us * 2u);
+}
+
 static bool tmf_wait_cpu_ready(void)
 {
-    for (uint32_t i = 0; i < 80u; i++)
+    uint32_t delay_us = TMF8828_POLL_MIN_US;
+    uint32_t waited_us = 0u;
+    for (;;)
     {
         uint8_t en = 0u;
         if (!tmf_rd8(TMF8828_REG_ENABLE, &en))
@@ -576,9 +754,12 @@ static bool tmf_wait_cpu_ready(void)
         {
             return true;
         }
-        SDK_DelayAtLeastUs(2000u, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
+        if (waited_us >= 160000u)
+        {
+            return false;
+        }
+        tmf_poll_backoff(&delay_us, &waited_us);
     }
-    return false;
 }
 
 static uint8_t tmf_bl_checksum(const uint8_t *data, uint32_t len)
@@ -595,9 +776,10 @@ static bool tmf_bl_wait_response(uint8_t cmd, uint8_t *payload_out, uint8_t payl
 {
     uint8_t rx[3u + TMF8828_BOOT_CHUNK_SIZE];
     const uint32_t rx_len = (uint32_t)payload_len + 3u;
-    const uint32_t polls = (timeout_us / 1000u) + 1u;
+    uint32_t delay_us = TMF8828_POLL_MIN_US;
+    uint32_t waited_us = 0u;
 
-    for (uint32_t i = 0; i < polls; i++)
+    for (;;)
     {
         if (!tmf_i2c_read(TMF8828_REG_CMD_STAT, rx, rx_len))
         {
@@ -606,7 +788,11 @@ static bool tmf_bl_wait_response(uint8_t cmd, uint8_t *payload_out, uint8_t payl
 
         if (rx[0] == cmd)
         {
-            SDK_DelayAtLeastUs(1000u, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
+            if (waited_us > timeout_us)
+            {
+                break;
+            }
+            tmf_poll_backoff(&delay_us, &waited_us);
             continue;
         }
 
@@ -655,6 +841,22 @@ static bool tmf_bl_send_cmd(uint8_t cmd, const uint8_t *payload, uint8_t payload
     return tmf_bl_wait_response(cmd, NULL, 0u, 30000u);
 }
 
+/* Frame WR_RAM for one patch chunk; the checksum comes from the build-time
+ * chunk sum. Returns the frame length.
+ */
+static uint32_t tmf_bl_build_chunk(uint8_t *tx, uint32_t chunk_idx)
+{
+    const uint32_t off = chunk_idx * TMF8828_BOOT_CHUNK_SIZE;
+    const uint32_t len = ((TMF8828_PATCH_SIZE - off) > TMF8828_BOOT_CHUNK_SIZE) ? TMF8828_BOOT_CHUNK_SIZE :
+                                                                               (TMF8828_PATCH_SIZE - off);
+    tx[0] = TMF8828_BL_CMD_WR_RAM;
+    tx[1] = (uint8_t)len;
+    memcpy(&tx[2], &g_tmf8828_patch_data[off], len);
+    tx[2u + len] =
+        (uint8_t)(0xFFu ^ ((TMF8828_BL_CMD_WR_RAM + len + g_tmf8828_patch_chunk_sum[chunk_idx]) & 0xFFu));
+    return len + 3u;
+}
+
 static bool tmf_bootloader_download_patch(void)
 {
     const uint8_t addr_payload[2] = {
@@ -668,14 +870,15 @@ static bool tmf_bootloader_download_patch(void)
         return false;
     }
 
-    for (uint32_t off = 0u; off < TMF8828_PATCH_SIZE; off += TMF8828_BOOT_CHUNK_SIZE)
+    uint8_t tx[3u + TMF8828_BOOT_CHUNK_SIZE];
+    for (uint32_t i = 0u; i < TMF8828_PATCH_CHUNKS; i++)
     {
-        uint8_t chunk = (uint8_t)((TMF8828_PATCH_SIZE - off) > TMF8828_BOOT_CHUNK_SIZE ?
-                                  TMF8828_BOOT_CHUNK_SIZE :
-                                  (TMF8828_PATCH_SIZE - off));
-        if (!tmf_bl_send_cmd(TMF8828_BL_CMD_WR_RAM, &g_tmf8828_patch_data[off], chunk))
+        const uint32_t tx_len = tmf_bl_build_chunk(tx, i);
+        if (!tmf_i2c_write(TMF8828_REG_CMD_STAT, tx, tx_len) ||
+            !tmf_bl_wait_response(TMF8828_BL_CMD_WR_RAM, NULL, 0u, 30000u))
         {
-            PRINTF("TOF: BL patch chunk write failed at %lu\r\n", (unsigned long)off);
+            PRINTF("TOF: BL patch chunk write failed at %lu\r\n",
+                   (unsigned long)(i * TMF8828_BOOT_CHUNK_SIZE));
             return false;
         }
     }
@@ -695,17 +898,21 @@ static bool tmf_bootloader_start_ram_app(void)
         return false;
     }
 
-    for (uint32_t i = 0; i < 120u; i++)
+    uint32_t delay_us = TMF8828_POLL_MIN_US;
+    uint32_t waited_us = 0u;
+    for (;;)
     {
         uint8_t appid = 0u;
         if (tmf_rd8(TMF8828_REG_APPID, &appid) && appid == TMF8828_APP_ID_APP)
         {
             return true;
         }
-        SDK_DelayAtLeastUs(2000u, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
+        if (waited_us >= 240000u)
+        {
+            return false;
+        }
+        tmf_poll_backoff(&delay_us, &waited_us);
     }
-
-    return false;
 }
 
 static bool tmf_send_cmd_expect(uint8_t cmd, uint8_t expected, uint32_t timeout_us)
@@ -715,8 +922,9 @@ static bool tmf_send_cmd_expect(uint8_t cmd, uint8_t expected, uint32_t timeout_
         return false;
     }
 
-    const uint32_t polls = (timeout_us / 1000u) + 1u;
-    for (uint32_t i = 0; i < polls; i++)
+    uint32_t delay_us = TMF8828_POLL_MIN_US;
+    uint32_t waited_us = 0u;
+    for (;;)
     {
         uint8_t st = 0u;
         if (!tmf_rd8(TMF8828_REG_CMD_STAT, &st))
@@ -742,7 +950,11 @@ static bool tmf_send_cmd_expect(uint8_t cmd, uint8_t expected, uint32_t timeout_
             return false;
         }
 
-        SDK_DelayAtLeastUs(1000u, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
+        if (waited_us > timeout_us)
+        {
+            break;
+        }
+        tmf_poll_backoff(&delay_us, &waited_us);
     }
 
     PRINTF("TOF: command 0x%02x timeout\r\n", cmd);
@@ -862,135 +1074,210 @@ static bool tmf_enable_short_range_mode(void)
     return true;
 }
 
-static uint16_t tmf_apply_close_calibration(uint16_t raw_mm)
+static bool tmf_start_measurement(void)
 {
-    if (raw_mm == 0u || raw_mm > TMF8828_CLOSE_CAL_MAX_MM)
+    if (!tmf_wr8(TMF8828_REG_INT_STATUS, TMF8828_INT_RESULT_READY))
     {
-        return raw_mm;
+        return false;
     }
-
-    int32_t corrected = (int32_t)(((int32_t)raw_mm * (int32_t)TMF8828_CLOSE_CAL_SCALE_Q10 + 512) / 1024);
-    corrected += (int32_t)TMF8828_CLOSE_CAL_OFFSET_MM;
-
-    if (corrected < 0)
+    if (!tmf_wr8(TMF8828_REG_INT_ENAB, TMF8828_INT_RESULT_READY))
     {
-        corrected = 0;
+        return false;
     }
-    if (corrected > 65535)
+    return tmf_send_cmd_expect(TMF8828_CMD_MEASURE, 1u, 30000u);
+}
+
+/* Bookkeeping for every decoded result: ready-to-consume latency and, once
+ * per init, the boot-to-first-frame time.
+ */
+static void tmf_note_consumed(uint32_t ready_cycles)
+{
+    const uint32_t now = tmf_cycles_now();
+    if (s_boot_report_pending)
     {
-        corrected = 65535;
+        s_boot_report_pending = false;
+        s_info.boot_to_first_frame_us = tmf_cycles_to_us(now - s_boot_start_cycles);
+        PRINTF("TOF: boot to first frame %lu us (patch %lu us)\r\n",
+               (unsigned long)s_info.boot_to_first_frame_us,
+               (unsigned long)s_info.patch_load_us);
     }
 
-    return (uint16_t)corrected;
+    const uint32_t us = tmf_cycles_to_us(now - ready_cycles);
+    s_decoder.update.timestamp_us = tmf_clock_us(ready_cycles);
+    s_acq_stats.results++;
+    s_acq_latency_sum_us += us;
+    if (us > s_acq_stats.latency_max_us)
+    {
+        s_acq_stats.latency_max_us = us;
+    }
 }
 
-static uint16_t tmf_decode_distance_mm(uint8_t b0, uint8_t b1)
+static void tmf_note_result_number(uint8_t result_number)
 {
-    /* Some host examples/documentation encode object distance words with
-     * inconsistent byte-order descriptions. Prefer little-endian, but fall
-     * back to big-endian when LE is implausible.
+    /* RESULT_NUMBER advances on every sub-capture, so a jump means the sensor
+     * overwrote results that were never read. Repeats and backward steps
+     * (restart) are not counted.
      */
-    const uint16_t raw_le = (uint16_t)b0 | ((uint16_t)b1 << 8);
-    const uint16_t raw_be = (uint16_t)b1 | ((uint16_t)b0 << 8);
-
-    const uint16_t d_le = tmf_apply_close_calibration(raw_le);
-    if (d_le > 0u && d_le < 12000u)
+    if (s_last_result_valid)
     {
-        return d_le;
+        const uint8_t gap = (uint8_t)(result_number - s_last_result_number - 1u);
+        if (gap < 0x80u)
+        {
+            s_acq_stats.dropped_captures += gap;
+        }
     }
+    s_last_result_number = result_number;
+    s_last_result_valid = true;
+}
+
+#if TMF8828_ASYNC_I2C
+static void tmf_acq_kick(void);
 
-    const uint16_t d_be = tmf_apply_close_calibration(raw_be);
-    if (d_be > 0u && d_be < 12000u)
+static void tmf_acq_fetch_done(status_t status)
+{
+    if (status == kStatus_Success)
     {
-        return d_be;
+        const uint32_t head = s_ring_head;
+        s_ring[head & (TMF8828_FRAME_RING_SLOTS - 1u)].ready_cycles = s_acq_slot_cycles;
+        s_ring_head = head + 1u;
     }
-
-    if (d_le == 0u || d_be == 0u)
+    else
     {
-        return 0u;
+        s_acq_stats.i2c_errors++;
     }
-
-    return 0u;
+    tmf_acq_kick();
 }
 
-static void tmf_fill_sparse_zones(uint16_t frame[64])
+static void tmf_acq_clear_done(status_t status)
 {
-    uint16_t src[64];
-    memcpy(src, frame, sizeof(src));
+    if (status != kStatus_Success)
+    {
+        s_acq_stats.i2c_errors++;
+    }
+    tmf_acq_kick();
+}
 
-    for (uint32_t y = 0u; y < 8u; y++)
+/* Clear INT and read the result block when one is pending and the bus is
+ * free. Runs in interrupt context or with interrupts masked.
+ */
+static void tmf_acq_kick(void)
+{
+    if (!s_acq_running || !s_acq_pending || s_acq_bus_locked || s_async_busy)
     {
-        for (uint32_t x = 0u; x < 8u; x++)
-        {
-            const uint32_t idx = (y * 8u) + x;
-            if (src[idx] > 0u && src[idx] < 12000u)
-            {
-                continue;
-            }
+        return;
+    }
 
-            uint32_t sum = 0u;
-            uint32_t count = 0u;
-            for (int32_t dy = -1; dy <= 1; dy++)
-            {
-                for (int32_t dx = -1; dx <= 1; dx++)
-                {
-                    if (dx == 0 && dy == 0)
-                    {
-                        continue;
-                    }
-
-                    const int32_t nx = (int32_t)x + dx;
-                    const int32_t ny = (int32_t)y + dy;
-                    if (nx < 0 || nx >= 8 || ny < 0 || ny >= 8)
-                    {
-                        continue;
-                    }
-
-                    const uint16_t v = src[(uint32_t)ny * 8u + (uint32_t)nx];
-                    if (v > 0u && v < 12000u)
-                    {
-                        sum += v;
-                        count++;
-                    }
-                }
-            }
+    s_acq_pending = false;
+    s_acq_slot_cycles = s_acq_ready_cycles;
 
-            /* Corners only have 3 neighbors; allow fill when at least two are valid
-             * to avoid persistent dead corner cells under close-range occlusion.
-             */
-            if (count >= 2u)
-            {
-                frame[idx] = (uint16_t)(sum / count);
-            }
-        }
+    const uint32_t head = s_ring_head;
+    const tmf_i2c_op_t ops[2] = {
+        {kLPI2C_Write, TMF8828_REG_INT_STATUS, &s_acq_clear, 1u},
+        {kLPI2C_Read, TMF8828_REG_CONFIG_RES, s_ring[head & (TMF8828_FRAME_RING_SLOTS - 1u)].data, TMF8828_RESULT_SIZE},
+    };
+    bool ok = false;
+    if ((head - s_ring_tail) >= TMF8828_FRAME_RING_SLOTS)
+    {
+        /* No free slot: re-arm INT and leave the result unread; it shows up
+         * as a result-number gap.
+         */
+        s_acq_stats.ring_full++;
+        ok = tmf_i2c_async_submit(ops, 1u, tmf_acq_clear_done);
+    }
+    else
+    {
+        ok = tmf_i2c_async_submit(ops, 2u, tmf_acq_fetch_done);
+    }
+    if (!ok)
+    {
+        s_acq_stats.i2c_errors++;
     }
 }
 
-static bool tmf_start_measurement(void)
+static void tmf_acq_poll_done(status_t status)
 {
-    if (!tmf_wr8(TMF8828_REG_INT_STATUS, TMF8828_INT_RESULT_READY))
+    if (status != kStatus_Success)
     {
-        return false;
+        s_acq_stats.i2c_errors++;
     }
-    if (!tmf_wr8(TMF8828_REG_INT_ENAB, TMF8828_INT_RESULT_READY))
+    else if ((s_acq_int_status & TMF8828_INT_RESULT_READY) != 0u)
     {
-        return false;
+        s_acq_ready_cycles = tmf_cycles_now();
+        s_acq_pending = true;
+        tmf_acq_kick();
     }
-    return tmf_send_cmd_expect(TMF8828_CMD_MEASURE, 1u, 30000u);
+    else
+    {
+        s_acq_stats.wasted_polls++;
+    }
+}
+
+/* Start a background INT_STATUS read; a hit chains straight into the clear +
+ * result read, so the frame is waiting by the next consume.
+ */
+static void tmf_acq_service(void)
+{
+    if (!s_acq_running || s_async_busy || s_acq_bus_locked)
+    {
+        return;
+    }
+
+    const tmf_i2c_op_t op = {kLPI2C_Read, TMF8828_REG_INT_STATUS, &s_acq_int_status, 1u};
+    const uint32_t primask = DisableGlobalIRQ();
+    if (!s_async_busy && !s_acq_pending && !tmf_i2c_async_submit(&op, 1u, tmf_acq_poll_done))
+    {
+        s_acq_stats.i2c_errors++;
+    }
+    EnableGlobalIRQ(primask);
+}
+
+static void tmf_acq_stop(void)
+{
+    if (!s_acq_running)
+    {
+        return;
+    }
+
+    s_acq_running = false;
+    tmf_i2c_async_close();
+    s_acq_pending = false;
+}
+
+static void tmf_acq_start(void)
+{
+    s_ring_head = 0u;
+    s_ring_tail = 0u;
+    s_acq_pending = false;
+    tmf_i2c_async_open();
+
+    s_acq_running = true;
+    tmf_acq_service();
+}
+#else
+static void tmf_acq_stop(void)
+{
+}
+
+static void tmf_acq_start(void)
+{
+}
+#endif
+
+/* Forget partially assembled 8x8 frames and the result-number history. */
+static void tmf_reset_capture_state(void)
+{
+    tmf8828_decoder_reset(&s_decoder);
+    s_last_result_valid = false;
 }
 
 bool tmf8828_quick_init(void)
 {
+    tmf_acq_stop();
+    tmf_cycle_counter_init();
+    s_boot_start_cycles = tmf_cycles_now();
+    s_boot_report_pending = false;
     memset(&s_info, 0, sizeof(s_info));
-    memset(s_capture_mm, 0, sizeof(s_capture_mm));
-    memset(s_last_frame_mm, 0, sizeof(s_last_frame_mm));
-    memset(s_zone_invalid_streak, 0, sizeof(s_zone_invalid_streak));
-    s_capture_mask = 0u;
-    s_capture_sequence = 0u;
-    s_capture_sequence_valid = false;
-    s_sequence_updated_total = 0u;
-    s_sequence_updated_total = 0u;
-    s_grid_counter = 0u;
+    tmf_reset_capture_state();
     s_sensor_ready = false;
     s_active_bus = -1;
     s_active_addr = TMF8828_I2C_ADDR;
@@ -1038,11 +1325,20 @@ bool tmf8828_quick_init(void)
                s_buses[s_active_bus].name,
                (unsigned)TMF8828_PATCH_SIZE);
 
-        if (!tmf_bootloader_download_patch() || !tmf_bootloader_start_ram_app())
+        const uint32_t patch_start = tmf_cycles_now();
+#if TMF8828_BL_FAST_MODE_PLUS
+        tmf_i2c_set_baud(TMF8828_I2C_FMP_BAUD_HZ);
+#endif
+        const bool patched = tmf_bootloader_download_patch();
+#if TMF8828_BL_FAST_MODE_PLUS
+        tmf_i2c_set_baud(TMF8828_I2C_BAUD_HZ);
+#endif
+        if (!patched || !tmf_bootloader_start_ram_app())
         {
             PRINTF("TOF: patch download/start failed\r\n");
             return false;
         }
+        s_info.patch_load_us = tmf_cycles_to_us(tmf_cycles_now() - patch_start);
 
         if (!tmf_rd8(TMF8828_REG_APPID, &appid))
         {
@@ -1086,6 +1382,8 @@ bool tmf8828_quick_init(void)
     }
 
     s_sensor_ready = true;
+    s_boot_report_pending = true;
+    tmf_acq_start();
     PRINTF("TOF: TMF8828 chip=0x%02x rev=%u ready on %s @0x%02x (8x8 mode)\r\n",
            s_info.chip_id,
            s_info.rev_id,
@@ -1111,7 +1409,21 @@ bool tmf8828_quick_get_info(tmf8828_info_t *out)
     return s_info.present;
 }
 
-bool tmf8828_quick_read_8x8(uint16_t out_mm[64], bool *out_complete)
+/* Decode one result block and account for its RESULT_NUMBER. */
+static bool tmf_process_result(const uint8_t frame[TMF8828_RESULT_SIZE],
+                               uint16_t out_mm[64],
+                               uint8_t *out_conf,
+                               bool *out_complete)
+{
+    const bool ok = tmf8828_decode_result(&s_decoder, frame, out_mm, out_conf, out_complete);
+    if (ok)
+    {
+        tmf_note_result_number(frame[4]);
+    }
+    return ok;
+}
+
+static bool tmf_read_result_now(uint16_t out_mm[64], uint8_t *out_conf, bool *out_complete)
 {
     if (out_complete)
     {
@@ -1123,6 +1435,28 @@ bool tmf8828_quick_read_8x8(uint16_t out_mm[64], bool *out_complete)
         return false;
     }
 
+#if TMF8828_ASYNC_I2C
+    const uint32_t tail = s_ring_tail;
+    if (tail == s_ring_head)
+    {
+        /* Nothing fetched yet: start a poll and leave it in flight. A hit
+         * chains into the result read in the background and the next call
+         * consumes it.
+         */
+        tmf_acq_service();
+        return false;
+    }
+
+    const tmf_frame_slot_t *slot = &s_ring[tail & (TMF8828_FRAME_RING_SLOTS - 1u)];
+    const bool ok = tmf_process_result(slot->data, out_mm, out_conf, out_complete);
+    if (ok)
+    {
+        tmf_note_consumed(slot->ready_cycles);
+    }
+    s_ring_tail = tail + 1u;
+    tmf_acq_service();
+    return ok;
+#else
     uint8_t int_status = 0u;
     if (!tmf_rd8(TMF8828_REG_INT_STATUS, &int_status))
     {
@@ -1131,433 +1465,201 @@ bool tmf8828_quick_read_8x8(uint16_t out_mm[64], bool *out_complete)
 
     if ((int_status & TMF8828_INT_RESULT_READY) == 0u)
     {
+        s_acq_stats.wasted_polls++;
         return false;
     }
 
+    const uint32_t ready_cycles = tmf_cycles_now();
     (void)tmf_wr8(TMF8828_REG_INT_STATUS, TMF8828_INT_RESULT_READY);
 
-    uint8_t frame[TMF8828_FRAME_SIZE];
+    uint8_t frame[TMF8828_RESULT_SIZE];
     if (!tmf_i2c_read(TMF8828_REG_CONFIG_RES, frame, sizeof(frame)))
     {
         return false;
     }
 
-    if (frame[0] != TMF8828_CMD_MEASURE)
+    const bool ok = tmf_process_result(frame, out_mm, out_conf, out_complete);
+    if (ok)
     {
-        return false;
+        tmf_note_consumed(ready_cycles);
     }
+    return ok;
+#endif
+}
 
-    const uint8_t result_number = frame[4];
-    const uint8_t capture = (uint8_t)(result_number & 0x03u);
-    const uint8_t sequence = (uint8_t)(result_number >> 2u);
+/* Times each read as seen by the render loop; with TMF8828_ASYNC_I2C this
+ * is decode and slot bookkeeping only, never a bus wait.
+ */
+static bool tmf_read_result(uint16_t out_mm[64], uint8_t *out_conf, bool *out_complete)
+{
+    const uint32_t start = tmf_cycles_now();
+    const bool ok = tmf_read_result_now(out_mm, out_conf, out_complete);
+    const uint32_t us = tmf_cycles_to_us(tmf_cycles_now() - start);
 
-    if (capture >= TMF8828_CAPTURE_COUNT_8X8)
+    const uint32_t primask = DisableGlobalIRQ();
+    s_acq_stats.reads++;
+    s_acq_read_sum_us += us;
+    if (us > s_acq_stats.read_max_us)
     {
-        return false;
+        s_acq_stats.read_max_us = us;
     }
+    EnableGlobalIRQ(primask);
+    return ok;
+}
 
-    if (!s_capture_sequence_valid)
-    {
-        s_capture_sequence = sequence;
-        s_capture_sequence_valid = true;
-        s_capture_mask = 0u;
-        s_sequence_updated_total = 0u;
-    }
-    else if (sequence != s_capture_sequence)
-    {
-        /* Start a new 8x8 assembly window when sequence id changes. */
-        s_capture_sequence = sequence;
-        s_capture_mask = 0u;
-        s_sequence_updated_total = 0u;
-    }
-
-    uint32_t updated_zones = 0u;
-    uint32_t zone_out = 0u;
-    uint16_t candidate_zone_mm[TMF8828_ZONE_COUNT_8X8];
-    uint8_t candidate_mode[TMF8828_ZONE_COUNT_8X8];
-    bool packet_any_signal = false;
-    bool suppress_empty_packet = false;
-    memset(candidate_zone_mm, 0, sizeof(candidate_zone_mm));
-    memset(candidate_mode, 0, sizeof(candidate_mode));
-#if TMF8828_PACKET_DIAG
-    uint32_t raw_slots_used = 0u;
-    uint32_t raw_slots_skipped = 0u;
-    uint32_t raw_valid_mm_samples = 0u;
-    uint16_t raw_min_mm = 0xFFFFu;
-    uint16_t raw_max_mm = 0u;
-    uint32_t conf_sum = 0u;
-    uint32_t conf_samples = 0u;
-    uint8_t conf_min = 0xFFu;
-    uint8_t conf_max = 0u;
-    uint32_t obj0_selected = 0u;
-    uint32_t obj1_selected = 0u;
-    uint32_t dual_obj_zones = 0u;
-    uint32_t dual_obj_split = 0u;
-    uint32_t range_glitch_reject = 0u;
-#endif
+bool tmf8828_quick_read_8x8(uint16_t out_mm[64], bool *out_complete)
+{
+    return tmf_read_result(out_mm, NULL, out_complete);
+}
 
-    for (uint32_t raw_idx = 0; raw_idx < TMF8828_OBJ_ENTRIES_RAW; raw_idx++)
+bool tmf8828_quick_read_frame(tmf8828_frame_t *out, bool *out_complete)
+{
+    if (!out)
     {
-        /* In TMF8828 8x8 mode, raw object slots 8 and 17 are unused. */
-        if (raw_idx == 8u || raw_idx == 17u)
-        {
-#if TMF8828_PACKET_DIAG
-            raw_slots_skipped++;
-#endif
-            continue;
-        }
-
-        if (zone_out >= TMF8828_ZONE_COUNT_8X8)
-        {
-            break;
-        }
-
-#if TMF8828_PACKET_DIAG
-        raw_slots_used++;
-#endif
-
-        const uint32_t off = TMF8828_OBJ1_OFFSET + (raw_idx * TMF8828_OBJ_ENTRY_SIZE);
-        /* Object-entry layout used by current target firmware:
-         * confidence, distance_lsb, distance_msb.
-         */
-        const uint8_t obj0_conf = frame[off + 0u];
-        const uint16_t obj0_dist_raw = (uint16_t)frame[off + 1u] | ((uint16_t)frame[off + 2u] << 8);
-        const uint8_t obj1_conf = frame[off + 3u];
-        const uint16_t obj1_dist_raw = (uint16_t)frame[off + 4u] | ((uint16_t)frame[off + 5u] << 8);
-        if (obj0_conf > 0u || obj1_conf > 0u || obj0_dist_raw > 0u || obj1_dist_raw > 0u)
-        {
-            packet_any_signal = true;
-        }
-
-        const uint16_t d0 = tmf_decode_distance_mm(frame[off + 1u], frame[off + 2u]);
-        const uint16_t d1 = tmf_decode_distance_mm(frame[off + 4u], frame[off + 5u]);
-        const bool d0_valid = (d0 > 0u && d0 < 12000u);
-        const bool d1_valid = (d1 > 0u && d1 < 12000u);
-
-#if TMF8828_PACKET_DIAG
-        conf_sum += (uint32_t)obj0_conf + (uint32_t)obj1_conf;
-        conf_samples += 2u;
-        if (obj0_conf < conf_min)
-        {
-            conf_min = obj0_conf;
-        }
-        if (obj1_conf < conf_min)
-        {
-            conf_min = obj1_conf;
-        }
-        if (obj0_conf > conf_max)
-        {
-            conf_max = obj0_conf;
-        }
-        if (obj1_conf > conf_max)
-        {
-            conf_max = obj1_conf;
-        }
-
-        if (d0_valid)
-        {
-            raw_valid_mm_samples++;
-            if (d0 < raw_min_mm)
-            {
-                raw_min_mm = d0;
-            }
-            if (d0 > raw_max_mm)
-            {
-                raw_max_mm = d0;
-            }
-        }
-        if (d1_valid)
-        {
-            raw_valid_mm_samples++;
-            if (d1 < raw_min_mm)
-            {
-                raw_min_mm = d1;
-            }
-            if (d1 > raw_max_mm)
-            {
-                raw_max_mm = d1;
-            }
-        }
-#endif
-
-        const bool obj0_ok = (d0_valid && d0 > 0u && obj0_conf >= TMF8828_MIN_CONFIDENCE);
-        const bool obj1_ok = (d1_valid && d1 > 0u && obj1_conf >= TMF8828_MIN_CONFIDENCE);
-        uint16_t chosen = 0u;
-        uint8_t chosen_obj = 0u;
-
-        if (obj0_ok && obj1_ok)
-        {
-#if TMF8828_PACKET_DIAG
-            dual_obj_zones++;
-            const uint16_t diff = (d0 > d1) ? (uint16_t)(d0 - d1) : (uint16_t)(d1 - d0);
-            if (diff >= TMF8828_DUAL_OBJ_SPLIT_MM)
-            {
-                dual_obj_split++;
-            }
-#endif
-#if (TMF8828_OBJECT_SELECT_POLICY == 0u)
-            if (d0 <= d1)
-            {
-                chosen = d0;
-                chosen_obj = 0u;
-            }
-            else
-            {
-                chosen = d1;
-                chosen_obj = 1u;
-            }
-#else
-            chosen = d0;
-            chosen_obj = 0u;
-#endif
-        }
-        else if (obj0_ok)
-        {
-            chosen = d0;
-            chosen_obj = 0u;
-        }
-#if (TMF8828_OBJECT_SELECT_POLICY != 2u)
-        else if (obj1_ok)
-        {
-            chosen = d1;
-            chosen_obj = 1u;
-        }
-#endif
-
-#if !TMF8828_PACKET_DIAG
-        (void)chosen_obj;
-#endif
-
-        if (chosen > 0u)
-        {
-            candidate_zone_mm[zone_out] = chosen;
-            candidate_mode[zone_out] = 1u;
-#if TMF8828_PACKET_DIAG
-            if (chosen_obj == 0u)
-            {
-                obj0_selected++;
-            }
-            else
-            {
-                obj1_selected++;
-            }
-#endif
-        }
-        else if (((obj0_dist_raw == 0u) && (obj0_conf > 0u)) ||
-                 ((obj1_dist_raw == 0u) && (obj1_conf > 0u)))
+        if (out_complete)
         {
-            /* Close saturation often reports 0mm with non-zero confidence. */
-            candidate_zone_mm[zone_out] = TMF8828_TOO_CLOSE_MM;
-            candidate_mode[zone_out] = 1u;
+            *out_complete = false;
         }
-        else
-        {
-            candidate_mode[zone_out] = 2u;
-        }
-
-        zone_out++;
-    }
-
-    if (!packet_any_signal && s_sequence_updated_total > 0u)
-    {
-        /* Occasionally a subcapture payload is all-zero while neighboring
-         * subcaptures in the same sequence are valid. Keep the last-good zones.
-         */
-        suppress_empty_packet = true;
+        return false;
     }
+    return tmf_read_result(out->mm, out->conf, out_complete);
+}
 
-    for (uint32_t z = 0u; z < zone_out; z++)
+bool tmf8828_quick_read_dual(tmf8828_dual_frame_t *out, bool *out_complete)
+{
+    if (!out)
     {
-        const uint32_t dst = tmf_zone_index_8x8(capture, z);
-        if (dst >= 64u)
-        {
-            continue;
-        }
-
-        if (candidate_mode[z] == 1u)
+        if (out_complete)
         {
-            uint16_t mm = candidate_zone_mm[z];
-#if TMF8828_RANGE_GLITCH_REJECT
-            const uint16_t prev = s_last_frame_mm[dst];
-            const bool mm_in_range = (mm >= TMF8828_EXPECTED_MIN_MM && mm <= TMF8828_EXPECTED_MAX_MM);
-            const bool prev_in_range = (prev >= TMF8828_EXPECTED_MIN_MM && prev <= TMF8828_EXPECTED_MAX_MM);
-            if (!mm_in_range && prev_in_range)
-            {
-#if TMF8828_PACKET_DIAG
-                range_glitch_reject++;
-#endif
-                continue;
-            }
-#endif
-            s_capture_mm[capture][z] = mm;
-            s_last_frame_mm[dst] = mm;
-            s_zone_invalid_streak[dst] = 0u;
-            updated_zones++;
-        }
-        else
-        {
-            s_capture_mm[capture][z] = 0u;
-            if (suppress_empty_packet)
-            {
-                continue;
-            }
-
-            if (s_last_frame_mm[dst] > 0u && s_zone_invalid_streak[dst] < TMF8828_ZONE_HOLD_FRAMES)
-            {
-                s_zone_invalid_streak[dst]++;
-            }
-            else
-            {
-                s_last_frame_mm[dst] = 0u;
-                if (s_zone_invalid_streak[dst] < 255u)
-                {
-                    s_zone_invalid_streak[dst]++;
-                }
-            }
+            *out_complete = false;
         }
+        return false;
     }
-
-    if (s_sequence_updated_total <= (uint16_t)(0xFFFFu - updated_zones))
-    {
-        s_sequence_updated_total = (uint16_t)(s_sequence_updated_total + updated_zones);
-    }
-    else
+    if (!tmf_read_result(out->mm[0], out->conf[0], out_complete))
     {
-        s_sequence_updated_total = 0xFFFFu;
+        return false;
     }
+    memcpy(out->mm[1], s_decoder.alt_mm, sizeof(s_decoder.alt_mm));
+    memcpy(out->conf[1], s_decoder.alt_conf, sizeof(s_decoder.alt_conf));
+    return true;
+}
 
-    s_capture_mask |= (uint8_t)(1u << capture);
-    const uint8_t capture_mask_for_log = s_capture_mask;
-    const bool complete_cycle = (capture_mask_for_log == 0x0Fu);
-    if (complete_cycle)
+bool tmf8828_quick_restart_measurement(void)
+{
+    if (!s_sensor_ready)
     {
-        s_capture_mask = 0u;
+        return false;
     }
 
-#if TMF8828_PACKET_DIAG
-    uint32_t valid_before_fill = 0u;
-    for (uint32_t i = 0u; i < 64u; i++)
-    {
-        if (s_last_frame_mm[i] > 0u && s_last_frame_mm[i] < 12000u)
-        {
-            valid_before_fill++;
-        }
-    }
-#endif
+    tmf_acq_stop();
+    (void)tmf_send_cmd_expect(TMF8828_CMD_STOP, 0u, 30000u);
+    (void)tmf_send_cmd_expect(TMF8828_CMD_CLEAR_STATUS, 0u, 30000u);
+    tmf_reset_capture_state();
 
-    memcpy(out_mm, s_last_frame_mm, sizeof(s_last_frame_mm));
-    if (updated_zones > 0u)
+    if (!tmf_start_measurement())
     {
-        tmf_fill_sparse_zones(out_mm);
-        memcpy(s_last_frame_mm, out_mm, sizeof(s_last_frame_mm));
+        return false;
     }
 
-#if TMF8828_PACKET_DIAG
-    uint32_t valid_after_fill = 0u;
-    for (uint32_t i = 0u; i < 64u; i++)
+    tmf_acq_start();
+    PRINTF("TOF: stream restarted\r\n");
+    return true;
+}
+
+void tmf8828_quick_get_last_update(tmf8828_update_t *out)
+{
+    if (out)
     {
-        if (out_mm[i] > 0u && out_mm[i] < 12000u)
-        {
-            valid_after_fill++;
-        }
+        *out = s_decoder.update;
     }
-#endif
-
-#if TMF8828_PACKET_DIAG
-    const uint16_t diag_min_mm = (raw_valid_mm_samples > 0u) ? raw_min_mm : 0u;
-    const uint16_t diag_max_mm = (raw_valid_mm_samples > 0u) ? raw_max_mm : 0u;
-    const uint8_t diag_conf_min = (conf_samples > 0u) ? conf_min : 0u;
-    const uint8_t diag_conf_max = (conf_samples > 0u) ? conf_max : 0u;
-    const uint32_t diag_conf_avg =
-        (conf_samples > 0u) ? (uint32_t)((conf_sum + (conf_samples / 2u)) / conf_samples) : 0u;
-
-    PRINTF("TOF PKT r=%u s=%u c=%u ru=%u rs=%u vp=%u va=%u d=%u-%u cf=%u-%u/%u u=%u ob=%u/%u ds=%u/%u rg=%u%s%s\r\n",
-           (unsigned)result_number,
-           (unsigned)sequence,
-           (unsigned)capture,
-           (unsigned)raw_slots_used,
-           (unsigned)raw_slots_skipped,
-           (unsigned)valid_before_fill,
-           (unsigned)valid_after_fill,
-           (unsigned)diag_min_mm,
-           (unsigned)diag_max_mm,
-           (unsigned)diag_conf_min,
-           (unsigned)diag_conf_max,
-           (unsigned)diag_conf_avg,
-           (unsigned)updated_zones,
-           (unsigned)obj0_selected,
-           (unsigned)obj1_selected,
-           (unsigned)dual_obj_split,
-           (unsigned)dual_obj_zones,
-           (unsigned)range_glitch_reject,
-           complete_cycle ? " complete" : "",
-           suppress_empty_packet ? " drop0" : "");
-#endif
+}
 
-#if TMF8828_TRACE_GRIDS
-    uint32_t valid_zones = 0u;
-    for (uint32_t i = 0u; i < 64u; i++)
+void tmf8828_quick_take_acq_stats(tmf8828_acq_stats_t *out)
+{
+    if (!out)
     {
-        const uint16_t v = out_mm[i];
-        if (v > 0u && v < 12000u)
-        {
-            valid_zones++;
-        }
+        return;
     }
 
-    const uint32_t captures_seen =
-        ((capture_mask_for_log & 0x1u) ? 1u : 0u) +
-        ((capture_mask_for_log & 0x2u) ? 1u : 0u) +
-        ((capture_mask_for_log & 0x4u) ? 1u : 0u) +
-        ((capture_mask_for_log & 0x8u) ? 1u : 0u);
-    const uint32_t packets_seen = captures_seen * TMF8828_ZONE_COUNT_8X8;
+    const uint32_t primask = DisableGlobalIRQ();
+    *out = s_acq_stats;
+    out->latency_avg_us = (s_acq_stats.results > 0u) ? (s_acq_latency_sum_us / s_acq_stats.results) : 0u;
+    out->read_avg_us = (s_acq_stats.reads > 0u) ? (s_acq_read_sum_us / s_acq_stats.reads) : 0u;
+    memset(&s_acq_stats, 0, sizeof(s_acq_stats));
+    s_acq_latency_sum_us = 0u;
+    s_acq_read_sum_us = 0u;
+    EnableGlobalIRQ(primask);
+}
 
-    PRINTF("TOF DBG: seq=%u cap=%u mask=0x%01x packets=%u/64 valid=%u updated=%u%s\r\n",
-           (unsigned)sequence,
-           (unsigned)capture,
-           (unsigned)capture_mask_for_log,
-           (unsigned)packets_seen,
-           (unsigned)valid_zones,
-           (unsigned)s_sequence_updated_total,
-           complete_cycle ? " complete" : "");
+void tmf8828_quick_bus_lock(void)
+{
+#if TMF8828_ASYNC_I2C
+    s_acq_bus_locked = true;
+    (void)tmf_i2c_async_wait_idle();
+#endif
+}
 
+void tmf8828_quick_bus_unlock(void)
+{
+#if TMF8828_ASYNC_I2C
+    const uint32_t primask = DisableGlobalIRQ();
+    s_acq_bus_locked = false;
+    tmf_acq_kick();
+    EnableGlobalIRQ(primask);
 #endif
+}
 
-    if (complete_cycle)
-    {
-        s_grid_counter++;
-        s_sequence_updated_total = 0u;
-    }
+/* Bring the stream back with the least work the sensor state allows:
+ * resume when the RAM app still runs in 8x8 mode, reload mode and config when
+ * only the app survived, and fall back to the full bring-up (probe, patch
+ * download, config) otherwise.
+ */
+tmf8828_recover_tier_t tmf8828_quick_recover(void)
+{
+    static const char *const tier_names[] = {"failed", "resume", "reconfig", "full"};
+    tmf8828_recover_tier_t tier = TMF8828_RECOVER_FAILED;
 
-    if (out_complete)
+    tmf_cycle_counter_init();
+    const uint32_t start = tmf_cycles_now();
+
+    if (s_info.present && s_active_bus >= 0)
     {
-        *out_complete = complete_cycle;
-    }
+        tmf_acq_stop();
+        s_sensor_ready = false;
 
-    return true;
-}
+        uint8_t appid = 0u;
+        if (tmf_rd8(TMF8828_REG_APPID, &appid) && appid == TMF8828_APP_ID_APP)
+        {
+            (void)tmf_send_cmd_expect(TMF8828_CMD_STOP, 0u, 30000u);
+            (void)tmf_send_cmd_expect(TMF8828_CMD_CLEAR_STATUS, 0u, 30000u);
+            tmf_reset_capture_state();
 
-bool tmf8828_quick_restart_measurement(void)
-{
-    if (!s_sensor_ready)
-    {
-        return false;
-    }
+            uint8_t mode = 0u;
+            if (tmf_rd8(TMF8828_REG_MODE, &mode) && mode == TMF8828_MODE_8X8 && tmf_start_measurement())
+            {
+                tier = TMF8828_RECOVER_RESUME;
+            }
+            else if (tmf_switch_to_8x8_mode() && tmf_enable_short_range_mode() && tmf_load_8x8_config() &&
+                     tmf_start_measurement())
+            {
+                tier = TMF8828_RECOVER_RECONFIG;
+            }
+        }
 
-    (void)tmf_send_cmd_expect(TMF8828_CMD_STOP, 0u, 30000u);
-    (void)tmf_send_cmd_expect(TMF8828_CMD_CLEAR_STATUS, 0u, 30000u);
-    memset(s_capture_mm, 0, sizeof(s_capture_mm));
-    memset(s_last_frame_mm, 0, sizeof(s_last_frame_mm));
-    memset(s_zone_invalid_streak, 0, sizeof(s_zone_invalid_streak));
-    s_capture_mask = 0u;
-    s_capture_sequence = 0u;
-    s_capture_sequence_valid = false;
+        if (tier != TMF8828_RECOVER_FAILED)
+        {
+            s_sensor_ready = true;
+            tmf_acq_start();
+        }
+    }
 
-    if (!tmf_start_measurement())
+    if (tier == TMF8828_RECOVER_FAILED && tmf8828_quick_init())
     {
-        return false;
+        tier = TMF8828_RECOVER_FULL;
     }
 
-    PRINTF("TOF: stream restarted\r\n");
-    return true;
+    PRINTF("TOF: recover tier=%s in %lu us\r\n",
+           tier_names[tier],
+           (unsigned long)tmf_cycles_to_us(tmf_cycles_now() - start));
+    return tier;
 }
@@ -10,9 +10,74 @@ typedef struct
     bool present;
     uint8_t chip_id;
     uint8_t rev_id;
+    uint32_t patch_load_us;          /* 0 when the RAM app was already running */
+    uint32_t boot_to_first_frame_us; /* init entry to first decoded result */
 } tmf8828_info_t;
 
+/* Result acquisition counters since the last tmf8828_quick_take_acq_stats. */
+typedef struct
+{
+    uint32_t results;          /* result blocks decoded */
+    uint32_t wasted_polls;     /* INT_STATUS reads that found no result */
+    uint32_t dropped_captures; /* sub-captures skipped by RESULT_NUMBER */
+    uint32_t ring_full;        /* INT serviced with every frame slot full */
+    uint32_t i2c_errors;       /* failed async measurement transfers */
+    uint32_t latency_avg_us;   /* result ready (INT or poll hit) to consume */
+    uint32_t latency_max_us;
+    uint32_t reads;            /* read calls from the render loop */
+    uint32_t read_avg_us;      /* time the caller spent in each read */
+    uint32_t read_max_us;
+} tmf8828_acq_stats_t;
+
+/* One 8x8 frame with the signal confidence (0-255) of the return published
+ * for each zone. Held zones fade, zones filled from neighbours carry 0.
+ */
+typedef struct
+{
+    uint16_t mm[64];
+    uint8_t conf[64];
+} tmf8828_frame_t;
+
+/* Both object returns per zone, struct-of-arrays. Return 0 is the one
+ * published in tmf8828_frame_t (policy, hold and fill applied); return 1 is
+ * the other object of the zone from its latest capture, 0 mm when none.
+ */
+typedef struct
+{
+    uint16_t mm[2][64];
+    uint8_t conf[2][64];
+} tmf8828_dual_frame_t;
+
+/* What the result returned by the latest successful read changed. Every read
+ * publishes one sub-capture, i.e. 16 of the 64 zones.
+ */
+typedef struct
+{
+    uint64_t zone_mask;    /* zones measured by this sub-capture, bit = row * 8 + col */
+    uint64_t changed_mask; /* published zones whose distance changed, fills included */
+    uint32_t timestamp_us; /* result ready time, driver microsecond clock */
+    uint8_t capture;       /* sub-capture 0-3 */
+    bool complete;         /* last sub-capture of an 8x8 cycle */
+} tmf8828_update_t;
+
+/* Recovery tiers, cheapest first. */
+typedef enum
+{
+    TMF8828_RECOVER_FAILED = 0,
+    TMF8828_RECOVER_RESUME,   /* app and 8x8 config alive: measurement restarted */
+    TMF8828_RECOVER_RECONFIG, /* app alive: mode and config reloaded */
+    TMF8828_RECOVER_FULL,     /* full bring-up including patch download */
+} tmf8828_recover_tier_t;
+
 bool tmf8828_quick_init(void);
 bool tmf8828_quick_get_info(tmf8828_info_t *out);
 bool tmf8828_quick_read_8x8(uint16_t out_mm[64], bool *out_complete);
+bool tmf8828_quick_read_frame(tmf8828_frame_t *out, bool *out_complete);
+bool tmf8828_quick_read_dual(tmf8828_dual_frame_t *out, bool *out_complete);
+void tmf8828_quick_get_last_update(tmf8828_update_t *out);
 bool tmf8828_quick_restart_measurement(void);
+tmf8828_recover_tier_t tmf8828_quick_recover(void);
+void tmf8828_quick_take_acq_stats(tmf8828_acq_stats_t *out);
+/* Bracket other blocking transfers on a bus shared with the sensor. */
+void tmf8828_quick_bus_lock(void);
+void tmf8828_quick_bus_unlock(void);
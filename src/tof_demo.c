@@ -13,6 +13,9 @@
 
 #include "platform/display_hal.h"
 #include "tmf8828_quick.h"
+#include "tof_font.h"
+#include "tof_grid_nbr.h"
+#include "tof_source.h"
 
 #define TOF_GRID_W 8
 #define TOF_GRID_H 8
@@ -35,6 +38,10 @@
 #define TOF_LOCKED_NEAR_MM 50u
 #define TOF_LOCKED_FAR_MM  120u
 #define TOF_HEATMAP_DARK_MM 100u
+/* One colour per mm up to just past the ramp end; covers the whole ramp
+ * while the near edge stays below TOF_HEATMAP_DARK_MM.
+ */
+#define TOF_COLOR_LUT_LEN (TOF_HEATMAP_DARK_MM + 2u)
 #define TOF_STALE_LIMIT_FRAMES 120u
 #define TOF_RESTART_LIMIT_FRAMES 300u
 #define TOF_REINIT_LIMIT_FRAMES 600u
@@ -65,7 +72,7 @@
 #endif
 
 #define TOF_READ_BURST_MAX 8u
-#define TOF_DRAW_ON_COMPLETE_ONLY 1u
+#define TOF_ZONES_ALL (~(uint64_t)0u)
 #define TOF_USE_DYNAMIC_RANGE 0u
 #define TOF_RESPONSE_TARGET_US 500000u
 #define TOF_DEBUG_UPDATE_US 200000u
@@ -163,6 +170,29 @@
 #define TOF_AI_GRID_OUTLIER_MM_MAX 80u
 #define TOF_AI_GRID_FAST_DELTA_MM 10u
 #define TOF_AI_GRID_HOLD_FRAMES 24u
+
+/* Weight live samples by the sensor's per-zone signal confidence in the
+ * estimator, the grid denoiser and the curve picker. Synthetic and fallback
+ * frames have no confidence plane and keep uniform weights.
+ */
+#ifndef TOF_CONF_WEIGHTING
+#define TOF_CONF_WEIGHTING 1u
+#endif
+#define TOF_CONF_FULL 64u          /* sensor confidence treated as fully reliable */
+#define TOF_CONF_WEIGHT_MIN_Q8 32u /* held/filled zones still count a little */
+#define TOF_CONF_PICK_MIN_Q8 64u   /* curve picker ignores weaker zones */
+
+/* Pick per zone between the two sensor returns: the alternate replaces the
+ * published one when it is closer to the surface distance. Stops flange hits
+ * from snapping the roll to FULL or EMPTY. The surface distance is the median
+ * of the zones with a single return, which the selection cannot move; frames
+ * with too few of those fall back to the spool model's surface.
+ */
+#ifndef TOF_RETURN_SELECT
+#define TOF_RETURN_SELECT 1u
+#endif
+#define TOF_RETURN_SELECT_MARGIN_MM 6u
+#define TOF_RETURN_SELECT_REF_ZONES_MIN 16u
 #define TOF_CORNER_REPAIR_DELTA_MM 72u
 #define TOF_TOUCH_I2C LPI2C2
 #define TOF_TOUCH_I2C_SUBADDR_SIZE 2u
@@ -184,19 +214,107 @@
 #define TOF_INPUT_MODE_LIVE          0u
 #define TOF_INPUT_MODE_SYNTH_FIXED   1u
 #define TOF_INPUT_MODE_SYNTH_SUBCAP  2u
+#define TOF_INPUT_MODE_REPLAY        3u /* host builds only, see tests/tof_demo_host.c */
 
 #ifndef TOF_DEBUG_INPUT_MODE
 #define TOF_DEBUG_INPUT_MODE TOF_INPUT_MODE_LIVE
 #endif
 
-#ifndef TOF_SYNTH_MAP_MODE
-#define TOF_SYNTH_MAP_MODE 0u
+#if (TOF_DEBUG_INPUT_MODE == TOF_INPUT_MODE_LIVE)
+#define TOF_INPUT_SOURCE g_tof_source_live
+#elif (TOF_DEBUG_INPUT_MODE == TOF_INPUT_MODE_SYNTH_FIXED)
+#define TOF_INPUT_SOURCE g_tof_source_synth_fixed
+#elif (TOF_DEBUG_INPUT_MODE == TOF_INPUT_MODE_SYNTH_SUBCAP)
+#define TOF_INPUT_SOURCE g_tof_source_synth_subcap
+#elif (TOF_DEBUG_INPUT_MODE == TOF_INPUT_MODE_REPLAY)
+#if !defined(TOF_HOST_BUILD)
+#error "TOF_DEBUG_INPUT_MODE 3 (replay) needs the host build, see tests/CMakeLists.txt"
+#endif
+#define TOF_INPUT_SOURCE g_tof_source_replay
+#else
+#error "TOF_DEBUG_INPUT_MODE: unknown input mode"
+#endif
+
+/* Redraw as each sub-capture lands instead of waiting for the full 8x8
+ * cycle. Temporal filters then step only the zones measured since
+ * the previous draw, so their time constants stay per sensor cycle.
+ * Default on for the live sensor only; the synthetic and replay sources
+ * keep their full-frame draws. Setting TOF_DRAW_ON_COMPLETE_ONLY keeps the
+ * live sensor on full-frame draws as well.
+ */
+#ifndef TOF_DRAW_PARTIAL_UPDATES
+#if (TOF_DEBUG_INPUT_MODE == TOF_INPUT_MODE_LIVE) && !defined(TOF_DRAW_ON_COMPLETE_ONLY)
+#define TOF_DRAW_PARTIAL_UPDATES 1u
+#else
+#define TOF_DRAW_PARTIAL_UPDATES 0u
+#endif
+#endif
+
+#ifndef TOF_DRAW_ON_COMPLETE_ONLY
+#if TOF_DRAW_PARTIAL_UPDATES
+#define TOF_DRAW_ON_COMPLETE_ONLY 0u
+#else
+#define TOF_DRAW_ON_COMPLETE_ONLY 1u
+#endif
+#endif
+
+#if TOF_DRAW_PARTIAL_UPDATES && TOF_DRAW_ON_COMPLETE_ONLY
+#error "TOF_DRAW_PARTIAL_UPDATES draws every sub-capture, unset TOF_DRAW_ON_COMPLETE_ONLY"
 #endif
 
 #ifndef TOF_SYNTH_TRACE_EVERY_COMPLETE
 #define TOF_SYNTH_TRACE_EVERY_COMPLETE 12u
 #endif
 
+/* Log display-list bus traffic and sensor acquisition counters every N ticks
+ * (0 disables).
+ */
+#ifndef TOF_DISPLAY_STATS_LOG_TICKS
+#define TOF_DISPLAY_STATS_LOG_TICKS 500u
+#endif
+
+/* Compose the spool off-screen in strips of TOF_TP_STRIP_PX pixels (16 full
+ * rows of the TP area by default) and blit each strip once.
+ */
+#ifndef TOF_TP_TILE_RENDER
+#define TOF_TP_TILE_RENDER 1u
+#endif
+#ifndef TOF_TP_STRIP_PX
+#define TOF_TP_STRIP_PX ((TOF_LCD_W - (TOF_LCD_W / 3) - 1) * 16)
+#endif
+
+/* Rasterize debug lines, pills, the brand mark and the alert popup into the
+ * strip buffer and blit them, instead of one fill per lit glyph pixel.
+ */
+#ifndef TOF_TEXT_LINE_RENDER
+#define TOF_TEXT_LINE_RENDER 1u
+#endif
+
+/* Use the 2x pre-expanded 3x5 rows from tof_font.h for TOF_DBG_SCALE text. */
+#ifndef TOF_FONT_PRESCALED_2X
+#define TOF_FONT_PRESCALED_2X 1u
+#endif
+
+/* RAM budget for RLE spool sprites, one per (segments, live) pair; 0
+ * disables the cache. Needs TOF_TP_TILE_RENDER.
+ */
+#ifndef TOF_SPOOL_CACHE_BYTES
+#define TOF_SPOOL_CACHE_BYTES (64u * 1024u)
+#endif
+/* Log each sprite cache miss. Off by default: the line is printed from the
+ * render path and blocks for the length of the UART write.
+ */
+#ifndef TOF_SPOOL_CACHE_TRACE
+#define TOF_SPOOL_CACHE_TRACE 0u
+#endif
+
+/* Repaint changed heatmap rows off-screen and blit them, instead of one
+ * fill per changed cell.
+ */
+#ifndef TOF_HEATMAP_BLIT
+#define TOF_HEATMAP_BLIT 1u
+#endif
+
 #if defined(__GNUC__)
 #define TOF_UNUSED __attribute__((unused))
 #else
@@ -228,8 +346,16 @@ static uint16_t s_filtered_mm[64];
 static uint16_t s_display_mm[64];
 static uint16_t s_last_cell_color[64];
 static bool s_cell_drawn[64];
+static uint16_t s_cell_outline[64];
 static uint8_t s_invalid_age[64];
 static uint8_t s_display_age[64];
+static uint8_t s_zone_conf[64];
+static bool s_zone_conf_live = false;
+static uint16_t s_surface_ref_mm = 0u; /* spool model surface, sensor units */
+static uint16_t s_return_ref_mm = 0u;  /* reference of the last selection */
+static uint32_t s_return_swaps = 0u;
+static uint64_t s_step_mask = TOF_ZONES_ALL; /* zones the temporal filters advance */
+static uint32_t s_frame_seq = 0u;             /* bumped whenever main rewrites its input frame */
 
 static uint16_t s_ui_bg;
 static uint16_t s_ui_border;
@@ -323,8 +449,11 @@ static uint16_t s_ai_grid_noise_mm = 0u;
 
 static uint16_t s_range_near_mm = TOF_LOCKED_NEAR_MM;
 static uint16_t s_range_far_mm = TOF_LOCKED_FAR_MM;
-static uint16_t s_synth_subcap_frame[64];
-static uint8_t s_synth_subcap_capture = 0u;
+static uint16_t s_color_lut[TOF_COLOR_LUT_LEN];
+static uint16_t s_color_lut_near_mm = 0u;
+static uint16_t s_color_lut_far_mm = 0u;
+static bool s_color_lut_valid = false;
+static bool s_color_lut_tail_above = false;
 
 static void tof_ai_grid_reset(void);
 static void tof_tp_bar_rect(int32_t *x0, int32_t *y0, int32_t *x1, int32_t *y1);
@@ -332,8 +461,6 @@ static void tof_tp_status_rect(int32_t *x0, int32_t *y0, int32_t *x1, int32_t *y
 static uint16_t tof_tp_bg_color(uint32_t t, bool live_data);
 static void tof_tp_fill_bg_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, bool live_data);
 static void tof_draw_roll_status_banner(tof_roll_alert_level_t level, bool live_data);
-static void tof_draw_brand_mark(void);
-static void tof_ai_denoise_heatmap_frame(const uint16_t in_mm[64], uint16_t out_mm[64], bool live_data);
 static uint16_t tof_ai_grid_median_u16(uint16_t *values, uint32_t count);
 static void tof_tiny_draw_char_scaled_clipped(int32_t x,
                                               int32_t y,
@@ -350,6 +477,192 @@ static bool tof_mm_valid(uint16_t mm)
     return (mm > 0u && mm < 12000u);
 }
 
+/* Weight of zone idx in the current live frame, q8 (256 = fully reliable).
+ * Uniform when no confidence plane is active.
+ */
+static uint32_t tof_zone_weight_q8(uint32_t idx)
+{
+#if TOF_CONF_WEIGHTING
+    if (s_zone_conf_live)
+    {
+        const uint32_t c = s_zone_conf[idx];
+        const uint32_t w = (c >= TOF_CONF_FULL) ? 256u : ((c * 256u) / TOF_CONF_FULL);
+        return (w < TOF_CONF_WEIGHT_MIN_Q8) ? TOF_CONF_WEIGHT_MIN_Q8 : w;
+    }
+#else
+    (void)idx;
+#endif
+    return 256u;
+}
+
+#if TOF_RETURN_SELECT
+/* Surface distance for the selection. A reference fed back from selected
+ * frames, even through the smoothed model, can settle on a large flange
+ * patch and keep selecting it; zones with a single return do not depend on
+ * the selection.
+ */
+static uint16_t tof_select_reference_mm(const tmf8828_dual_frame_t *in)
+{
+    uint16_t single[64];
+    uint32_t count = 0u;
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        if (tof_mm_valid(in->mm[0][i]) && !tof_mm_valid(in->mm[1][i]))
+        {
+            single[count++] = in->mm[0][i];
+        }
+    }
+
+    if (count >= TOF_RETURN_SELECT_REF_ZONES_MIN)
+    {
+        return tof_ai_grid_median_u16(single, count);
+    }
+    return s_surface_ref_mm;
+}
+#endif
+
+/* Selection stage: collapse a dual-return frame into one distance and
+ * confidence per zone, keeping the return consistent with the spool surface.
+ */
+static void tof_select_returns(const tmf8828_dual_frame_t *in, uint16_t out_mm[64], uint8_t out_conf[64])
+{
+    memcpy(out_mm, in->mm[0], 64u * sizeof(uint16_t));
+    memcpy(out_conf, in->conf[0], 64u);
+#if TOF_RETURN_SELECT
+    const uint16_t ref = tof_select_reference_mm(in);
+    s_return_ref_mm = ref;
+    if (ref == 0u)
+    {
+        return;
+    }
+
+    const uint16_t *alt_mm = in->mm[1];
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        const uint16_t alt = alt_mm[i];
+        if (!tof_mm_valid(alt))
+        {
+            continue;
+        }
+
+        const uint16_t cur = out_mm[i];
+        const uint32_t alt_err = (alt > ref) ? (uint32_t)(alt - ref) : (uint32_t)(ref - alt);
+        const uint32_t cur_err = (cur > ref) ? (uint32_t)(cur - ref) : (uint32_t)(ref - cur);
+        if (!tof_mm_valid(cur) || (alt_err + TOF_RETURN_SELECT_MARGIN_MM) < cur_err)
+        {
+            out_mm[i] = alt;
+            out_conf[i] = in->conf[1][i];
+            s_return_swaps++;
+        }
+    }
+#endif
+}
+
+/* Per-frame statistics gathered in one pass. The spool model, estimator,
+ * debug panel and AI log read these instead of each rescanning the frame.
+ */
+typedef struct
+{
+    const uint16_t *mm; /* frame summarised */
+    uint32_t seq;       /* s_frame_seq at build time */
+    uint64_t valid_mask;
+    uint32_t valid_count;
+    uint32_t sum;
+    uint16_t min_mm; /* 0 when no zone is valid */
+    uint16_t max_mm;
+    int8_t min_idx; /* first zone holding min_mm, -1 when none */
+    uint16_t row_min_mm[TOF_GRID_H]; /* 0 for rows with no valid zone */
+    uint32_t weight_sum_q8; /* tof_zone_weight_q8 over the valid zones */
+    uint32_t center_sum;    /* inner 4x4 */
+    uint32_t center_count;
+    uint32_t edge_sum; /* outer ring */
+    uint32_t edge_count;
+} tof_frame_summary_t;
+
+static tof_frame_summary_t s_frame_summary;
+
+static void tof_frame_summary_build(const uint16_t mm[64], tof_frame_summary_t *s)
+{
+    memset(s, 0, sizeof(*s));
+    s->mm = mm;
+    s->seq = s_frame_seq;
+    s->min_idx = -1;
+
+    uint16_t min_v = 0xFFFFu;
+    for (uint32_t y = 0u; y < TOF_GRID_H; y++)
+    {
+        uint16_t row_min = 0xFFFFu;
+        for (uint32_t x = 0u; x < TOF_GRID_W; x++)
+        {
+            const uint32_t idx = (y * TOF_GRID_W) + x;
+            const uint16_t v = mm[idx];
+            if (!tof_mm_valid(v))
+            {
+                continue;
+            }
+
+            s->valid_mask |= (uint64_t)1u << idx;
+            s->valid_count++;
+            s->sum += v;
+            s->weight_sum_q8 += tof_zone_weight_q8(idx);
+            if (v < min_v)
+            {
+                min_v = v;
+                s->min_idx = (int8_t)idx;
+            }
+            if (v < row_min)
+            {
+                row_min = v;
+            }
+            if (v > s->max_mm)
+            {
+                s->max_mm = v;
+            }
+            if ((x >= 2u && x <= 5u) && (y >= 2u && y <= 5u))
+            {
+                s->center_sum += v;
+                s->center_count++;
+            }
+            if (x == 0u || x == (TOF_GRID_W - 1u) || y == 0u || y == (TOF_GRID_H - 1u))
+            {
+                s->edge_sum += v;
+                s->edge_count++;
+            }
+        }
+        s->row_min_mm[y] = (row_min != 0xFFFFu) ? row_min : 0u;
+    }
+    s->min_mm = (s->valid_count > 0u) ? min_v : 0u;
+}
+
+/* Summary of main's input frame, built on first use per frame sequence.
+ * Only for buffers that change together with s_frame_seq; scratch frames
+ * build their own with tof_frame_summary_build().
+ */
+static const tof_frame_summary_t *tof_frame_summary(const uint16_t mm[64])
+{
+    if (s_frame_summary.mm != mm || s_frame_summary.seq != s_frame_seq)
+    {
+        tof_frame_summary_build(mm, &s_frame_summary);
+    }
+    return &s_frame_summary;
+}
+
+static uint16_t tof_frame_summary_avg_mm(const tof_frame_summary_t *s)
+{
+    return (s->valid_count > 0u) ? (uint16_t)(s->sum / s->valid_count) : 0u;
+}
+
+static uint16_t tof_frame_summary_spread_mm(const tof_frame_summary_t *s)
+{
+    return (uint16_t)(s->max_mm - s->min_mm);
+}
+
+/* Mean zone weight over the valid samples, as q10. */
+static uint32_t tof_signal_conf_q10(const tof_frame_summary_t *s)
+{
+    return (s->valid_count > 0u) ? ((s->weight_sum_q8 * 4u) / s->valid_count) : 0u;
+}
+
 static inline uint16_t pack_rgb565(uint32_t r8, uint32_t g8, uint32_t b8)
 {
     if (r8 > 255u) r8 = 255u;
@@ -424,6 +737,47 @@ static uint16_t tof_color_from_mm(uint16_t mm, uint16_t near_mm, uint16_t far_mm
     return pack_rgb565(r, g, b);
 }
 
+/* Rebuild s_color_lut when the heatmap range has moved since the last build. */
+static void tof_color_lut_update(void)
+{
+    if (s_color_lut_valid && s_color_lut_near_mm == s_range_near_mm && s_color_lut_far_mm == s_range_far_mm)
+    {
+        return;
+    }
+
+    for (uint32_t mm = 0u; mm < TOF_COLOR_LUT_LEN; mm++)
+    {
+        s_color_lut[mm] = tof_color_from_mm((uint16_t)mm, s_range_near_mm, s_range_far_mm);
+    }
+
+    /* Past the table every valid distance is above range unless the ramp
+     * itself was pushed out there by a far near edge.
+     */
+    uint32_t color_far_mm = (s_range_far_mm > TOF_HEATMAP_DARK_MM) ? TOF_HEATMAP_DARK_MM : s_range_far_mm;
+    if (color_far_mm <= s_range_near_mm)
+    {
+        color_far_mm = (uint32_t)s_range_near_mm + 1u;
+    }
+    s_color_lut_tail_above = (color_far_mm < TOF_COLOR_LUT_LEN);
+    s_color_lut_near_mm = s_range_near_mm;
+    s_color_lut_far_mm = s_range_far_mm;
+    s_color_lut_valid = true;
+}
+
+/* Same result as tof_color_from_mm() for the current range. */
+static inline uint16_t tof_color_lookup(uint16_t mm)
+{
+    if (mm < TOF_COLOR_LUT_LEN)
+    {
+        return s_color_lut[mm];
+    }
+    if (!s_color_lut_tail_above)
+    {
+        return tof_color_from_mm(mm, s_range_near_mm, s_range_far_mm);
+    }
+    return tof_mm_valid(mm) ? s_ui_above_range : s_ui_invalid;
+}
+
 static void tof_fill_display_holes(const uint16_t in_mm[64], uint16_t out_mm[64])
 {
     memcpy(out_mm, in_mm, sizeof(uint16_t) * 64u);
@@ -543,120 +897,220 @@ static int32_t tof_clamp_i32(int32_t v, int32_t lo, int32_t hi)
     return v;
 }
 
-static void tof_dbg_get_glyph(char ch, uint8_t rows[TOF_DBG_CHAR_H])
-{
-    if (ch >= 'a' && ch <= 'z')
-    {
-        ch = (char)(ch - ('a' - 'A'));
-    }
-
-    switch (ch)
-    {
-        case '0': rows[0] = 0x7; rows[1] = 0x5; rows[2] = 0x5; rows[3] = 0x5; rows[4] = 0x7; break;
-        case '1': rows[0] = 0x2; rows[1] = 0x6; rows[2] = 0x2; rows[3] = 0x2; rows[4] = 0x7; break;
-        case '2': rows[0] = 0x7; rows[1] = 0x1; rows[2] = 0x7; rows[3] = 0x4; rows[4] = 0x7; break;
-        case '3': rows[0] = 0x7; rows[1] = 0x1; rows[2] = 0x7; rows[3] = 0x1; rows[4] = 0x7; break;
-        case '4': rows[0] = 0x5; rows[1] = 0x5; rows[2] = 0x7; rows[3] = 0x1; rows[4] = 0x1; break;
-        case '5': rows[0] = 0x7; rows[1] = 0x4; rows[2] = 0x7; rows[3] = 0x1; rows[4] = 0x7; break;
-        case '6': rows[0] = 0x7; rows[1] = 0x4; rows[2] = 0x7; rows[3] = 0x5; rows[4] = 0x7; break;
-        case '7': rows[0] = 0x7; rows[1] = 0x1; rows[2] = 0x2; rows[3] = 0x2; rows[4] = 0x2; break;
-        case '8': rows[0] = 0x7; rows[1] = 0x5; rows[2] = 0x7; rows[3] = 0x5; rows[4] = 0x7; break;
-        case '9': rows[0] = 0x7; rows[1] = 0x5; rows[2] = 0x7; rows[3] = 0x1; rows[4] = 0x7; break;
-        case 'A': rows[0] = 0x2; rows[1] = 0x5; rows[2] = 0x7; rows[3] = 0x5; rows[4] = 0x5; break;
-        case 'B': rows[0] = 0x6; rows[1] = 0x5; rows[2] = 0x6; rows[3] = 0x5; rows[4] = 0x6; break;
-        case 'C': rows[0] = 0x3; rows[1] = 0x4; rows[2] = 0x4; rows[3] = 0x4; rows[4] = 0x3; break;
-        case 'D': rows[0] = 0x6; rows[1] = 0x5; rows[2] = 0x5; rows[3] = 0x5; rows[4] = 0x6; break;
-        case 'E': rows[0] = 0x7; rows[1] = 0x4; rows[2] = 0x6; rows[3] = 0x4; rows[4] = 0x7; break;
-        case 'F': rows[0] = 0x7; rows[1] = 0x4; rows[2] = 0x6; rows[3] = 0x4; rows[4] = 0x4; break;
-        case 'G': rows[0] = 0x3; rows[1] = 0x4; rows[2] = 0x5; rows[3] = 0x5; rows[4] = 0x3; break;
-        case 'H': rows[0] = 0x5; rows[1] = 0x5; rows[2] = 0x7; rows[3] = 0x5; rows[4] = 0x5; break;
-        case 'I': rows[0] = 0x7; rows[1] = 0x2; rows[2] = 0x2; rows[3] = 0x2; rows[4] = 0x7; break;
-        case 'J': rows[0] = 0x1; rows[1] = 0x1; rows[2] = 0x1; rows[3] = 0x5; rows[4] = 0x2; break;
-        case 'K': rows[0] = 0x5; rows[1] = 0x5; rows[2] = 0x6; rows[3] = 0x5; rows[4] = 0x5; break;
-        case 'L': rows[0] = 0x4; rows[1] = 0x4; rows[2] = 0x4; rows[3] = 0x4; rows[4] = 0x7; break;
-        case 'M': rows[0] = 0x5; rows[1] = 0x7; rows[2] = 0x7; rows[3] = 0x5; rows[4] = 0x5; break;
-        case 'N': rows[0] = 0x5; rows[1] = 0x7; rows[2] = 0x7; rows[3] = 0x7; rows[4] = 0x5; break;
-        case 'O': rows[0] = 0x2; rows[1] = 0x5; rows[2] = 0x5; rows[3] = 0x5; rows[4] = 0x2; break;
-        case 'P': rows[0] = 0x6; rows[1] = 0x5; rows[2] = 0x6; rows[3] = 0x4; rows[4] = 0x4; break;
-        case 'Q': rows[0] = 0x2; rows[1] = 0x5; rows[2] = 0x5; rows[3] = 0x2; rows[4] = 0x1; break;
-        case 'R': rows[0] = 0x6; rows[1] = 0x5; rows[2] = 0x6; rows[3] = 0x5; rows[4] = 0x5; break;
-        case 'S': rows[0] = 0x3; rows[1] = 0x4; rows[2] = 0x2; rows[3] = 0x1; rows[4] = 0x6; break;
-        case 'T': rows[0] = 0x7; rows[1] = 0x2; rows[2] = 0x2; rows[3] = 0x2; rows[4] = 0x2; break;
-        case 'U': rows[0] = 0x5; rows[1] = 0x5; rows[2] = 0x5; rows[3] = 0x5; rows[4] = 0x7; break;
-        case 'V': rows[0] = 0x5; rows[1] = 0x5; rows[2] = 0x5; rows[3] = 0x5; rows[4] = 0x2; break;
-        case 'W': rows[0] = 0x5; rows[1] = 0x5; rows[2] = 0x7; rows[3] = 0x7; rows[4] = 0x5; break;
-        case 'X': rows[0] = 0x5; rows[1] = 0x5; rows[2] = 0x2; rows[3] = 0x5; rows[4] = 0x5; break;
-        case 'Y': rows[0] = 0x5; rows[1] = 0x5; rows[2] = 0x2; rows[3] = 0x2; rows[4] = 0x2; break;
-        case 'Z': rows[0] = 0x7; rows[1] = 0x1; rows[2] = 0x2; rows[3] = 0x4; rows[4] = 0x7; break;
-        case ':': rows[0] = 0x0; rows[1] = 0x2; rows[2] = 0x0; rows[3] = 0x2; rows[4] = 0x0; break;
-        case '.': rows[0] = 0x0; rows[1] = 0x0; rows[2] = 0x0; rows[3] = 0x0; rows[4] = 0x2; break;
-        case '-': rows[0] = 0x0; rows[1] = 0x0; rows[2] = 0x7; rows[3] = 0x0; rows[4] = 0x0; break;
-        case '/': rows[0] = 0x1; rows[1] = 0x1; rows[2] = 0x2; rows[3] = 0x4; rows[4] = 0x4; break;
-        case '(': rows[0] = 0x1; rows[1] = 0x2; rows[2] = 0x2; rows[3] = 0x2; rows[4] = 0x1; break;
-        case ')': rows[0] = 0x4; rows[1] = 0x2; rows[2] = 0x2; rows[3] = 0x2; rows[4] = 0x4; break;
-        case '=': rows[0] = 0x0; rows[1] = 0x7; rows[2] = 0x0; rows[3] = 0x7; rows[4] = 0x0; break;
-        case ' ': rows[0] = 0x0; rows[1] = 0x0; rows[2] = 0x0; rows[3] = 0x0; rows[4] = 0x0; break;
-        default:  rows[0] = 0x7; rows[1] = 0x1; rows[2] = 0x2; rows[3] = 0x0; rows[4] = 0x2; break;
+typedef struct
+{
+    uint16_t *px;
+    int32_t x0;
+    int32_t y0;
+    int32_t x1;
+    int32_t y1;
+} tof_canvas_t;
+
+/* Off-screen render target; NULL draws straight to the panel. */
+static tof_canvas_t *s_canvas = NULL;
+static uint16_t s_canvas_px[TOF_TP_STRIP_PX];
+
+static void tof_canvas_fill_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t color)
+{
+    const tof_canvas_t *c = s_canvas;
+    if (c == NULL)
+    {
+        display_hal_fill_rect(x0, y0, x1, y1, color);
+        return;
+    }
+
+    x0 = (x0 > c->x0) ? x0 : c->x0;
+    y0 = (y0 > c->y0) ? y0 : c->y0;
+    x1 = (x1 < c->x1) ? x1 : c->x1;
+    y1 = (y1 < c->y1) ? y1 : c->y1;
+    if (x1 < x0 || y1 < y0)
+    {
+        return;
+    }
+
+    const int32_t stride = (c->x1 - c->x0) + 1;
+    for (int32_t y = y0; y <= y1; y++)
+    {
+        uint16_t *dst = &c->px[((y - c->y0) * stride) + (x0 - c->x0)];
+        for (int32_t x = x0; x <= x1; x++)
+        {
+            *dst++ = color;
+        }
     }
 }
 
-static void tof_brand_get_glyph_5x7(char ch, uint8_t rows[7])
+typedef void (*tof_canvas_draw_fn_t)(const void *ctx);
+
+/* Replay draw() into RAM one strip of s_canvas_px at a time and push each
+ * strip with a single blit. draw() must cover every pixel of the region.
+ */
+static void tof_canvas_render(int32_t x0,
+                              int32_t y0,
+                              int32_t x1,
+                              int32_t y1,
+                              tof_canvas_draw_fn_t draw,
+                              const void *ctx)
 {
-    if (ch >= 'a' && ch <= 'z')
+    x0 = tof_clamp_i32(x0, 0, TOF_LCD_W - 1);
+    x1 = tof_clamp_i32(x1, 0, TOF_LCD_W - 1);
+    y0 = tof_clamp_i32(y0, 0, TOF_LCD_H - 1);
+    y1 = tof_clamp_i32(y1, 0, TOF_LCD_H - 1);
+    if (x1 < x0 || y1 < y0)
+    {
+        return;
+    }
+
+    const int32_t w = (x1 - x0) + 1;
+    const int32_t rows = (int32_t)TOF_TP_STRIP_PX / w;
+    if (rows <= 0)
     {
-        ch = (char)(ch - ('a' - 'A'));
+        draw(ctx);
+        return;
     }
 
-    switch (ch)
+    for (int32_t sy = y0; sy <= y1; sy += rows)
     {
-        case 'A': rows[0] = 0x0E; rows[1] = 0x11; rows[2] = 0x11; rows[3] = 0x1F; rows[4] = 0x11; rows[5] = 0x11; rows[6] = 0x11; break;
-        case 'B': rows[0] = 0x1E; rows[1] = 0x11; rows[2] = 0x11; rows[3] = 0x1E; rows[4] = 0x11; rows[5] = 0x11; rows[6] = 0x1E; break;
-        case 'C': rows[0] = 0x0E; rows[1] = 0x11; rows[2] = 0x10; rows[3] = 0x10; rows[4] = 0x10; rows[5] = 0x11; rows[6] = 0x0E; break;
-        case 'D': rows[0] = 0x1E; rows[1] = 0x11; rows[2] = 0x11; rows[3] = 0x11; rows[4] = 0x11; rows[5] = 0x11; rows[6] = 0x1E; break;
-        case 'E': rows[0] = 0x1F; rows[1] = 0x10; rows[2] = 0x10; rows[3] = 0x1E; rows[4] = 0x10; rows[5] = 0x10; rows[6] = 0x1F; break;
-        case 'H': rows[0] = 0x11; rows[1] = 0x11; rows[2] = 0x11; rows[3] = 0x1F; rows[4] = 0x11; rows[5] = 0x11; rows[6] = 0x11; break;
-        case 'I': rows[0] = 0x1F; rows[1] = 0x04; rows[2] = 0x04; rows[3] = 0x04; rows[4] = 0x04; rows[5] = 0x04; rows[6] = 0x1F; break;
-        case 'K': rows[0] = 0x11; rows[1] = 0x12; rows[2] = 0x14; rows[3] = 0x18; rows[4] = 0x14; rows[5] = 0x12; rows[6] = 0x11; break;
-        case 'N': rows[0] = 0x11; rows[1] = 0x19; rows[2] = 0x15; rows[3] = 0x13; rows[4] = 0x11; rows[5] = 0x11; rows[6] = 0x11; break;
-        case 'O': rows[0] = 0x0E; rows[1] = 0x11; rows[2] = 0x11; rows[3] = 0x11; rows[4] = 0x11; rows[5] = 0x11; rows[6] = 0x0E; break;
-        case 'R': rows[0] = 0x1E; rows[1] = 0x11; rows[2] = 0x11; rows[3] = 0x1E; rows[4] = 0x14; rows[5] = 0x12; rows[6] = 0x11; break;
-        case '(': rows[0] = 0x02; rows[1] = 0x04; rows[2] = 0x08; rows[3] = 0x08; rows[4] = 0x08; rows[5] = 0x04; rows[6] = 0x02; break;
-        case ')': rows[0] = 0x08; rows[1] = 0x04; rows[2] = 0x02; rows[3] = 0x02; rows[4] = 0x02; rows[5] = 0x04; rows[6] = 0x08; break;
-        case ' ': rows[0] = 0x00; rows[1] = 0x00; rows[2] = 0x00; rows[3] = 0x00; rows[4] = 0x00; rows[5] = 0x00; rows[6] = 0x00; break;
-        default:  rows[0] = 0x1F; rows[1] = 0x01; rows[2] = 0x02; rows[3] = 0x04; rows[4] = 0x04; rows[5] = 0x00; rows[6] = 0x04; break;
+        tof_canvas_t canvas = {
+            .px = s_canvas_px,
+            .x0 = x0,
+            .y0 = sy,
+            .x1 = x1,
+            .y1 = ((sy + rows - 1) < y1) ? (sy + rows - 1) : y1,
+        };
+        s_canvas = &canvas;
+        draw(ctx);
+        s_canvas = NULL;
+        display_hal_blit_rect(canvas.x0, canvas.y0, canvas.x1, canvas.y1, s_canvas_px);
     }
 }
 
-static void tof_brand_draw_char5x7_scaled_clipped(int32_t x,
-                                                   int32_t y,
-                                                   char ch,
-                                                   uint16_t color,
-                                                   uint32_t scale,
-                                                   int32_t clip_x0,
-                                                   int32_t clip_y0,
-                                                   int32_t clip_x1,
-                                                   int32_t clip_y1)
+static void tof_text_render(int32_t x0,
+                            int32_t y0,
+                            int32_t x1,
+                            int32_t y1,
+                            tof_canvas_draw_fn_t draw,
+                            const void *ctx)
 {
-    if (scale == 0u)
-    {
+#if TOF_TEXT_LINE_RENDER
+    tof_canvas_render(x0, y0, x1, y1, draw, ctx);
+#else
+    (void)x0;
+    (void)y0;
+    (void)x1;
+    (void)y1;
+    draw(ctx);
+#endif
+}
+
+/* Draw a glyph given as row masks of `bits` pixels (leftmost pixel in the
+ * MSB, at most 8), each mask pixel covering xscale x yscale screen pixels.
+ * Into a canvas the lit runs are filled straight into the strip; otherwise
+ * each lit mask pixel is one panel fill.
+ */
+static void tof_draw_glyph_mask(int32_t x,
+                                int32_t y,
+                                const uint8_t *rows,
+                                uint32_t h,
+                                uint32_t bits,
+                                uint32_t xscale,
+                                uint32_t yscale,
+                                uint16_t color,
+                                int32_t clip_x0,
+                                int32_t clip_y0,
+                                int32_t clip_x1,
+                                int32_t clip_y1)
+{
+    const tof_canvas_t *c = s_canvas;
+    if (c != NULL)
+    {
+        int32_t cx0 = (clip_x0 > c->x0) ? clip_x0 : c->x0;
+        int32_t cy0 = (clip_y0 > c->y0) ? clip_y0 : c->y0;
+        int32_t cx1 = (clip_x1 < c->x1) ? clip_x1 : c->x1;
+        int32_t cy1 = (clip_y1 < c->y1) ? clip_y1 : c->y1;
+        const int32_t gx1 = x + (int32_t)(bits * xscale) - 1;
+        const int32_t gy1 = y + (int32_t)(h * yscale) - 1;
+        cx0 = (x > cx0) ? x : cx0;
+        cy0 = (y > cy0) ? y : cy0;
+        cx1 = (gx1 < cx1) ? gx1 : cx1;
+        cy1 = (gy1 < cy1) ? gy1 : cy1;
+        if (cx1 < cx0 || cy1 < cy0)
+        {
+            return;
+        }
+
+        /* Expand each mask row once into clipped runs of lit pixels (four
+         * at most in 8 bits), then fill them on every screen row it covers.
+         */
+        const int32_t stride = (c->x1 - c->x0) + 1;
+        const uint32_t ry0 = (uint32_t)(cy0 - y) / yscale;
+        const uint32_t ry1 = (uint32_t)(cy1 - y) / yscale;
+        for (uint32_t ry = ry0; ry <= ry1; ry++)
+        {
+            const uint32_t row = rows[ry];
+            int32_t span_x0[4];
+            int32_t span_x1[4];
+            uint32_t spans = 0u;
+            uint32_t bit = 0u;
+            while (bit < bits && spans < 4u)
+            {
+                if (((row >> (bits - 1u - bit)) & 0x1u) == 0u)
+                {
+                    bit++;
+                    continue;
+                }
+                const uint32_t first = bit;
+                while (bit < bits && ((row >> (bits - 1u - bit)) & 0x1u) != 0u)
+                {
+                    bit++;
+                }
+                int32_t sx0 = x + (int32_t)(first * xscale);
+                int32_t sx1 = x + (int32_t)(bit * xscale) - 1;
+                sx0 = (sx0 > cx0) ? sx0 : cx0;
+                sx1 = (sx1 < cx1) ? sx1 : cx1;
+                if (sx0 <= sx1)
+                {
+                    span_x0[spans] = sx0 - c->x0;
+                    span_x1[spans] = sx1 - c->x0;
+                    spans++;
+                }
+            }
+            if (spans == 0u)
+            {
+                continue;
+            }
+
+            int32_t py0 = y + (int32_t)(ry * yscale);
+            int32_t py1 = py0 + (int32_t)yscale - 1;
+            py0 = (py0 > cy0) ? py0 : cy0;
+            py1 = (py1 < cy1) ? py1 : cy1;
+            for (int32_t py = py0; py <= py1; py++)
+            {
+                uint16_t *line = &c->px[(py - c->y0) * stride];
+                for (uint32_t i = 0u; i < spans; i++)
+                {
+                    for (int32_t px = span_x0[i]; px <= span_x1[i]; px++)
+                    {
+                        line[px] = color;
+                    }
+                }
+            }
+        }
         return;
     }
 
-    uint8_t rows[7];
-    tof_brand_get_glyph_5x7(ch, rows);
-    for (uint32_t ry = 0u; ry < 7u; ry++)
+    for (uint32_t ry = 0u; ry < h; ry++)
     {
-        for (uint32_t rx = 0u; rx < 5u; rx++)
+        for (uint32_t rx = 0u; rx < bits; rx++)
         {
-            if (((rows[ry] >> (4u - rx)) & 0x1u) == 0u)
+            if (((rows[ry] >> (bits - 1u - rx)) & 0x1u) == 0u)
             {
                 continue;
             }
 
-            const int32_t px0 = x + (int32_t)(rx * scale);
-            const int32_t py0 = y + (int32_t)(ry * scale);
-            const int32_t px1 = px0 + (int32_t)scale - 1;
-            const int32_t py1 = py0 + (int32_t)scale - 1;
+            const int32_t px0 = x + (int32_t)(rx * xscale);
+            const int32_t py0 = y + (int32_t)(ry * yscale);
+            const int32_t px1 = px0 + (int32_t)xscale - 1;
+            const int32_t py1 = py0 + (int32_t)yscale - 1;
             if (px1 < clip_x0 || px0 > clip_x1 || py1 < clip_y0 || py0 > clip_y1)
             {
                 continue;
@@ -666,6 +1120,24 @@ static void tof_brand_draw_char5x7_scaled_clipped(int32_t x,
     }
 }
 
+static void tof_brand_draw_char5x7_scaled_clipped(int32_t x,
+                                                   int32_t y,
+                                                   char ch,
+                                                   uint16_t color,
+                                                   uint32_t scale,
+                                                   int32_t clip_x0,
+                                                   int32_t clip_y0,
+                                                   int32_t clip_x1,
+                                                   int32_t clip_y1)
+{
+    if (scale == 0u)
+    {
+        return;
+    }
+
+    tof_draw_glyph_mask(x, y, g_tof_font5x7[tof_font_index(ch)], 7u, 5u, scale, scale, color, clip_x0, clip_y0, clip_x1, clip_y1);
+}
+
 static void tof_tiny_draw_char_clipped(int32_t x,
                                        int32_t y,
                                        char ch,
@@ -693,29 +1165,26 @@ static void tof_tiny_draw_char_scaled_clipped(int32_t x,
         return;
     }
 
+    const uint32_t idx = tof_font_index(ch);
     uint8_t rows[TOF_DBG_CHAR_H];
-    tof_dbg_get_glyph(ch, rows);
-
-    for (uint32_t ry = 0u; ry < TOF_DBG_CHAR_H; ry++)
+    if (TOF_FONT_PRESCALED_2X && (scale == 2u) && (s_canvas != NULL))
     {
-        for (uint32_t rx = 0u; rx < TOF_DBG_CHAR_W; rx++)
+        /* Rows already doubled horizontally; only the row repeat is left. */
+        const uint32_t g = g_tof_font3x5_x2[idx];
+        for (uint32_t ry = 0u; ry < TOF_DBG_CHAR_H; ry++)
         {
-            if (((rows[ry] >> (TOF_DBG_CHAR_W - 1u - rx)) & 0x1u) == 0u)
-            {
-                continue;
-            }
-
-            const int32_t px0 = x + (int32_t)(rx * scale);
-            const int32_t py0 = y + (int32_t)(ry * scale);
-            const int32_t px1 = px0 + (int32_t)scale - 1;
-            const int32_t py1 = py0 + (int32_t)scale - 1;
-            if (px1 < clip_x0 || px0 > clip_x1 || py1 < clip_y0 || py0 > clip_y1)
-            {
-                continue;
-            }
-            display_hal_fill_rect(px0, py0, px1, py1, color);
+            rows[ry] = (uint8_t)((g >> (6u * (TOF_DBG_CHAR_H - 1u - ry))) & 0x3Fu);
         }
+        tof_draw_glyph_mask(x, y, rows, TOF_DBG_CHAR_H, 2u * TOF_DBG_CHAR_W, 1u, 2u, color, clip_x0, clip_y0, clip_x1, clip_y1);
+        return;
+    }
+
+    const uint32_t g = g_tof_font3x5[idx];
+    for (uint32_t ry = 0u; ry < TOF_DBG_CHAR_H; ry++)
+    {
+        rows[ry] = (uint8_t)((g >> (3u * (TOF_DBG_CHAR_H - 1u - ry))) & 0x7u);
     }
+    tof_draw_glyph_mask(x, y, rows, TOF_DBG_CHAR_H, TOF_DBG_CHAR_W, scale, scale, color, clip_x0, clip_y0, clip_x1, clip_y1);
 }
 
 static void tof_dbg_draw_char(int32_t x, int32_t y, char ch, uint16_t color)
@@ -723,45 +1192,30 @@ static void tof_dbg_draw_char(int32_t x, int32_t y, char ch, uint16_t color)
     tof_tiny_draw_char_clipped(x, y, ch, color, s_dbg_x0, s_dbg_y0, s_dbg_x1, s_dbg_y1);
 }
 
-static void tof_draw_brand_mark(void)
+typedef struct
 {
-    static bool s_brand_drawn = false;
-    if (!s_tp_force_redraw && s_brand_drawn)
-    {
-        return;
-    }
+    const char *text;
+    size_t n;
+    int32_t y;
+    uint16_t color;
+} tof_dbg_line_t;
 
-    const uint16_t fg = pack_rgb565(255u, 255u, 255u);
-    const char *name = "(C)RICHARD HABERKERN";
-    const size_t n = strlen(name);
-    const int32_t scale = 1;
-    const int32_t brand_char_w = 5;
-    const int32_t brand_char_h = 7;
-    const int32_t char_adv = (brand_char_w * scale) + 1;
-    const int32_t text_w = (n > 0u) ? ((int32_t)(n * char_adv) - 1) : 0;
-    const int32_t text_h = brand_char_h * scale;
-    const int32_t margin = 4;
-    const int32_t mark_w = text_w;
-    const int32_t mark_h = text_h;
-
-    int32_t x1 = TOF_TP_X1 - margin;
-    int32_t y0 = TOF_TP_Y0 + margin;
-    int32_t x0 = x1 - mark_w + 1;
-    int32_t y1 = y0 + mark_h - 1;
-    x0 = tof_clamp_i32(x0, TOF_TP_X0, TOF_TP_X1);
-    y0 = tof_clamp_i32(y0, TOF_TP_Y0, TOF_TP_Y1);
-    x1 = tof_clamp_i32(x1, TOF_TP_X0, TOF_TP_X1);
-    y1 = tof_clamp_i32(y1, TOF_TP_Y0, TOF_TP_Y1);
+static void tof_dbg_line_draw(const void *ctx)
+{
+    const tof_dbg_line_t *l = (const tof_dbg_line_t *)ctx;
+    const int32_t line_h = (TOF_DBG_CHAR_H * TOF_DBG_SCALE);
+    tof_canvas_fill_rect(s_dbg_x0 + 2, l->y, s_dbg_x1 - 2, l->y + line_h, s_ui_dbg_bg);
 
-    int32_t tx = x0;
-    const int32_t ty = y0;
-    for (size_t i = 0u; i < n; i++)
+    int32_t x = s_dbg_x0 + 4;
+    for (size_t i = 0u; i < l->n; i++)
     {
-        tof_brand_draw_char5x7_scaled_clipped(tx, ty, name[i], fg, (uint32_t)scale, x0, y0, x1, y1);
-        tx += char_adv;
+        if ((x + (TOF_DBG_CHAR_W * TOF_DBG_SCALE)) > (s_dbg_x1 - 2))
+        {
+            break;
+        }
+        tof_dbg_draw_char(x, l->y, l->text[i], l->color);
+        x += TOF_DBG_CHAR_ADV;
     }
-
-    s_brand_drawn = true;
 }
 
 static void tof_dbg_draw_line(uint32_t line_idx, const char *text, uint16_t color)
@@ -789,18 +1243,8 @@ static void tof_dbg_draw_line(uint32_t line_idx, const char *text, uint16_t colo
 
     const int32_t y = s_dbg_y0 + 3 + (int32_t)(line_idx * TOF_DBG_LINE_H);
     const int32_t line_h = (TOF_DBG_CHAR_H * TOF_DBG_SCALE);
-    display_hal_fill_rect(s_dbg_x0 + 2, y, s_dbg_x1 - 2, y + line_h, s_ui_dbg_bg);
-
-    int32_t x = s_dbg_x0 + 4;
-    for (size_t i = 0u; i < n; i++)
-    {
-        if ((x + (TOF_DBG_CHAR_W * TOF_DBG_SCALE)) > (s_dbg_x1 - 2))
-        {
-            break;
-        }
-        tof_dbg_draw_char(x, y, clipped[i], color);
-        x += TOF_DBG_CHAR_ADV;
-    }
+    const tof_dbg_line_t line = {.text = clipped, .n = n, .y = y, .color = color};
+    tof_text_render(s_dbg_x0 + 2, y, s_dbg_x1 - 2, y + line_h, tof_dbg_line_draw, &line);
 }
 
 static uint8_t tof_roll_segments_from_fullness_q10(uint32_t fullness_q10)
@@ -983,43 +1427,67 @@ static const char *tof_roll_popup_message(tof_roll_alert_level_t level)
     return "ROLL STATUS";
 }
 
-static void tof_draw_ai_pill(bool ai_on)
+typedef struct
 {
-    if (!s_dbg_force_redraw && s_ai_pill_prev_valid && (s_ai_pill_prev_on == ai_on))
-    {
-        return;
-    }
-
-    const uint16_t bg = ai_on ? pack_rgb565(22u, 86u, 46u) : pack_rgb565(92u, 22u, 24u);
-    const uint16_t border = ai_on ? pack_rgb565(120u, 210u, 140u) : pack_rgb565(220u, 120u, 120u);
-    const uint16_t fg = pack_rgb565(238u, 242u, 246u);
+    int32_t x0;
+    int32_t y0;
+    int32_t x1;
+    int32_t y1;
+    uint16_t bg;
+    uint16_t border;
+    uint16_t fg;
+    const char *label;
+} tof_pill_t;
+
+static void tof_pill_draw(const void *ctx)
+{
+    const tof_pill_t *p = (const tof_pill_t *)ctx;
 
-    display_hal_fill_rect(s_ai_pill_x0, s_ai_pill_y0, s_ai_pill_x1, s_ai_pill_y1, bg);
-    display_hal_fill_rect(s_ai_pill_x0, s_ai_pill_y0, s_ai_pill_x1, s_ai_pill_y0, border);
-    display_hal_fill_rect(s_ai_pill_x0, s_ai_pill_y1, s_ai_pill_x1, s_ai_pill_y1, border);
-    display_hal_fill_rect(s_ai_pill_x0, s_ai_pill_y0, s_ai_pill_x0, s_ai_pill_y1, border);
-    display_hal_fill_rect(s_ai_pill_x1, s_ai_pill_y0, s_ai_pill_x1, s_ai_pill_y1, border);
+    tof_canvas_fill_rect(p->x0, p->y0, p->x1, p->y1, p->bg);
+    tof_canvas_fill_rect(p->x0, p->y0, p->x1, p->y0, p->border);
+    tof_canvas_fill_rect(p->x0, p->y1, p->x1, p->y1, p->border);
+    tof_canvas_fill_rect(p->x0, p->y0, p->x0, p->y1, p->border);
+    tof_canvas_fill_rect(p->x1, p->y0, p->x1, p->y1, p->border);
 
-    const char *label = ai_on ? "AI ON" : "AI OFF";
-    const size_t n = strlen(label);
+    const size_t n = strlen(p->label);
     const int32_t text_w = (n > 0u) ? ((int32_t)(n * TOF_DBG_CHAR_ADV) - 2) : 0;
     const int32_t text_h = TOF_DBG_CHAR_H * TOF_DBG_SCALE;
-    int32_t x = s_ai_pill_x0 + ((s_ai_pill_x1 - s_ai_pill_x0 + 1 - text_w) / 2);
-    int32_t y = s_ai_pill_y0 + ((s_ai_pill_y1 - s_ai_pill_y0 + 1 - text_h) / 2);
-    if (x < (s_ai_pill_x0 + 2))
+    int32_t x = p->x0 + ((p->x1 - p->x0 + 1 - text_w) / 2);
+    int32_t y = p->y0 + ((p->y1 - p->y0 + 1 - text_h) / 2);
+    if (x < (p->x0 + 2))
+    {
+        x = p->x0 + 2;
+    }
+    if (y < (p->y0 + 1))
     {
-        x = s_ai_pill_x0 + 2;
+        y = p->y0 + 1;
     }
-    if (y < (s_ai_pill_y0 + 1))
+
+    for (size_t i = 0u; i < n; i++)
+    {
+        tof_tiny_draw_char_clipped(x, y, p->label[i], p->fg, p->x0, p->y0, p->x1, p->y1);
+        x += TOF_DBG_CHAR_ADV;
+    }
+}
+
+static void tof_draw_ai_pill(bool ai_on)
+{
+    if (!s_dbg_force_redraw && s_ai_pill_prev_valid && (s_ai_pill_prev_on == ai_on))
     {
-        y = s_ai_pill_y0 + 1;
+        return;
     }
 
-    for (size_t i = 0u; i < n; i++)
-    {
-        tof_dbg_draw_char(x, y, label[i], fg);
-        x += TOF_DBG_CHAR_ADV;
-    }
+    const tof_pill_t pill = {
+        .x0 = s_ai_pill_x0,
+        .y0 = s_ai_pill_y0,
+        .x1 = s_ai_pill_x1,
+        .y1 = s_ai_pill_y1,
+        .bg = ai_on ? pack_rgb565(22u, 86u, 46u) : pack_rgb565(92u, 22u, 24u),
+        .border = ai_on ? pack_rgb565(120u, 210u, 140u) : pack_rgb565(220u, 120u, 120u),
+        .fg = pack_rgb565(238u, 242u, 246u),
+        .label = ai_on ? "AI ON" : "AI OFF",
+    };
+    tof_text_render(pill.x0, pill.y0, pill.x1, pill.y1, tof_pill_draw, &pill);
 
     s_ai_pill_prev_valid = true;
     s_ai_pill_prev_on = ai_on;
@@ -1032,36 +1500,17 @@ static void tof_draw_alert_pill(bool alert_on)
         return;
     }
 
-    const uint16_t bg = alert_on ? pack_rgb565(78u, 62u, 18u) : pack_rgb565(48u, 26u, 18u);
-    const uint16_t border = alert_on ? pack_rgb565(232u, 198u, 98u) : pack_rgb565(202u, 128u, 104u);
-    const uint16_t fg = pack_rgb565(246u, 238u, 218u);
-    const char *label = alert_on ? "ALERT ON" : "ALERT OFF";
-
-    display_hal_fill_rect(s_alert_pill_x0, s_alert_pill_y0, s_alert_pill_x1, s_alert_pill_y1, bg);
-    display_hal_fill_rect(s_alert_pill_x0, s_alert_pill_y0, s_alert_pill_x1, s_alert_pill_y0, border);
-    display_hal_fill_rect(s_alert_pill_x0, s_alert_pill_y1, s_alert_pill_x1, s_alert_pill_y1, border);
-    display_hal_fill_rect(s_alert_pill_x0, s_alert_pill_y0, s_alert_pill_x0, s_alert_pill_y1, border);
-    display_hal_fill_rect(s_alert_pill_x1, s_alert_pill_y0, s_alert_pill_x1, s_alert_pill_y1, border);
-
-    const size_t n = strlen(label);
-    const int32_t text_w = (n > 0u) ? ((int32_t)(n * TOF_DBG_CHAR_ADV) - 2) : 0;
-    const int32_t text_h = TOF_DBG_CHAR_H * TOF_DBG_SCALE;
-    int32_t x = s_alert_pill_x0 + ((s_alert_pill_x1 - s_alert_pill_x0 + 1 - text_w) / 2);
-    int32_t y = s_alert_pill_y0 + ((s_alert_pill_y1 - s_alert_pill_y0 + 1 - text_h) / 2);
-    if (x < (s_alert_pill_x0 + 2))
-    {
-        x = s_alert_pill_x0 + 2;
-    }
-    if (y < (s_alert_pill_y0 + 1))
-    {
-        y = s_alert_pill_y0 + 1;
-    }
-
-    for (size_t i = 0u; i < n; i++)
-    {
-        tof_tiny_draw_char_clipped(x, y, label[i], fg, s_alert_pill_x0, s_alert_pill_y0, s_alert_pill_x1, s_alert_pill_y1);
-        x += TOF_DBG_CHAR_ADV;
-    }
+    const tof_pill_t pill = {
+        .x0 = s_alert_pill_x0,
+        .y0 = s_alert_pill_y0,
+        .x1 = s_alert_pill_x1,
+        .y1 = s_alert_pill_y1,
+        .bg = alert_on ? pack_rgb565(78u, 62u, 18u) : pack_rgb565(48u, 26u, 18u),
+        .border = alert_on ? pack_rgb565(232u, 198u, 98u) : pack_rgb565(202u, 128u, 104u),
+        .fg = pack_rgb565(246u, 238u, 218u),
+        .label = alert_on ? "ALERT ON" : "ALERT OFF",
+    };
+    tof_text_render(pill.x0, pill.y0, pill.x1, pill.y1, tof_pill_draw, &pill);
 
     s_alert_pill_prev_valid = true;
     s_alert_pill_prev_on = alert_on;
@@ -1123,6 +1572,7 @@ static void tof_scrub_left_panel(bool force_debug_redraw)
         const tof_cell_rect_t *c = &s_cells[i];
         display_hal_fill_rect(c->x0, c->y0, c->x1, c->y1, s_ui_border);
         display_hal_fill_rect(c->ix0, c->iy0, c->ix1, c->iy1, s_ui_bg);
+        s_cell_outline[i] = s_ui_border;
     }
 
     memset(s_cell_drawn, 0, sizeof(s_cell_drawn));
@@ -1166,24 +1616,23 @@ static void tof_clear_roll_status_popup(bool live_data)
     s_alert_popup_prev_drawn = false;
 }
 
-static void tof_draw_roll_status_popup(bool live_data, tof_roll_alert_level_t level)
+typedef struct
 {
-    int32_t x0 = 0;
-    int32_t y0 = 0;
-    int32_t x1 = 0;
-    int32_t y1 = 0;
-    tof_alert_popup_rect(&x0, &y0, &x1, &y1);
-    if (x1 < x0 || y1 < y0)
-    {
-        return;
-    }
-
-    if (s_alert_popup_prev_drawn &&
-        (s_alert_popup_prev_x0 != x0 || s_alert_popup_prev_y0 != y0 ||
-         s_alert_popup_prev_x1 != x1 || s_alert_popup_prev_y1 != y1))
-    {
-        tof_clear_roll_status_popup(live_data);
-    }
+    int32_t x0;
+    int32_t y0;
+    int32_t x1;
+    int32_t y1;
+    tof_roll_alert_level_t level;
+} tof_roll_popup_t;
+
+static void tof_roll_status_popup_draw(const void *ctx)
+{
+    const tof_roll_popup_t *p = (const tof_roll_popup_t *)ctx;
+    const int32_t x0 = p->x0;
+    const int32_t y0 = p->y0;
+    const int32_t x1 = p->x1;
+    const int32_t y1 = p->y1;
+    const tof_roll_alert_level_t level = p->level;
 
     const char *subtitle = (level == kTofRollAlertEmpty) ? "ROLL EMPTY" : "ROLL LOW";
     const char *fallback = tof_roll_popup_message(level);
@@ -1214,10 +1663,10 @@ static void tof_draw_roll_status_popup(bool live_data, tof_roll_alert_level_t le
         sub_fg = pack_rgb565(252u, 240u, 190u);
     }
 
-    display_hal_fill_rect(x0, y0, x1, y1, frame_color);
+    tof_canvas_fill_rect(x0, y0, x1, y1, frame_color);
     if ((x1 - x0) >= 2 && (y1 - y0) >= 2)
     {
-        display_hal_fill_rect(x0 + 1, y0 + 1, x1 - 1, y1 - 1, panel_bg);
+        tof_canvas_fill_rect(x0 + 1, y0 + 1, x1 - 1, y1 - 1, panel_bg);
     }
 
     const int32_t ix0 = x0 + 1;
@@ -1389,6 +1838,29 @@ static void tof_draw_roll_status_popup(bool live_data, tof_roll_alert_level_t le
             tx += TOF_DBG_CHAR_ADV;
         }
     }
+}
+
+static void tof_draw_roll_status_popup(bool live_data, tof_roll_alert_level_t level)
+{
+    int32_t x0 = 0;
+    int32_t y0 = 0;
+    int32_t x1 = 0;
+    int32_t y1 = 0;
+    tof_alert_popup_rect(&x0, &y0, &x1, &y1);
+    if (x1 < x0 || y1 < y0)
+    {
+        return;
+    }
+
+    if (s_alert_popup_prev_drawn &&
+        (s_alert_popup_prev_x0 != x0 || s_alert_popup_prev_y0 != y0 ||
+         s_alert_popup_prev_x1 != x1 || s_alert_popup_prev_y1 != y1))
+    {
+        tof_clear_roll_status_popup(live_data);
+    }
+
+    const tof_roll_popup_t popup = {.x0 = x0, .y0 = y0, .x1 = x1, .y1 = y1, .level = level};
+    tof_text_render(x0, y0, x1, y1, tof_roll_status_popup_draw, &popup);
 
     s_alert_popup_prev_drawn = true;
     s_alert_popup_prev_level = level;
@@ -1580,7 +2052,10 @@ static status_t tof_touch_i2c_send(uint8_t deviceAddress,
     xfer.subaddressSize = subaddressSize;
     xfer.data = (uint8_t *)(uintptr_t)txBuff;
     xfer.dataSize = txBuffSize;
-    return LPI2C_MasterTransferBlocking(TOF_TOUCH_I2C, &xfer);
+    tmf8828_quick_bus_lock();
+    const status_t st = LPI2C_MasterTransferBlocking(TOF_TOUCH_I2C, &xfer);
+    tmf8828_quick_bus_unlock();
+    return st;
 }
 
 static status_t tof_touch_i2c_receive(uint8_t deviceAddress,
@@ -1598,7 +2073,10 @@ static status_t tof_touch_i2c_receive(uint8_t deviceAddress,
     xfer.subaddressSize = subaddressSize;
     xfer.data = rxBuff;
     xfer.dataSize = rxBuffSize;
-    return LPI2C_MasterTransferBlocking(TOF_TOUCH_I2C, &xfer);
+    tmf8828_quick_bus_lock();
+    const status_t st = LPI2C_MasterTransferBlocking(TOF_TOUCH_I2C, &xfer);
+    tmf8828_quick_bus_unlock();
+    return st;
 }
 
 static void tof_touch_config_int_pin(gt911_int_pin_mode_t mode)
@@ -1777,120 +2255,77 @@ static void tof_touch_poll_ai_toggle(uint32_t tick)
     s_touch_was_down = pressed;
 }
 
-static void tof_calc_frame_stats(const uint16_t mm[64],
-                                 uint32_t *valid_count,
-                                 uint16_t *min_mm,
-                                 uint16_t *max_mm,
-                                 uint16_t *avg_mm)
-{
-    uint32_t valid = 0u;
-    uint32_t sum = 0u;
-    uint16_t min_v = 0xFFFFu;
-    uint16_t max_v = 0u;
-
-    for (uint32_t i = 0u; i < 64u; i++)
-    {
-        const uint16_t v = mm[i];
-        if (!tof_mm_valid(v))
-        {
-            continue;
-        }
-        valid++;
-        sum += v;
-        if (v < min_v)
-        {
-            min_v = v;
-        }
-        if (v > max_v)
-        {
-            max_v = v;
-        }
-    }
+/* Processed (denoised, hole-filled) view of the input frame. The heatmap
+ * path publishes it once per frame sequence and later readers share it, so
+ * the stateful denoiser advances exactly once per input frame.
+ */
+static uint16_t s_processed_mm[64];
+static tof_frame_summary_t s_processed_summary;
 
-    if (valid_count) *valid_count = valid;
-    if (min_mm) *min_mm = (valid > 0u) ? min_v : 0u;
-    if (max_mm) *max_mm = (valid > 0u) ? max_v : 0u;
-    if (avg_mm) *avg_mm = (valid > 0u) ? (uint16_t)(sum / valid) : 0u;
+static void tof_processed_frame_publish(const uint16_t mm[64])
+{
+    memcpy(s_processed_mm, mm, sizeof(s_processed_mm));
+    tof_frame_summary_build(s_processed_mm, &s_processed_summary);
 }
 
-static const uint16_t *tof_calc_metric_frame(const uint16_t mm[64], bool live_data)
+/* Summary of the frame for the debug metrics: the processed frame of this
+ * sequence, else the input frame when nothing was drawn for it or
+ * processing left too few valid zones. The frame itself is summary->mm.
+ *
+ * The processed frame is whatever the heatmap path denoised. In raw draw
+ * mode that is the input frame, as before. In incremental mode it is the
+ * EMA-smoothed s_display_mm, so the debug metrics (avg, curve, closest and
+ * the actual-distance pick) lag the input the way the heatmap does. The
+ * baseline denoised the raw input here, which stepped the temporal filter a
+ * second time per frame. The spool model and estimator still read the raw
+ * input through tof_frame_summary().
+ */
+static const tof_frame_summary_t *tof_calc_metric_summary(const uint16_t mm[64], bool live_data)
 {
-    if (!live_data)
+    if (live_data && s_processed_summary.mm != NULL && s_processed_summary.seq == s_frame_seq &&
+        s_processed_summary.valid_count >= TOF_EST_VALID_MIN)
     {
-        return mm;
+        return &s_processed_summary;
     }
 
-    static uint16_t metric_mm[64];
-    uint16_t repaired_mm[64];
-    tof_ai_denoise_heatmap_frame(mm, metric_mm, live_data);
-    tof_fill_display_holes(metric_mm, repaired_mm);
-    memcpy(metric_mm, repaired_mm, sizeof(repaired_mm));
-    tof_repair_corner_blindspots(metric_mm);
+    return tof_frame_summary(mm);
+}
 
-    uint32_t filtered_valid = 0u;
-    tof_calc_frame_stats(metric_mm, &filtered_valid, NULL, NULL, NULL);
-    if (filtered_valid >= TOF_EST_VALID_MIN)
+static uint16_t tof_calc_actual_distance_mm(const tof_frame_summary_t *s)
+{
+    /* Closest zone inside the tracked range, else the closest zone. */
+    if (s->min_mm >= s_range_near_mm && s->min_mm <= s_range_far_mm)
     {
-        return metric_mm;
+        return s->min_mm;
     }
 
-    return mm;
-}
-
-static uint16_t tof_calc_actual_distance_mm(const uint16_t mm[64])
-{
+    /* Rows whose minimum is in range answer directly; only rows with a
+     * zone nearer than the range need scanning.
+     */
     uint16_t closest_in_range = 0xFFFFu;
-    uint16_t closest_any = 0xFFFFu;
-
-    for (uint32_t i = 0u; i < 64u; i++)
+    for (uint32_t y = 0u; y < TOF_GRID_H; y++)
     {
-        const uint16_t v = mm[i];
-        if (!tof_mm_valid(v))
+        const uint16_t row_min = s->row_min_mm[y];
+        if (row_min == 0u || row_min > s_range_far_mm || row_min >= closest_in_range)
         {
             continue;
         }
-
-        if (v < closest_any)
-        {
-            closest_any = v;
-        }
-
-        if (v >= s_range_near_mm && v <= s_range_far_mm && v < closest_in_range)
-        {
-            closest_in_range = v;
-        }
-    }
-
-    if (closest_in_range != 0xFFFFu)
-    {
-        return closest_in_range;
-    }
-
-    if (closest_any != 0xFFFFu)
-    {
-        return closest_any;
-    }
-
-    return 0u;
-}
-
-static uint16_t tof_calc_closest_valid_mm(const uint16_t mm[64])
-{
-    uint16_t closest = 0xFFFFu;
-    for (uint32_t i = 0u; i < 64u; i++)
-    {
-        const uint16_t v = mm[i];
-        if (!tof_mm_valid(v))
+        if (row_min >= s_range_near_mm)
         {
+            closest_in_range = row_min;
             continue;
         }
-        if (v < closest)
+        for (uint32_t i = y * TOF_GRID_W; i < ((y + 1u) * TOF_GRID_W); i++)
         {
-            closest = v;
+            const uint16_t v = s->mm[i];
+            if (tof_mm_valid(v) && v >= s_range_near_mm && v <= s_range_far_mm && v < closest_in_range)
+            {
+                closest_in_range = v;
+            }
         }
     }
 
-    return (closest == 0xFFFFu) ? 0u : closest;
+    return (closest_in_range != 0xFFFFu) ? closest_in_range : s->min_mm;
 }
 
 static uint16_t tof_apply_tp_mm_shift(uint16_t mm)
@@ -1939,8 +2374,27 @@ static uint16_t tof_apply_tp_mm_calibration(uint16_t mm)
     return tof_apply_tp_mm_gain(tof_apply_tp_mm_shift(mm));
 }
 
-static uint16_t tof_calc_roll_curve_distance_mm(const uint16_t mm[64], int16_t row_pick_idx_out[TOF_GRID_H])
+/* Inverse of tof_apply_tp_mm_calibration (up to rounding and the clip range). */
+static uint16_t tof_tp_mm_to_sensor_mm(uint16_t mm)
+{
+    if (mm == 0u)
+    {
+        return 0u;
+    }
+
+    int32_t sensor = (int32_t)mm;
+    if (mm > TOF_TP_MM_FULL_NEAR)
+    {
+        const uint32_t delta = (uint32_t)(mm - TOF_TP_MM_FULL_NEAR);
+        sensor = (int32_t)TOF_TP_MM_FULL_NEAR + (int32_t)(((delta << 8) + (TOF_TP_MM_GAIN_Q8 / 2u)) / TOF_TP_MM_GAIN_Q8);
+    }
+    sensor -= TOF_TP_MM_SHIFT;
+    return (sensor > 0) ? (uint16_t)sensor : 0u;
+}
+
+static uint16_t tof_calc_roll_curve_distance_mm(const tof_frame_summary_t *s, int16_t row_pick_idx_out[TOF_GRID_H])
 {
+    const uint16_t *mm = s->mm;
     uint16_t row_near_mm[TOF_GRID_H];
     uint32_t row_count = 0u;
 
@@ -1954,6 +2408,11 @@ static uint16_t tof_calc_roll_curve_distance_mm(const uint16_t mm[64], int16_t r
 
     for (uint32_t y = 0u; y < TOF_GRID_H; y++)
     {
+        if (s->row_min_mm[y] == 0u)
+        {
+            continue;
+        }
+
         uint16_t low0 = 0xFFFFu;
         uint16_t low1 = 0xFFFFu;
         int32_t low0_idx = -1;
@@ -1970,7 +2429,7 @@ static uint16_t tof_calc_roll_curve_distance_mm(const uint16_t mm[64], int16_t r
         for (uint32_t x = x_start; x < x_end; x++)
         {
             const uint16_t v = mm[row_base + x];
-            if (!tof_mm_valid(v))
+            if (!tof_mm_valid(v) || tof_zone_weight_q8(row_base + x) < TOF_CONF_PICK_MIN_Q8)
             {
                 continue;
             }
@@ -2074,93 +2533,182 @@ static uint32_t tof_tp_fullness_q10_from_mm_q8_bounds(uint32_t mm_q8, uint16_t n
     return ((far_q8 - mm_q8) * 1024u) / (far_q8 - near_q8);
 }
 
-static bool tof_estimator_measure_mm_q8(const uint16_t mm[64],
-                                        uint32_t *mm_q8_out,
-                                        uint32_t *valid_out,
-                                        uint16_t *spread_out)
+/* Trimmed-mean histogram: valid zones binned into 128 mm buckets with
+ * per-bucket weighted sums. Only the buckets holding the two trim cuts are
+ * resolved zone by zone, so the trimmed mean costs O(zones + buckets)
+ * instead of a sort. Rebuilt from the frame summary on every estimator run;
+ * static only to keep it off the stack.
+ */
+#define TOF_TRIM_BUCKET_SHIFT 7u
+#define TOF_TRIM_BUCKETS      ((12000u >> TOF_TRIM_BUCKET_SHIFT) + 1u)
+
+typedef struct
 {
-    uint16_t values[64];
-    uint32_t count = 0u;
-    uint32_t center_sum = 0u;
-    uint32_t center_count = 0u;
-    uint16_t min_mm = 0xFFFFu;
-    uint16_t max_mm = 0u;
+    uint16_t zone_mm[64]; /* value binned per zone, 0 when not counted */
+    uint16_t zone_w[64];
+    uint8_t count[TOF_TRIM_BUCKETS];
+    uint32_t sum[TOF_TRIM_BUCKETS]; /* mm * weight */
+    uint32_t wsum[TOF_TRIM_BUCKETS];
+    uint32_t total;
+} tof_trim_hist_t;
 
-    for (uint32_t y = 0u; y < TOF_GRID_H; y++)
+static tof_trim_hist_t s_trim_hist;
+
+static void tof_trim_hist_build(tof_trim_hist_t *h, const tof_frame_summary_t *s)
+{
+    memset(h, 0, sizeof(*h));
+    for (uint32_t idx = 0u; idx < 64u; idx++)
     {
-        for (uint32_t x = 0u; x < TOF_GRID_W; x++)
+        if ((s->valid_mask & ((uint64_t)1u << idx)) == 0u)
         {
-            const uint16_t v = mm[(y * TOF_GRID_W) + x];
-            if (!tof_mm_valid(v))
-            {
-                continue;
-            }
-
-            values[count++] = v;
-            if (v < min_mm)
-            {
-                min_mm = v;
-            }
-            if (v > max_mm)
-            {
-                max_mm = v;
-            }
-            if ((x >= 2u && x <= 5u) && (y >= 2u && y <= 5u))
-            {
-                center_sum += v;
-                center_count++;
-            }
+            continue;
         }
+
+        const uint16_t v = s->mm[idx];
+        const uint16_t w = (uint16_t)tof_zone_weight_q8(idx);
+        const uint32_t b = (uint32_t)v >> TOF_TRIM_BUCKET_SHIFT;
+        h->count[b]++;
+        h->sum[b] += (uint32_t)v * w;
+        h->wsum[b] += w;
+        h->total++;
+        h->zone_mm[idx] = v;
+        h->zone_w[idx] = w;
+    }
+}
+
+/* Value of sorted rank k (0-based) and how many zones sort strictly below it. */
+static uint16_t tof_trim_hist_rank(const tof_trim_hist_t *h, uint32_t k, uint32_t *below_out)
+{
+    uint32_t b = 0u;
+    uint32_t below = 0u;
+    while ((below + h->count[b]) <= k)
+    {
+        below += h->count[b];
+        b++;
     }
 
-    if (valid_out)
+    uint8_t fine[1u << TOF_TRIM_BUCKET_SHIFT];
+    memset(fine, 0, sizeof(fine));
+    for (uint32_t idx = 0u; idx < 64u; idx++)
     {
-        *valid_out = count;
+        const uint16_t v = h->zone_mm[idx];
+        if (v != 0u && ((uint32_t)v >> TOF_TRIM_BUCKET_SHIFT) == b)
+        {
+            fine[v & ((1u << TOF_TRIM_BUCKET_SHIFT) - 1u)]++;
+        }
     }
-    if (spread_out)
+
+    uint32_t f = 0u;
+    while ((below + fine[f]) <= k)
     {
-        *spread_out = (count > 0u) ? (uint16_t)(max_mm - min_mm) : 0u;
+        below += fine[f];
+        f++;
     }
 
-    if (count < TOF_EST_VALID_MIN)
+    *below_out = below;
+    return (uint16_t)((b << TOF_TRIM_BUCKET_SHIFT) | f);
+}
+
+/* Weighted sums over sorted ranks [trim, total - trim). Ties at a cut are
+ * split in zone order, as a stable sort of the zones would split them.
+ */
+static void tof_trim_hist_mean(const tof_trim_hist_t *h, uint32_t trim, uint32_t *sum_out, uint32_t *wsum_out)
+{
+    const uint32_t keep_end = h->total - trim;
+    uint32_t lo_below = 0u;
+    uint32_t hi_below = 0u;
+    const uint16_t lo = tof_trim_hist_rank(h, trim, &lo_below);
+    const uint16_t hi = tof_trim_hist_rank(h, keep_end - 1u, &hi_below);
+    const uint32_t lo_b = (uint32_t)lo >> TOF_TRIM_BUCKET_SHIFT;
+    const uint32_t hi_b = (uint32_t)hi >> TOF_TRIM_BUCKET_SHIFT;
+
+    uint32_t sum = 0u;
+    uint32_t wsum = 0u;
+    for (uint32_t b = lo_b + 1u; b < hi_b; b++)
     {
-        return false;
+        sum += h->sum[b];
+        wsum += h->wsum[b];
     }
 
-    for (uint32_t i = 1u; i < count; i++)
+    uint32_t lo_rank = lo_below;
+    uint32_t hi_rank = hi_below;
+    for (uint32_t idx = 0u; idx < 64u; idx++)
     {
-        uint16_t key = values[i];
-        int32_t j = (int32_t)i - 1;
-        while (j >= 0 && values[(uint32_t)j] > key)
+        const uint16_t v = h->zone_mm[idx];
+        const uint32_t b = (uint32_t)v >> TOF_TRIM_BUCKET_SHIFT;
+        if (v == 0u || (b != lo_b && b != hi_b) || v < lo || v > hi)
         {
-            values[(uint32_t)j + 1u] = values[(uint32_t)j];
-            j--;
+            continue;
+        }
+
+        uint32_t rank = trim;
+        if (v == lo)
+        {
+            rank = lo_rank++;
+        }
+        else if (v == hi)
+        {
+            rank = hi_rank++;
+        }
+        if (rank >= trim && rank < keep_end)
+        {
+            sum += (uint32_t)v * h->zone_w[idx];
+            wsum += h->zone_w[idx];
         }
-        values[(uint32_t)j + 1u] = key;
     }
 
-    uint32_t trim = count / 8u;
-    if ((trim * 2u) >= count)
+    *sum_out = sum;
+    *wsum_out = wsum;
+}
+
+static bool tof_estimator_measure_mm_q8(const tof_frame_summary_t *s, uint32_t *mm_q8_out)
+{
+    if (s->valid_count < TOF_EST_VALID_MIN)
+    {
+        return false;
+    }
+
+    tof_trim_hist_build(&s_trim_hist, s);
+
+    uint32_t trim = s->valid_count / 8u;
+    if ((trim * 2u) >= s->valid_count)
     {
         trim = 0u;
     }
 
+    /* Confidence-weighted trimmed mean; equals the plain trimmed mean when
+     * all weights are equal.
+     */
     uint32_t sum = 0u;
-    uint32_t keep = 0u;
-    for (uint32_t i = trim; i < (count - trim); i++)
+    uint32_t wsum = 0u;
+    tof_trim_hist_mean(&s_trim_hist, trim, &sum, &wsum);
+    if (wsum == 0u)
     {
-        sum += values[i];
-        keep++;
+        return false;
     }
-    if (keep == 0u)
+
+    uint32_t center_sum = 0u;
+    uint32_t center_wsum = 0u;
+    uint32_t center_count = 0u;
+    for (uint32_t y = 2u; y <= 5u; y++)
     {
-        return false;
+        for (uint32_t x = 2u; x <= 5u; x++)
+        {
+            const uint32_t idx = (y * TOF_GRID_W) + x;
+            const uint16_t v = s_trim_hist.zone_mm[idx];
+            if (v != 0u)
+            {
+                center_sum += (uint32_t)v * s_trim_hist.zone_w[idx];
+                center_wsum += s_trim_hist.zone_w[idx];
+                center_count++;
+            }
+        }
     }
 
-    uint32_t mean_mm = (sum + (keep / 2u)) / keep;
+    uint32_t mean_mm = (sum + (wsum / 2u)) / wsum;
     if (center_count >= 4u)
     {
-        const uint32_t center_mm = (center_sum + (center_count / 2u)) / center_count;
+        const uint32_t center_mm = (center_sum + (center_wsum / 2u)) / center_wsum;
         mean_mm = (((mean_mm * 3u) + (center_mm * 2u)) + 2u) / 5u;
     }
 
@@ -2171,8 +2719,10 @@ static bool tof_estimator_measure_mm_q8(const uint16_t mm[64],
     return true;
 }
 
-static uint16_t tof_estimator_confidence_q10(uint32_t valid_count, uint16_t spread_mm, bool live_data)
+static uint16_t tof_estimator_confidence_q10(const tof_frame_summary_t *s, bool live_data)
 {
+    const uint32_t valid_count = s->valid_count;
+    const uint16_t spread_mm = tof_frame_summary_spread_mm(s);
     uint32_t valid_q10 = 0u;
     uint32_t spread_q10 = 0u;
 
@@ -2201,6 +2751,13 @@ static uint16_t tof_estimator_confidence_q10(uint32_t valid_count, uint16_t spre
     }
 
     uint32_t conf = (valid_q10 + spread_q10) / 2u;
+#if TOF_CONF_WEIGHTING
+    if (live_data && s_zone_conf_live)
+    {
+        /* Measured signal confidence carries half of the score. */
+        conf = (conf + tof_signal_conf_q10(s)) / 2u;
+    }
+#endif
     if (!live_data)
     {
         conf = (conf * 3u) / 4u;
@@ -2212,19 +2769,17 @@ static uint16_t tof_estimator_confidence_q10(uint32_t valid_count, uint16_t spre
     return (uint16_t)conf;
 }
 
-static TOF_UNUSED void tof_estimator_update(const uint16_t mm[64], bool live_data)
+static TOF_UNUSED void tof_estimator_update(const tof_frame_summary_t *s, bool live_data)
 {
 #if TOF_EST_ENABLE
     uint32_t measured_mm_q8 = 0u;
-    uint32_t valid_count = 0u;
-    uint16_t spread_mm = 0u;
-    const bool have_meas = tof_estimator_measure_mm_q8(mm, &measured_mm_q8, &valid_count, &spread_mm);
+    const bool have_meas = tof_estimator_measure_mm_q8(s, &measured_mm_q8);
 
     if (have_meas)
     {
-        const uint16_t conf_q10 = tof_estimator_confidence_q10(valid_count, spread_mm, live_data);
-        s_est_valid_count = valid_count;
-        s_est_spread_mm = spread_mm;
+        const uint16_t conf_q10 = tof_estimator_confidence_q10(s, live_data);
+        s_est_valid_count = s->valid_count;
+        s_est_spread_mm = tof_frame_summary_spread_mm(s);
         s_est_conf_q10 = conf_q10;
 
         if (s_est_mm_q8 == 0u)
@@ -2314,53 +2869,12 @@ static TOF_UNUSED void tof_estimator_update(const uint16_t mm[64], bool live_dat
         s_est_conf_q10 = (uint16_t)(((uint32_t)s_est_conf_q10 * 15u) / 16u);
     }
 #else
-    (void)mm;
+    (void)s;
     (void)live_data;
 #endif
 }
 
-static TOF_UNUSED void tof_ai_region_means(const uint16_t mm[64], uint16_t *center_avg, uint16_t *edge_avg)
-{
-    uint32_t center_sum = 0u;
-    uint32_t center_count = 0u;
-    uint32_t edge_sum = 0u;
-    uint32_t edge_count = 0u;
-
-    for (uint32_t y = 0u; y < TOF_GRID_H; y++)
-    {
-        for (uint32_t x = 0u; x < TOF_GRID_W; x++)
-        {
-            const uint16_t v = mm[(y * TOF_GRID_W) + x];
-            if (!tof_mm_valid(v))
-            {
-                continue;
-            }
-
-            if ((x >= 2u && x <= 5u) && (y >= 2u && y <= 5u))
-            {
-                center_sum += v;
-                center_count++;
-            }
-
-            if (x == 0u || x == (TOF_GRID_W - 1u) || y == 0u || y == (TOF_GRID_H - 1u))
-            {
-                edge_sum += v;
-                edge_count++;
-            }
-        }
-    }
-
-    if (center_avg)
-    {
-        *center_avg = (center_count > 0u) ? (uint16_t)(center_sum / center_count) : 0u;
-    }
-    if (edge_avg)
-    {
-        *edge_avg = (edge_count > 0u) ? (uint16_t)(edge_sum / edge_count) : 0u;
-    }
-}
-
-static void tof_ai_log_frame(const uint16_t mm[64], bool live_data, uint32_t tick, uint32_t fullness_q10)
+static void tof_ai_log_frame(const tof_frame_summary_t *s, bool live_data, uint32_t tick, uint32_t fullness_q10)
 {
 #if TOF_AI_DATA_LOG_ENABLE
     if (!live_data)
@@ -2374,25 +2888,18 @@ static void tof_ai_log_frame(const uint16_t mm[64], bool live_data, uint32_t tic
     }
     s_ai_log_last_tick = tick;
 
-    uint32_t valid = 0u;
-    uint16_t min_mm = 0u;
-    uint16_t max_mm = 0u;
-    uint16_t avg_mm = 0u;
-    uint16_t center_avg = 0u;
-    uint16_t edge_avg = 0u;
-    const uint16_t actual_mm = tof_calc_actual_distance_mm(mm);
-
-    tof_calc_frame_stats(mm, &valid, &min_mm, &max_mm, &avg_mm);
-    tof_ai_region_means(mm, &center_avg, &edge_avg);
+    const uint16_t actual_mm = tof_calc_actual_distance_mm(s);
+    const uint16_t center_avg = (s->center_count > 0u) ? (uint16_t)(s->center_sum / s->center_count) : 0u;
+    const uint16_t edge_avg = (s->edge_count > 0u) ? (uint16_t)(s->edge_sum / s->edge_count) : 0u;
 
     PRINTF("AI_CSV,t=%u,ai=%u,live=%u,valid=%u,min=%u,max=%u,avg=%u,act=%u,center=%u,edge=%u,full_q10=%u\r\n",
            (unsigned)tick,
            (unsigned)(s_ai_runtime_on ? 1u : 0u),
            1u,
-           (unsigned)valid,
-           (unsigned)min_mm,
-           (unsigned)max_mm,
-           (unsigned)avg_mm,
+           (unsigned)s->valid_count,
+           (unsigned)s->min_mm,
+           (unsigned)s->max_mm,
+           (unsigned)tof_frame_summary_avg_mm(s),
            (unsigned)actual_mm,
            (unsigned)center_avg,
            (unsigned)edge_avg,
@@ -2402,18 +2909,47 @@ static void tof_ai_log_frame(const uint16_t mm[64], bool live_data, uint32_t tic
     PRINTF("AI_F64,t=%u", (unsigned)tick);
     for (uint32_t i = 0u; i < 64u; i++)
     {
-        PRINTF(",%u", (unsigned)mm[i]);
+        PRINTF(",%u", (unsigned)s->mm[i]);
     }
     PRINTF("\r\n");
 #endif
 #else
-    (void)mm;
+    (void)s;
     (void)live_data;
     (void)tick;
     (void)fullness_q10;
 #endif
 }
 
+/* Incremental ellipse span generator. For |y| = 0..ry it yields
+ * floor(rx * floor(sqrt(ry^2 - y^2)) / ry), the same half widths the old
+ * isqrt-per-row code produced, using only adds and compares: r tracks the
+ * integer root as ry^2 - y^2 shrinks and (xw, rem) track rx * r / ry.
+ */
+typedef struct
+{
+    int32_t rx;
+    int32_t ry;
+    int32_t y;
+    int32_t t;
+    int32_t r;
+    int32_t r2;
+    int32_t xw;
+    int32_t rem;
+} tof_ellipse_spans_t;
+
+static void tof_ellipse_spans_init(tof_ellipse_spans_t *e, int32_t rx, int32_t ry)
+{
+    e->rx = rx;
+    e->ry = ry;
+    e->y = 0;
+    e->t = ry * ry;
+    e->r = ry;
+    e->r2 = ry * ry;
+    e->xw = rx;
+    e->rem = 0;
+}
+
 static uint32_t tof_isqrt_u32(uint32_t n)
 {
     uint32_t op = n;
@@ -2424,7 +2960,6 @@ static uint32_t tof_isqrt_u32(uint32_t n)
     {
         one >>= 2;
     }
-
     while (one != 0u)
     {
         if (op >= (res + one))
@@ -2434,53 +2969,197 @@ static uint32_t tof_isqrt_u32(uint32_t n)
         }
         else
         {
-            res >>= 1;
+            res >>= 1;
+        }
+        one >>= 2;
+    }
+    return res;
+}
+
+/* Move the generator to |y| = y_abs, setting the state next() would have
+ * reached stepping there from 0: one root instead of y_abs steps.
+ */
+static void tof_ellipse_spans_seek(tof_ellipse_spans_t *e, int32_t y_abs)
+{
+    e->y = y_abs;
+    e->t = (e->ry * e->ry) - (y_abs * y_abs);
+    e->r = (e->t > 0) ? (int32_t)tof_isqrt_u32((uint32_t)e->t) : 0;
+    e->r2 = e->r * e->r;
+    e->xw = (e->rx * e->r) / e->ry;
+    e->rem = (e->rx * e->r) - (e->xw * e->ry);
+}
+
+/* Half width at the current |y|; then advance to |y| + 1. */
+static int32_t tof_ellipse_spans_next(tof_ellipse_spans_t *e)
+{
+    const int32_t xw = e->xw;
+
+    e->t -= (2 * e->y) + 1;
+    e->y++;
+    while (e->r > 0 && e->r2 > e->t)
+    {
+        e->r2 -= (2 * e->r) - 1;
+        e->r--;
+        e->rem -= e->rx;
+        while (e->rem < 0)
+        {
+            e->rem += e->ry;
+            e->xw--;
         }
-        one >>= 2;
     }
+    return xw;
+}
 
-    return res;
+/* Rows of the TP area the current target can receive. */
+static void tof_canvas_rows(int32_t *y0, int32_t *y1)
+{
+    *y0 = TOF_TP_Y0;
+    *y1 = TOF_TP_Y1;
+    if (s_canvas != NULL)
+    {
+        *y0 = (s_canvas->y0 > *y0) ? s_canvas->y0 : *y0;
+        *y1 = (s_canvas->y1 < *y1) ? s_canvas->y1 : *y1;
+    }
 }
 
-static int32_t tof_ellipse_half_width(int32_t rx, int32_t ry, int32_t y_abs)
+/* The |y| range around centre row cy that lands in rows y0..y1; lo > hi
+ * when none does.
+ */
+static void tof_ellipse_abs_rows(int32_t cy, int32_t y0, int32_t y1, int32_t *lo, int32_t *hi)
 {
-    if (rx <= 0 || ry <= 0 || y_abs >= ry)
+    if (y0 > cy)
+    {
+        *lo = y0 - cy;
+        *hi = y1 - cy;
+    }
+    else if (y1 < cy)
+    {
+        *lo = cy - y1;
+        *hi = cy - y0;
+    }
+    else
     {
-        return 0;
+        *lo = 0;
+        *hi = ((y1 - cy) > (cy - y0)) ? (y1 - cy) : (cy - y0);
     }
+}
 
-    const uint32_t ry_u = (uint32_t)ry;
-    const uint32_t y_u = (uint32_t)y_abs;
-    const uint32_t term = (ry_u * ry_u) - (y_u * y_u);
-    const uint32_t root = tof_isqrt_u32(term);
-    return (int32_t)(((uint64_t)(uint32_t)rx * (uint64_t)root) / (uint64_t)ry_u);
+static void tof_fill_tp_row_span(int32_t x0, int32_t x1, int32_t py, uint16_t color)
+{
+    if (x1 >= x0)
+    {
+        tof_canvas_fill_rect(x0, py, x1, py, color);
+    }
 }
 
-static void tof_draw_filled_ellipse(int32_t cx, int32_t cy, int32_t rx, int32_t ry, uint16_t color)
+/* Draw the outer ellipse as ring spans around the inner one. With
+ * fill_inner the inner spans are painted in fill_color, giving exactly the
+ * pixels of "outer filled, then inner filled" with no pixel written twice;
+ * without it the hole is left untouched (annulus). inner_ry <= 0 draws a
+ * plain filled ellipse.
+ */
+static void tof_draw_ellipse_spans(int32_t cx,
+                                   int32_t cy,
+                                   int32_t outer_rx,
+                                   int32_t outer_ry,
+                                   int32_t inner_rx,
+                                   int32_t inner_ry,
+                                   uint16_t ring_color,
+                                   uint16_t fill_color,
+                                   bool fill_inner)
 {
-    if (rx <= 0 || ry <= 0)
+    if (outer_rx <= 0 || outer_ry <= 0)
+    {
+        return;
+    }
+    const bool has_inner = (inner_rx > 0 && inner_ry > 0);
+
+    int32_t clip_y0 = 0;
+    int32_t clip_y1 = 0;
+    tof_canvas_rows(&clip_y0, &clip_y1);
+
+    /* Replayed per strip, so start at the first |y| the strip can show
+     * rather than at the middle row.
+     */
+    int32_t y_lo = 0;
+    int32_t y_hi = 0;
+    tof_ellipse_abs_rows(cy, clip_y0, clip_y1, &y_lo, &y_hi);
+    y_hi = (y_hi < outer_ry) ? y_hi : outer_ry;
+    if (y_lo > y_hi)
     {
         return;
     }
 
-    for (int32_t y = -ry; y <= ry; y++)
+    tof_ellipse_spans_t outer;
+    tof_ellipse_spans_t inner;
+    tof_ellipse_spans_init(&outer, outer_rx, outer_ry);
+    tof_ellipse_spans_init(&inner, inner_rx, inner_ry);
+    tof_ellipse_spans_seek(&outer, y_lo);
+    if (has_inner && (y_lo <= inner_ry))
     {
-        const int32_t y_abs = (y < 0) ? -y : y;
-        const int32_t xw = tof_ellipse_half_width(rx, ry, y_abs);
-        const int32_t py = cy + y;
-        if (py < TOF_TP_Y0 || py > TOF_TP_Y1)
+        tof_ellipse_spans_seek(&inner, y_lo);
+    }
+
+    for (int32_t y = y_lo; y <= y_hi; y++)
+    {
+        const int32_t xo = tof_ellipse_spans_next(&outer);
+        const bool row_inner = has_inner && (y <= inner_ry);
+        const int32_t xi = row_inner ? tof_ellipse_spans_next(&inner) : 0;
+
+        const int32_t ox0 = tof_clamp_i32(cx - xo, TOF_TP_X0, TOF_TP_X1);
+        const int32_t ox1 = tof_clamp_i32(cx + xo, TOF_TP_X0, TOF_TP_X1);
+        const int32_t ix0 = tof_clamp_i32(cx - xi, TOF_TP_X0, TOF_TP_X1);
+        const int32_t ix1 = tof_clamp_i32(cx + xi, TOF_TP_X0, TOF_TP_X1);
+
+        for (int32_t side = 0; side < ((y == 0) ? 1 : 2); side++)
         {
-            continue;
+            const int32_t py = (side == 0) ? (cy + y) : (cy - y);
+            if (py < clip_y0 || py > clip_y1)
+            {
+                continue;
+            }
+
+            if (!row_inner)
+            {
+                tof_fill_tp_row_span(ox0, ox1, py, ring_color);
+                continue;
+            }
+            tof_fill_tp_row_span(ox0, (ox1 < (ix0 - 1)) ? ox1 : (ix0 - 1), py, ring_color);
+            tof_fill_tp_row_span((ox0 > (ix1 + 1)) ? ox0 : (ix1 + 1), ox1, py, ring_color);
+            if (fill_inner)
+            {
+                tof_fill_tp_row_span(ix0, ix1, py, fill_color);
+            }
         }
+    }
+}
+
+static void tof_draw_filled_ellipse(int32_t cx, int32_t cy, int32_t rx, int32_t ry, uint16_t color)
+{
+    tof_draw_ellipse_spans(cx, cy, rx, ry, 0, 0, color, color, false);
+}
 
-        int32_t x0 = cx - xw;
-        int32_t x1 = cx + xw;
-        x0 = tof_clamp_i32(x0, TOF_TP_X0, TOF_TP_X1);
-        x1 = tof_clamp_i32(x1, TOF_TP_X0, TOF_TP_X1);
-        if (x1 >= x0)
+/* Fill out[y_lo..y_hi] with the half widths at those |y|, 0 past ry. */
+static void tof_ellipse_half_widths(int32_t rx, int32_t ry, int16_t *out, int32_t y_lo, int32_t y_hi)
+{
+    if (rx <= 0 || ry <= 0)
+    {
+        for (int32_t y = y_lo; y <= y_hi; y++)
         {
-            display_hal_fill_rect(x0, py, x1, py, color);
+            out[y] = 0;
         }
+        return;
+    }
+
+    tof_ellipse_spans_t e;
+    tof_ellipse_spans_init(&e, rx, ry);
+    if (y_lo <= ry)
+    {
+        tof_ellipse_spans_seek(&e, y_lo);
+    }
+    for (int32_t y = y_lo; y <= y_hi; y++)
+    {
+        out[y] = (y <= ry) ? (int16_t)tof_ellipse_spans_next(&e) : 0;
     }
 }
 
@@ -2529,7 +3208,7 @@ static void tof_tp_fill_bg_rect(int32_t x0, int32_t y0, int32_t x1, int32_t y1,
         }
 
         const uint32_t t = (uint32_t)((band * 255) / (bands - 1));
-        display_hal_fill_rect(x0, iy0, x1, iy1, tof_tp_bg_color(t, live_data));
+        tof_canvas_fill_rect(x0, iy0, x1, iy1, tof_tp_bg_color(t, live_data));
     }
 }
 
@@ -2589,13 +3268,39 @@ static void tof_draw_ellipse_ring(int32_t cx,
         return;
     }
 
-    tof_draw_filled_ellipse(cx, cy, outer_rx, outer_ry, ring_color);
-    const int32_t inner_rx = outer_rx - thickness;
-    const int32_t inner_ry = outer_ry - thickness;
-    if (inner_rx > 0 && inner_ry > 0)
+    tof_draw_ellipse_spans(cx,
+                           cy,
+                           outer_rx,
+                           outer_ry,
+                           outer_rx - thickness,
+                           outer_ry - thickness,
+                           ring_color,
+                           fill_color,
+                           true);
+}
+
+/* Ring only; whatever is inside the inner ellipse stays as drawn. */
+static void tof_draw_ellipse_annulus(int32_t cx,
+                                     int32_t cy,
+                                     int32_t outer_rx,
+                                     int32_t outer_ry,
+                                     int32_t thickness,
+                                     uint16_t ring_color)
+{
+    if (outer_rx <= 0 || outer_ry <= 0 || thickness <= 0)
     {
-        tof_draw_filled_ellipse(cx, cy, inner_rx, inner_ry, fill_color);
+        return;
     }
+
+    tof_draw_ellipse_spans(cx,
+                           cy,
+                           outer_rx,
+                           outer_ry,
+                           outer_rx - thickness,
+                           outer_ry - thickness,
+                           ring_color,
+                           ring_color,
+                           false);
 }
 
 static void tof_draw_spoked_flange_face(int32_t cx,
@@ -2622,7 +3327,6 @@ static void tof_draw_spoked_flange_face(int32_t cx,
         return;
     }
 
-    tof_draw_filled_ellipse(cx, cy, flange_rx, flange_ry, flange_color);
     tof_draw_ellipse_ring(cx, cy, flange_rx, flange_ry, 2, spoke_color, flange_color);
 
     if (fill_steps > TOF_ROLL_SEGMENT_COUNT)
@@ -2904,6 +3608,527 @@ static void tof_draw_fullness_bar(uint32_t fullness_q10, uint32_t mm_q8, bool li
     (void)mm_q8;
 }
 
+typedef struct
+{
+    int32_t center_x;
+    int32_t depth;
+    int32_t cy;
+    int32_t roll_bottom;
+    int32_t back_cx;
+    int32_t front_cx;
+    int32_t flange_rx;
+    int32_t flange_ry;
+    int32_t hub_outer_rx;
+    int32_t hub_outer_ry;
+    int32_t bore_rx;
+    int32_t bore_ry;
+    int32_t filament_rx;
+    int32_t filament_ry;
+    int32_t roll_x0;
+    int32_t roll_y0;
+    int32_t roll_x1;
+    int32_t roll_y1;
+    bool has_filament;
+    bool render_live;
+    uint8_t bar_segments;
+} tof_roll_scene_t;
+
+/* Paint the whole roll rect back to front. Every span goes through
+ * tof_canvas_fill_rect, so the same scene can be replayed per strip.
+ */
+static void tof_draw_roll_scene(const tof_roll_scene_t *sc)
+{
+    tof_tp_fill_bg_rect(sc->roll_x0, sc->roll_y0, sc->roll_x1, sc->roll_y1, sc->render_live);
+
+    const int32_t shadow_y = tof_clamp_i32(sc->cy + sc->flange_ry + 2, TOF_TP_Y0, sc->roll_bottom + 2);
+    tof_draw_filled_ellipse(sc->center_x + (sc->depth / 8),
+                            shadow_y,
+                            sc->flange_rx + (sc->depth / 5),
+                            tof_clamp_i32(sc->flange_ry / 16, 2, 6),
+                            pack_rgb565(8u, 8u, 10u));
+    tof_draw_filled_ellipse(sc->center_x + (sc->depth / 10),
+                            shadow_y - 1,
+                            sc->flange_rx + (sc->depth / 7),
+                            tof_clamp_i32(sc->flange_ry / 20, 2, 4),
+                            pack_rgb565(14u, 14u, 18u));
+
+    if (sc->has_filament)
+    {
+        /* Draw 2px red filament bands with 1px gray separator.
+         * Separator is intentionally thin (1/3 of a 3px separator baseline). */
+        int32_t clip_y0 = 0;
+        int32_t clip_y1 = 0;
+        tof_canvas_rows(&clip_y0, &clip_y1);
+        /* Only the bands whose three rows reach this strip, and only their
+         * half widths.
+         */
+        int32_t abs_lo = 0;
+        int32_t abs_hi = 0;
+        tof_ellipse_abs_rows(sc->cy, clip_y0 - 2, clip_y1, &abs_lo, &abs_hi);
+        abs_hi = (abs_hi < (TOF_LCD_H - 1)) ? abs_hi : (TOF_LCD_H - 1);
+        int16_t band_xw[TOF_LCD_H];
+        tof_ellipse_half_widths(sc->filament_rx, sc->filament_ry, band_xw, abs_lo, abs_hi);
+
+        const int32_t skip = (clip_y0 - 2) - sc->cy + sc->filament_ry;
+        const int32_t band_y0 = -sc->filament_ry + ((skip > 0) ? (((skip + 2) / 3) * 3) : 0);
+        const int32_t band_y1 = ((clip_y1 - sc->cy) < sc->filament_ry) ? (clip_y1 - sc->cy) : sc->filament_ry;
+        for (int32_t y = band_y0; y <= band_y1; y += 3)
+        {
+            const int32_t y_abs = (y < 0) ? -y : y;
+            const int32_t py = sc->cy + y;
+            int32_t py1 = py + 1;
+            if (py1 > TOF_TP_Y1)
+            {
+                py1 = TOF_TP_Y1;
+            }
+            if (py < TOF_TP_Y0 || py > TOF_TP_Y1)
+            {
+                continue;
+            }
+            if ((py + 2) < clip_y0 || py > clip_y1)
+            {
+                continue;
+            }
+
+            const int32_t xw = (y_abs < TOF_LCD_H) ? band_xw[y_abs] : 0;
+            int32_t x0 = sc->back_cx - xw + 1;
+            int32_t x1 = sc->front_cx + xw - 1;
+            x0 = tof_clamp_i32(x0, TOF_TP_X0, TOF_TP_X1);
+            x1 = tof_clamp_i32(x1, TOF_TP_X0, TOF_TP_X1);
+            if (x1 < x0)
+            {
+                continue;
+            }
+
+            const int32_t tone = 168 + (((sc->filament_ry - y_abs) * 44) / tof_clamp_i32(sc->filament_ry, 1, 1024));
+            tof_canvas_fill_rect(x0, py, x1, py1, tof_spool_filament_color(tone, sc->render_live));
+
+            const int32_t gy = py1 + 1;
+            if (gy >= TOF_TP_Y0 && gy <= TOF_TP_Y1)
+            {
+                const int32_t gap_tone = tone - 24;
+                tof_canvas_fill_rect(x0, gy, x1, gy, tof_tp_filament_gap_color(gap_tone, sc->render_live));
+            }
+        }
+    }
+
+    const uint16_t back_base = tof_tp_core_color(154, sc->render_live);
+    tof_draw_ellipse_ring(sc->back_cx,
+                          sc->cy,
+                          sc->flange_rx,
+                          sc->flange_ry,
+                          2,
+                          tof_tp_core_color(118, sc->render_live),
+                          back_base);
+    if (sc->has_filament && (sc->filament_rx > (sc->hub_outer_rx + 1)) && (sc->filament_ry > (sc->hub_outer_ry + 1)))
+    {
+        tof_draw_ellipse_ring(sc->back_cx,
+                              sc->cy,
+                              sc->filament_rx - 1,
+                              sc->filament_ry - 1,
+                              2,
+                              tof_spool_filament_color(80, sc->render_live),
+                              tof_spool_filament_color(138, sc->render_live));
+    }
+    tof_draw_spoked_flange_face(sc->back_cx,
+                                sc->cy,
+                                sc->flange_rx,
+                                sc->flange_ry,
+                                sc->hub_outer_rx,
+                                sc->hub_outer_ry,
+                                sc->bore_rx,
+                                sc->bore_ry,
+                                sc->filament_rx,
+                                sc->filament_ry,
+                                back_base,
+                                pack_rgb565(6u, 6u, 8u),
+                                tof_spool_filament_color(188, sc->render_live),
+                                pack_rgb565(12u, 12u, 14u),
+                                sc->bar_segments);
+
+    const uint16_t front_base = tof_tp_core_color(182, sc->render_live);
+    tof_draw_ellipse_ring(sc->front_cx,
+                          sc->cy,
+                          sc->flange_rx,
+                          sc->flange_ry,
+                          2,
+                          tof_tp_core_color(118, sc->render_live),
+                          front_base);
+
+    for (int32_t i = 0; sc->has_filament && i < 4; i++)
+    {
+        const int32_t ry_layer = sc->filament_ry - 3 - (i * 5);
+        if (ry_layer <= (sc->hub_outer_ry + 2))
+        {
+            break;
+        }
+        const int32_t rx_layer = (sc->filament_rx * ry_layer) / tof_clamp_i32(sc->filament_ry, 1, 1024);
+        const int32_t tone = 228 - (i * 16);
+        tof_draw_ellipse_annulus(sc->front_cx,
+                                 sc->cy,
+                                 rx_layer,
+                                 ry_layer,
+                                 1,
+                                 tof_spool_filament_color(tone, sc->render_live));
+    }
+
+    tof_draw_spoked_flange_face(sc->front_cx,
+                                sc->cy,
+                                sc->flange_rx,
+                                sc->flange_ry,
+                                sc->hub_outer_rx,
+                                sc->hub_outer_ry,
+                                sc->bore_rx,
+                                sc->bore_ry,
+                                sc->filament_rx,
+                                sc->filament_ry,
+                                front_base,
+                                pack_rgb565(4u, 4u, 6u),
+                                tof_spool_filament_color(208, sc->render_live),
+                                pack_rgb565(10u, 10u, 12u),
+                                sc->bar_segments);
+}
+
+#if TOF_TP_TILE_RENDER && (TOF_SPOOL_CACHE_BYTES > 0u)
+/* The scene only depends on bar_segments and render_live once the layout
+ * is fixed, so each variant is rendered once, stored as (count, colour)
+ * word pairs and later decoded strip by strip straight into the blit
+ * buffer. Runs may cross row and strip boundaries.
+ */
+#define TOF_SPOOL_CACHE_WORDS (TOF_SPOOL_CACHE_BYTES / 2u)
+#define TOF_SPOOL_SPRITE_COUNT ((TOF_ROLL_SEGMENT_COUNT + 1u) * 2u)
+
+typedef struct
+{
+    uint32_t offset;
+    uint32_t words;
+    uint32_t last_use;
+    int16_t x0;
+    int16_t y0;
+    int16_t x1;
+    int16_t y1;
+} tof_spool_sprite_t;
+
+/* Encodes at the end of the arena, from start; pos may move down while
+ * encoding as entries before it are evicted to make room.
+ */
+typedef struct
+{
+    uint32_t start;
+    uint32_t pos;
+    uint32_t words;
+    uint32_t run_len;
+    uint16_t run_color;
+} tof_rle_writer_t;
+
+typedef struct
+{
+    const uint16_t *src;
+    uint32_t left;
+    uint16_t color;
+} tof_rle_reader_t;
+
+static uint16_t s_spool_cache[TOF_SPOOL_CACHE_WORDS];
+static tof_spool_sprite_t s_spool_sprites[TOF_SPOOL_SPRITE_COUNT];
+static uint32_t s_spool_cache_used = 0u;
+static uint32_t s_spool_cache_clock = 0u;
+static uint32_t s_spool_cache_hits = 0u;
+static uint32_t s_spool_cache_misses = 0u;
+
+/* Drop victim and close the gap, moving the entries after it and the
+ * tail words being encoded past s_spool_cache_used.
+ */
+static void tof_spool_cache_evict(tof_spool_sprite_t *victim, uint32_t tail)
+{
+    const uint32_t end = victim->offset + victim->words;
+    memmove(&s_spool_cache[victim->offset], &s_spool_cache[end], ((s_spool_cache_used + tail) - end) * sizeof(uint16_t));
+    for (uint32_t i = 0u; i < TOF_SPOOL_SPRITE_COUNT; i++)
+    {
+        if (s_spool_sprites[i].words > 0u && s_spool_sprites[i].offset > victim->offset)
+        {
+            s_spool_sprites[i].offset -= victim->words;
+        }
+    }
+    s_spool_cache_used -= victim->words;
+    victim->words = 0u;
+}
+
+static tof_spool_sprite_t *tof_spool_cache_lru(void)
+{
+    tof_spool_sprite_t *victim = NULL;
+    for (uint32_t i = 0u; i < TOF_SPOOL_SPRITE_COUNT; i++)
+    {
+        tof_spool_sprite_t *e = &s_spool_sprites[i];
+        if (e->words > 0u && (victim == NULL || e->last_use < victim->last_use))
+        {
+            victim = e;
+        }
+    }
+    return victim;
+}
+
+/* Make room for the next run by evicting least recently used variants.
+ * Gives up once the variant would not fit even in an empty arena; the
+ * rest is then only counted.
+ */
+static bool tof_rle_make_room(tof_rle_writer_t *w)
+{
+    if ((w->words + 2u) > TOF_SPOOL_CACHE_WORDS)
+    {
+        return false;
+    }
+    while ((w->pos + 2u) > TOF_SPOOL_CACHE_WORDS)
+    {
+        tof_spool_sprite_t *victim = tof_spool_cache_lru();
+        if (victim == NULL)
+        {
+            return false;
+        }
+        const uint32_t freed = victim->words;
+        tof_spool_cache_evict(victim, w->pos - w->start);
+        w->start -= freed;
+        w->pos -= freed;
+    }
+    return true;
+}
+
+static void tof_rle_emit(tof_rle_writer_t *w)
+{
+    if (w->run_len == 0u)
+    {
+        return;
+    }
+    if ((w->pos - w->start) == w->words && tof_rle_make_room(w))
+    {
+        s_spool_cache[w->pos++] = (uint16_t)w->run_len;
+        s_spool_cache[w->pos++] = w->run_color;
+    }
+    w->words += 2u;
+    w->run_len = 0u;
+}
+
+static void tof_rle_write(tof_rle_writer_t *w, const uint16_t *px, uint32_t n)
+{
+    for (uint32_t i = 0u; i < n; i++)
+    {
+        if (w->run_len > 0u && (px[i] != w->run_color || w->run_len == 0xFFFFu))
+        {
+            tof_rle_emit(w);
+        }
+        w->run_color = px[i];
+        w->run_len++;
+    }
+}
+
+static void tof_rle_read(tof_rle_reader_t *r, uint16_t *dst, uint32_t n)
+{
+    while (n > 0u)
+    {
+        if (r->left == 0u)
+        {
+            r->left = r->src[0];
+            r->color = r->src[1];
+            r->src += 2;
+        }
+        uint32_t k = (r->left < n) ? r->left : n;
+        n -= k;
+        r->left -= k;
+        while (k-- > 0u)
+        {
+            *dst++ = r->color;
+        }
+    }
+}
+
+#endif
+
+/* Compose the roll rect in RAM one horizontal strip at a time and push
+ * each strip with a single blit, instead of streaming every overlapping
+ * span to the panel. With the sprite cache the strips are decoded from a
+ * stored variant when one exists; otherwise the render is recorded.
+ */
+static void tof_render_roll_scene(const tof_roll_scene_t *sc)
+{
+#if TOF_TP_TILE_RENDER
+    uint16_t *strip = s_canvas_px;
+    const int32_t x0 = tof_clamp_i32(sc->roll_x0, TOF_TP_X0, TOF_TP_X1);
+    const int32_t x1 = tof_clamp_i32(sc->roll_x1, TOF_TP_X0, TOF_TP_X1);
+    const int32_t y0 = tof_clamp_i32(sc->roll_y0, TOF_TP_Y0, TOF_TP_Y1);
+    const int32_t y1 = tof_clamp_i32(sc->roll_y1, TOF_TP_Y0, TOF_TP_Y1);
+    if (x1 < x0 || y1 < y0)
+    {
+        return;
+    }
+
+    const int32_t w = (x1 - x0) + 1;
+    const int32_t rows = (int32_t)TOF_TP_STRIP_PX / w;
+
+#if TOF_SPOOL_CACHE_BYTES > 0u
+    const uint32_t seg = (sc->bar_segments > TOF_ROLL_SEGMENT_COUNT) ? TOF_ROLL_SEGMENT_COUNT : sc->bar_segments;
+    tof_spool_sprite_t *sprite = &s_spool_sprites[(seg * 2u) + (sc->render_live ? 1u : 0u)];
+    const bool same_rect = (sprite->x0 == x0) && (sprite->y0 == y0) && (sprite->x1 == x1) && (sprite->y1 == y1);
+    sprite->last_use = ++s_spool_cache_clock;
+
+    if (sprite->words > 0u && same_rect)
+    {
+        s_spool_cache_hits++;
+        tof_rle_reader_t rd = {.src = &s_spool_cache[sprite->offset], .left = 0u, .color = 0u};
+        for (int32_t sy = y0; sy <= y1; sy += rows)
+        {
+            const int32_t sy1 = ((sy + rows - 1) < y1) ? (sy + rows - 1) : y1;
+            tof_rle_read(&rd, strip, (uint32_t)(w * ((sy1 - sy) + 1)));
+            display_hal_blit_rect(x0, sy, x1, sy1, strip);
+        }
+        return;
+    }
+
+    s_spool_cache_misses++;
+    if (sprite->words > 0u)
+    {
+        /* The layout moved under a cached variant; drop the stale copy. */
+        tof_spool_cache_evict(sprite, 0u);
+    }
+    sprite->x0 = (int16_t)x0;
+    sprite->y0 = (int16_t)y0;
+    sprite->x1 = (int16_t)x1;
+    sprite->y1 = (int16_t)y1;
+    tof_rle_writer_t wr = {
+        .start = s_spool_cache_used,
+        .pos = s_spool_cache_used,
+        .words = 0u,
+        .run_len = 0u,
+        .run_color = 0u,
+    };
+#endif
+
+    for (int32_t sy = y0; sy <= y1; sy += rows)
+    {
+        tof_canvas_t canvas = {
+            .px = strip,
+            .x0 = x0,
+            .y0 = sy,
+            .x1 = x1,
+            .y1 = ((sy + rows - 1) < y1) ? (sy + rows - 1) : y1,
+        };
+        s_canvas = &canvas;
+        tof_draw_roll_scene(sc);
+        s_canvas = NULL;
+#if TOF_SPOOL_CACHE_BYTES > 0u
+        tof_rle_write(&wr, strip, (uint32_t)(w * ((canvas.y1 - canvas.y0) + 1)));
+#endif
+        display_hal_blit_rect(canvas.x0, canvas.y0, canvas.x1, canvas.y1, strip);
+    }
+
+#if TOF_SPOOL_CACHE_BYTES > 0u
+    tof_rle_emit(&wr);
+    if ((wr.pos - wr.start) == wr.words)
+    {
+        sprite->offset = wr.start;
+        sprite->words = wr.words;
+        s_spool_cache_used += wr.words;
+    }
+#if TOF_SPOOL_CACHE_TRACE
+    PRINTF("TOF demo: spool sprite seg=%u live=%u %uB %s (cache %u/%uB hit=%u miss=%u)\r\n",
+           (unsigned)seg,
+           sc->render_live ? 1u : 0u,
+           (unsigned)(wr.words * 2u),
+           (sprite->words > 0u) ? "cached" : "skipped",
+           (unsigned)(s_spool_cache_used * 2u),
+           (unsigned)TOF_SPOOL_CACHE_BYTES,
+           (unsigned)s_spool_cache_hits,
+           (unsigned)s_spool_cache_misses);
+#endif
+#endif
+#else
+    tof_draw_roll_scene(sc);
+#endif
+}
+
+typedef struct
+{
+    const tof_roll_scene_t *scene;
+    const char *text;
+    size_t n;
+    int32_t x0;
+    int32_t y0;
+    int32_t x1;
+    int32_t y1;
+    int32_t char_adv;
+    uint32_t scale;
+    uint16_t fg;
+} tof_brand_mark_t;
+
+static void tof_brand_mark_draw(const void *ctx)
+{
+    const tof_brand_mark_t *m = (const tof_brand_mark_t *)ctx;
+    if (s_canvas != NULL)
+    {
+        /* Recompose what the panel holds under the mark, the spool-area
+         * background and the top of the roll scene where it reaches this
+         * high, so the unlit glyph pixels keep it.
+         */
+        tof_tp_fill_bg_rect(m->x0, m->y0, m->x1, m->y1, m->scene->render_live);
+        tof_draw_roll_scene(m->scene);
+    }
+
+    int32_t tx = m->x0;
+    for (size_t i = 0u; i < m->n; i++)
+    {
+        tof_brand_draw_char5x7_scaled_clipped(tx, m->y0, m->text[i], m->fg, m->scale, m->x0, m->y0, m->x1, m->y1);
+        tx += m->char_adv;
+    }
+}
+
+/* Drawn once per forced spool-area redraw, right after the roll scene sc,
+ * and left alone until the next one.
+ */
+static void tof_draw_brand_mark(const tof_roll_scene_t *sc)
+{
+    static bool s_brand_drawn = false;
+    if (!s_tp_force_redraw && s_brand_drawn)
+    {
+        return;
+    }
+
+    const uint16_t fg = pack_rgb565(255u, 255u, 255u);
+    const char *name = "(C)RICHARD HABERKERN";
+    const size_t n = strlen(name);
+    const int32_t scale = 1;
+    const int32_t brand_char_w = 5;
+    const int32_t brand_char_h = 7;
+    const int32_t char_adv = (brand_char_w * scale) + 1;
+    const int32_t text_w = (n > 0u) ? ((int32_t)(n * char_adv) - 1) : 0;
+    const int32_t text_h = brand_char_h * scale;
+    const int32_t margin = 4;
+    const int32_t mark_w = text_w;
+    const int32_t mark_h = text_h;
+
+    int32_t x1 = TOF_TP_X1 - margin;
+    int32_t y0 = TOF_TP_Y0 + margin;
+    int32_t x0 = x1 - mark_w + 1;
+    int32_t y1 = y0 + mark_h - 1;
+    x0 = tof_clamp_i32(x0, TOF_TP_X0, TOF_TP_X1);
+    y0 = tof_clamp_i32(y0, TOF_TP_Y0, TOF_TP_Y1);
+    x1 = tof_clamp_i32(x1, TOF_TP_X0, TOF_TP_X1);
+    y1 = tof_clamp_i32(y1, TOF_TP_Y0, TOF_TP_Y1);
+
+    const tof_brand_mark_t mark = {
+        .scene = sc,
+        .text = name,
+        .n = n,
+        .x0 = x0,
+        .y0 = y0,
+        .x1 = x1,
+        .y1 = y1,
+        .char_adv = char_adv,
+        .scale = (uint32_t)scale,
+        .fg = fg,
+    };
+    tof_text_render(x0, y0, x1, y1, tof_brand_mark_draw, &mark);
+
+    s_brand_drawn = true;
+}
+
 static void tof_update_spool_model(const uint16_t mm[64], bool live_data, uint32_t tick, bool draw_enable)
 {
     const bool force_now = s_tp_force_redraw && draw_enable;
@@ -2917,12 +4142,11 @@ static void tof_update_spool_model(const uint16_t mm[64], bool live_data, uint32
      * 2) detect sparse-full and hard-empty explicitly;
      * 3) smooth only after state decision to keep UI reactive.
      */
-    const uint16_t *calc_mm = mm;
-    uint32_t valid_count = 0u;
-    uint16_t avg_mm_raw = 0u;
-    tof_calc_frame_stats(calc_mm, &valid_count, NULL, NULL, &avg_mm_raw);
-    const uint16_t closest_mm_raw = tof_calc_closest_valid_mm(calc_mm);
-    const uint16_t curve_mm_raw = tof_calc_roll_curve_distance_mm(calc_mm, NULL);
+    const tof_frame_summary_t *summary = tof_frame_summary(mm);
+    const uint32_t valid_count = summary->valid_count;
+    const uint16_t avg_mm_raw = tof_frame_summary_avg_mm(summary);
+    const uint16_t closest_mm_raw = summary->min_mm;
+    const uint16_t curve_mm_raw = tof_calc_roll_curve_distance_mm(summary, NULL);
 
     const uint16_t closest_mm = tof_apply_tp_mm_calibration(closest_mm_raw);
     const uint16_t curve_mm = tof_apply_tp_mm_calibration(curve_mm_raw);
@@ -2932,7 +4156,7 @@ static void tof_update_spool_model(const uint16_t mm[64], bool live_data, uint32
     if (s_ai_runtime_on)
     {
         /* Keep estimator hot only when AI mode is enabled so AI ON can improve stability. */
-        tof_estimator_update(calc_mm, live_data);
+        tof_estimator_update(summary, live_data);
     }
 
     const bool no_surface_signal = (closest_mm == 0u) && (curve_mm == 0u) && (avg_mm == 0u);
@@ -3043,6 +4267,17 @@ static void tof_update_spool_model(const uint16_t mm[64], bool live_data, uint32
     }
     s_tp_live_actual_mm = actual_mm;
 
+    if (live_data)
+    {
+        /* Reference for the next frames' return selection: the smoothed model
+         * surface, not this frame's curve (which already follows whatever
+         * return was selected). None while the model is pinned to its forced
+         * full/empty values.
+         */
+        const bool model_forced = hard_empty_candidate || full_sparse_candidate || (s_tp_mm_q8 == 0u);
+        s_surface_ref_mm = model_forced ? 0u : tof_tp_mm_to_sensor_mm((uint16_t)((s_tp_mm_q8 + 128u) >> 8));
+    }
+
     uint32_t model_mm_q8 = s_tp_mm_q8;
 
 #if TOF_EST_ENABLE
@@ -3137,7 +4372,7 @@ static void tof_update_spool_model(const uint16_t mm[64], bool live_data, uint32
     const int32_t filament_rx = hub_outer_rx + filament_add_rx;
 
     const bool render_live = live_data || (model_mm_q8 > 0u);
-    tof_ai_log_frame(mm, render_live, tick, fullness_q10);
+    tof_ai_log_frame(summary, render_live, tick, fullness_q10);
     const bool roll_geom_changed = ((uint16_t)filament_ry != s_tp_last_outer_ry) ||
                                    ((uint16_t)filament_rx != s_tp_last_outer_rx);
     const uint32_t roll_delta_q8 = tof_abs_diff_u32(model_mm_q8, s_tp_last_roll_mm_q8);
@@ -3184,139 +4419,32 @@ static void tof_update_spool_model(const uint16_t mm[64], bool live_data, uint32
             roll_y0 = (roll_y0 < s_tp_prev_y0) ? roll_y0 : s_tp_prev_y0;
             roll_x1 = (roll_x1 > s_tp_prev_x1) ? roll_x1 : s_tp_prev_x1;
             roll_y1 = (roll_y1 > s_tp_prev_y1) ? roll_y1 : s_tp_prev_y1;
-        }
-        tof_tp_fill_bg_rect(roll_x0, roll_y0, roll_x1, roll_y1, render_live);
-
-        const int32_t shadow_y = tof_clamp_i32(cy + flange_ry + 2, TOF_TP_Y0, roll_bottom + 2);
-        tof_draw_filled_ellipse(center_x + (depth / 8),
-                                shadow_y,
-                                flange_rx + (depth / 5),
-                                tof_clamp_i32(flange_ry / 16, 2, 6),
-                                pack_rgb565(8u, 8u, 10u));
-        tof_draw_filled_ellipse(center_x + (depth / 10),
-                                shadow_y - 1,
-                                flange_rx + (depth / 7),
-                                tof_clamp_i32(flange_ry / 20, 2, 4),
-                                pack_rgb565(14u, 14u, 18u));
-
-        if (has_filament)
-        {
-            /* Draw 2px red filament bands with 1px gray separator.
-             * Separator is intentionally thin (1/3 of a 3px separator baseline). */
-            for (int32_t y = -filament_ry; y <= filament_ry; y += 3)
-            {
-                const int32_t y_abs = (y < 0) ? -y : y;
-                const int32_t py = cy + y;
-                int32_t py1 = py + 1;
-                if (py1 > TOF_TP_Y1)
-                {
-                    py1 = TOF_TP_Y1;
-                }
-                if (py < TOF_TP_Y0 || py > TOF_TP_Y1)
-                {
-                    continue;
-                }
-
-                const int32_t xw = tof_ellipse_half_width(filament_rx, filament_ry, y_abs);
-                int32_t x0 = back_cx - xw + 1;
-                int32_t x1 = front_cx + xw - 1;
-                x0 = tof_clamp_i32(x0, TOF_TP_X0, TOF_TP_X1);
-                x1 = tof_clamp_i32(x1, TOF_TP_X0, TOF_TP_X1);
-                if (x1 < x0)
-                {
-                    continue;
-                }
-
-                const int32_t tone = 168 + (((filament_ry - y_abs) * 44) / tof_clamp_i32(filament_ry, 1, 1024));
-                display_hal_fill_rect(x0, py, x1, py1, tof_spool_filament_color(tone, render_live));
-
-                const int32_t gy = py1 + 1;
-                if (gy >= TOF_TP_Y0 && gy <= TOF_TP_Y1)
-                {
-                    const int32_t gap_tone = tone - 24;
-                    display_hal_fill_rect(x0, gy, x1, gy, tof_tp_filament_gap_color(gap_tone, render_live));
-                }
-            }
-        }
-
-        const uint16_t back_base = tof_tp_core_color(154, render_live);
-        tof_draw_filled_ellipse(back_cx, cy, flange_rx, flange_ry, back_base);
-        tof_draw_ellipse_ring(back_cx,
-                              cy,
-                              flange_rx,
-                              flange_ry,
-                              2,
-                              tof_tp_core_color(118, render_live),
-                              back_base);
-        if (has_filament && (filament_rx > (hub_outer_rx + 1)) && (filament_ry > (hub_outer_ry + 1)))
-        {
-            tof_draw_ellipse_ring(back_cx,
-                                  cy,
-                                  filament_rx - 1,
-                                  filament_ry - 1,
-                                  2,
-                                  tof_spool_filament_color(80, render_live),
-                                  tof_spool_filament_color(138, render_live));
-        }
-        tof_draw_spoked_flange_face(back_cx,
-                                    cy,
-                                    flange_rx,
-                                    flange_ry,
-                                    hub_outer_rx,
-                                    hub_outer_ry,
-                                    bore_rx,
-                                    bore_ry,
-                                    filament_rx,
-                                    filament_ry,
-                                    back_base,
-                                    pack_rgb565(6u, 6u, 8u),
-                                    tof_spool_filament_color(188, render_live),
-                                    pack_rgb565(12u, 12u, 14u),
-                                    bar_segments);
-
-        const uint16_t front_base = tof_tp_core_color(182, render_live);
-        tof_draw_filled_ellipse(front_cx, cy, flange_rx, flange_ry, front_base);
-        tof_draw_ellipse_ring(front_cx,
-                              cy,
-                              flange_rx,
-                              flange_ry,
-                              2,
-                              tof_tp_core_color(118, render_live),
-                              front_base);
-
-        for (int32_t i = 0; has_filament && i < 4; i++)
-        {
-            const int32_t ry_layer = filament_ry - 3 - (i * 5);
-            if (ry_layer <= (hub_outer_ry + 2))
-            {
-                break;
-            }
-            const int32_t rx_layer = (filament_rx * ry_layer) / tof_clamp_i32(filament_ry, 1, 1024);
-            const int32_t tone = 228 - (i * 16);
-            tof_draw_ellipse_ring(front_cx,
-                                  cy,
-                                  rx_layer,
-                                  ry_layer,
-                                  1,
-                                  tof_spool_filament_color(tone, render_live),
-                                  front_base);
-        }
-
-        tof_draw_spoked_flange_face(front_cx,
-                                    cy,
-                                    flange_rx,
-                                    flange_ry,
-                                    hub_outer_rx,
-                                    hub_outer_ry,
-                                    bore_rx,
-                                    bore_ry,
-                                    filament_rx,
-                                    filament_ry,
-                                    front_base,
-                                    pack_rgb565(4u, 4u, 6u),
-                                    tof_spool_filament_color(208, render_live),
-                                    pack_rgb565(10u, 10u, 12u),
-                                    bar_segments);
+        }
+        const tof_roll_scene_t scene = {
+            .center_x = center_x,
+            .depth = depth,
+            .cy = cy,
+            .roll_bottom = roll_bottom,
+            .back_cx = back_cx,
+            .front_cx = front_cx,
+            .flange_rx = flange_rx,
+            .flange_ry = flange_ry,
+            .hub_outer_rx = hub_outer_rx,
+            .hub_outer_ry = hub_outer_ry,
+            .bore_rx = bore_rx,
+            .bore_ry = bore_ry,
+            .filament_rx = filament_rx,
+            .filament_ry = filament_ry,
+            .roll_x0 = roll_x0,
+            .roll_y0 = roll_y0,
+            .roll_x1 = roll_x1,
+            .roll_y1 = roll_y1,
+            .has_filament = has_filament,
+            .render_live = render_live,
+            .bar_segments = bar_segments,
+        };
+        tof_render_roll_scene(&scene);
+        tof_draw_brand_mark(&scene);
 
         s_tp_prev_x0 = (int16_t)tof_clamp_i32(back_cx - flange_rx - 3, TOF_TP_X0, TOF_TP_X1);
         s_tp_prev_y0 = (int16_t)tof_clamp_i32(cy - flange_ry - 3, TOF_TP_Y0, TOF_TP_Y1);
@@ -3330,7 +4458,6 @@ static void tof_update_spool_model(const uint16_t mm[64], bool live_data, uint32
     {
         tof_draw_fullness_bar(bar_fullness_draw_q10, model_mm_q8, render_live);
     }
-    tof_draw_brand_mark();
 
     s_tp_last_tick = tick;
     s_tp_last_outer_ry = (uint16_t)filament_ry;
@@ -3366,24 +4493,20 @@ static void tof_update_debug_panel(const uint16_t mm[64],
         s_alert_pill_prev_valid = false;
     }
 
-    uint32_t valid = 0u;
-    uint16_t min_mm = 0u;
-    uint16_t max_mm = 0u;
-    uint16_t avg_mm = 0u;
     uint16_t actual_mm = 0u;
     uint16_t est_mm = (uint16_t)(s_tp_mm_q8 >> 8);
     uint16_t conf_q10 = s_est_conf_q10;
     uint32_t full_q10 = s_roll_fullness_q10;
     uint16_t fullness_pct = (uint16_t)((full_q10 * 100u + 512u) / 1024u);
     uint16_t conf_pct = (uint16_t)((((uint32_t)conf_q10 * 100u) + 512u) / 1024u);
-    const uint16_t *calc_mm = tof_calc_metric_frame(mm, live_data);
-    tof_calc_frame_stats(calc_mm, &valid, &min_mm, &max_mm, &avg_mm);
+    const tof_frame_summary_t *summary = tof_calc_metric_summary(mm, live_data);
+    const uint16_t avg_mm = tof_frame_summary_avg_mm(summary);
     uint16_t curve_mm = 0u;
     if (s_ai_runtime_on)
     {
-        curve_mm = tof_calc_roll_curve_distance_mm(calc_mm, NULL);
+        curve_mm = tof_calc_roll_curve_distance_mm(summary, NULL);
     }
-    uint16_t closest_mm = tof_calc_closest_valid_mm(calc_mm);
+    const uint16_t closest_mm = summary->min_mm;
     uint16_t actual_candidates[3];
     uint32_t actual_count = 0u;
     if (avg_mm > 0u)
@@ -3440,9 +4563,6 @@ static void tof_update_debug_panel(const uint16_t mm[64],
 
     (void)stale_frames;
     (void)zero_live_frames;
-    (void)valid;
-    (void)min_mm;
-    (void)max_mm;
     tof_draw_ai_pill(s_ai_runtime_on);
 
     s_dbg_force_redraw = false;
@@ -3521,6 +4641,7 @@ static void tof_draw_outline(const tof_cell_rect_t *c, uint16_t color)
     display_hal_fill_rect(x0, y1, x1, y1, color);
     display_hal_fill_rect(x0, y0, x0, y1, color);
     display_hal_fill_rect(x1, y0, x1, y1, color);
+    s_cell_outline[c - s_cells] = color;
 }
 
 static void tof_draw_curve_pick_overlay(bool show_overlay)
@@ -3558,6 +4679,7 @@ static void tof_ui_init(void)
     s_ui_invalid = pack_rgb565(14u, 14u, 18u);
     s_ui_below_range = pack_rgb565(0u, 220u, 0u);
     s_ui_above_range = pack_rgb565(56u, 8u, 8u);
+    s_color_lut_valid = false;
     s_ui_dbg_bg = pack_rgb565(6u, 8u, 10u);
     s_ui_dbg_fg = pack_rgb565(210u, 220u, 230u);
     s_ui_dbg_dim = pack_rgb565(120u, 132u, 146u);
@@ -3575,6 +4697,7 @@ static void tof_ui_init(void)
         const tof_cell_rect_t *c = &s_cells[i];
         display_hal_fill_rect(c->x0, c->y0, c->x1, c->y1, s_ui_border);
         display_hal_fill_rect(c->ix0, c->iy0, c->ix1, c->iy1, s_ui_bg);
+        s_cell_outline[i] = s_ui_border;
     }
 
     memset(s_filtered_mm, 0, sizeof(s_filtered_mm));
@@ -3728,104 +4851,76 @@ static void tof_ai_denoise_heatmap_frame(const uint16_t in_mm[64], uint16_t out_
         return;
     }
 
-    uint32_t valid_count = 0u;
-    uint16_t min_mm = 0xFFFFu;
-    uint16_t max_mm = 0u;
-    for (uint32_t i = 0u; i < 64u; i++)
-    {
-        const uint16_t v = in_mm[i];
-        if (!tof_mm_valid(v))
-        {
-            continue;
-        }
-
-        valid_count++;
-        if (v < min_mm)
-        {
-            min_mm = v;
-        }
-        if (v > max_mm)
-        {
-            max_mm = v;
-        }
-    }
+    tof_frame_summary_t in_summary;
+    tof_frame_summary_build(in_mm, &in_summary);
+    const uint16_t outlier_threshold_mm = tof_ai_grid_outlier_threshold_mm(tof_frame_summary_spread_mm(&in_summary));
+    const uint16_t conf_q10 = tof_estimator_confidence_q10(&in_summary, live_data);
 
-    const uint16_t spread_mm = (valid_count > 0u) ? (uint16_t)(max_mm - min_mm) : 0u;
-    const uint16_t outlier_threshold_mm = tof_ai_grid_outlier_threshold_mm(spread_mm);
-    const uint16_t conf_q10 = tof_estimator_confidence_q10(valid_count, spread_mm, live_data);
+    tof_grid_nbr_frame_t nbr;
+    uint16_t nbr_median[64];
+    uint8_t nbr_count[64];
+    tof_grid_nbr_load(&nbr, in_mm, in_summary.valid_mask);
+    tof_grid_nbr_reduce(&nbr, kTofGridNbrBox, kTofGridNbrMedian, TOF_ZONES_ALL, nbr_median, nbr_count);
 
     uint16_t candidate[64];
     uint32_t noise_sum = 0u;
     uint32_t noise_count = 0u;
 
-    for (uint32_t y = 0u; y < TOF_GRID_H; y++)
+    for (uint32_t idx = 0u; idx < 64u; idx++)
     {
-        for (uint32_t x = 0u; x < TOF_GRID_W; x++)
+        const uint16_t raw = in_mm[idx];
+
+        uint16_t pred = 0u;
+        bool have_pred = false;
+        if (nbr_count[idx] >= TOF_AI_GRID_NEIGHBOR_MIN)
         {
-            const uint32_t idx = (y * TOF_GRID_W) + x;
-            const uint16_t raw = in_mm[idx];
+            pred = nbr_median[idx];
+            have_pred = true;
+        }
+        else if (tof_mm_valid(s_ai_grid_mm[idx]))
+        {
+            pred = s_ai_grid_mm[idx];
+            have_pred = true;
+        }
 
-            uint16_t neighbors[9];
-            uint32_t ncount = 0u;
-            for (int32_t dy = -1; dy <= 1; dy++)
+        if (tof_mm_valid(raw))
+        {
+            uint16_t fused = raw;
+            if (have_pred)
             {
-                for (int32_t dx = -1; dx <= 1; dx++)
+                const uint16_t delta = tof_abs_diff_u16(raw, pred);
+                noise_sum += delta;
+                noise_count++;
+                /* Weak returns have to agree more closely with their
+                 * neighbours before they are trusted.
+                 */
+                uint32_t zone_threshold_mm = (outlier_threshold_mm * tof_zone_weight_q8(idx)) >> 8;
+                if (zone_threshold_mm < TOF_AI_GRID_OUTLIER_MM_MIN)
                 {
-                    const int32_t nx = (int32_t)x + dx;
-                    const int32_t ny = (int32_t)y + dy;
-                    if (nx < 0 || nx >= TOF_GRID_W || ny < 0 || ny >= TOF_GRID_H)
-                    {
-                        continue;
-                    }
-
-                    const uint16_t nv = in_mm[(uint32_t)ny * TOF_GRID_W + (uint32_t)nx];
-                    if (tof_mm_valid(nv))
-                    {
-                        neighbors[ncount++] = nv;
-                    }
+                    zone_threshold_mm = TOF_AI_GRID_OUTLIER_MM_MIN;
                 }
-            }
-
-            uint16_t pred = 0u;
-            bool have_pred = false;
-            if (ncount >= TOF_AI_GRID_NEIGHBOR_MIN)
-            {
-                pred = tof_ai_grid_median_u16(neighbors, ncount);
-                have_pred = true;
-            }
-            else if (tof_mm_valid(s_ai_grid_mm[idx]))
-            {
-                pred = s_ai_grid_mm[idx];
-                have_pred = true;
-            }
-
-            if (tof_mm_valid(raw))
-            {
-                uint16_t fused = raw;
-                if (have_pred)
+                if (zone_threshold_mm > outlier_threshold_mm)
                 {
-                    const uint16_t delta = tof_abs_diff_u16(raw, pred);
-                    noise_sum += delta;
-                    noise_count++;
-                    if (delta > outlier_threshold_mm)
-                    {
-                        fused = (uint16_t)((((uint32_t)pred * 3u) + raw + 2u) / 4u);
-                    }
-                    else if (delta > (outlier_threshold_mm / 2u))
-                    {
-                        fused = (uint16_t)(((uint32_t)pred + raw + 1u) / 2u);
-                    }
+                    zone_threshold_mm = outlier_threshold_mm;
+                }
+                if (delta > zone_threshold_mm)
+                {
+                    fused = (uint16_t)((((uint32_t)pred * 3u) + raw + 2u) / 4u);
+                }
+                else if (delta > (zone_threshold_mm / 2u))
+                {
+                    fused = (uint16_t)(((uint32_t)pred + raw + 1u) / 2u);
                 }
-                candidate[idx] = fused;
-            }
-            else if (have_pred)
-            {
-                candidate[idx] = pred;
-            }
-            else
-            {
-                candidate[idx] = 0u;
             }
+            candidate[idx] = fused;
+        }
+        else if (have_pred)
+        {
+            candidate[idx] = pred;
+        }
+        else
+        {
+            candidate[idx] = 0u;
         }
     }
 
@@ -3849,12 +4944,35 @@ static void tof_ai_denoise_heatmap_frame(const uint16_t in_mm[64], uint16_t out_
         const uint16_t cur = candidate[i];
         uint16_t next = 0u;
 
+        if ((s_step_mask & ((uint64_t)1u << i)) == 0u)
+        {
+            out_mm[i] = prev;
+            continue;
+        }
+
         if (tof_mm_valid(cur))
         {
             if (tof_mm_valid(prev))
             {
                 const uint16_t delta = tof_abs_diff_u16(prev, cur);
-                const uint32_t den = (delta >= TOF_AI_GRID_FAST_DELTA_MM) ? 2u : slow_den;
+                uint32_t den = (delta >= TOF_AI_GRID_FAST_DELTA_MM) ? 2u : slow_den;
+#if TOF_CONF_WEIGHTING
+                if (s_zone_conf_live && den > 2u)
+                {
+                    /* Strong returns follow with less lag, weak ones are
+                     * smoothed harder.
+                     */
+                    const uint32_t w = tof_zone_weight_q8(i);
+                    if (w >= 256u)
+                    {
+                        den--;
+                    }
+                    else if (w < 128u)
+                    {
+                        den++;
+                    }
+                }
+#endif
                 next = (uint16_t)(((uint32_t)prev * (den - 1u) + cur + (den / 2u)) / den);
             }
             else
@@ -3907,6 +5025,11 @@ static void tof_filter_frame(const uint16_t in_mm[64], bool live_data)
             continue;
         }
 
+        if ((s_step_mask & ((uint64_t)1u << i)) == 0u)
+        {
+            continue;
+        }
+
         if (!tof_mm_valid(sample))
         {
             if (s_filtered_mm[i] > 0u)
@@ -3989,6 +5112,7 @@ static void tof_spatial_postprocess(uint16_t mm[64], bool live_data)
         }
     }
 
+
     uint32_t valid_count = 0u;
     uint32_t sum = 0u;
     uint16_t min_mm = 0xFFFFu;
@@ -4183,6 +5307,11 @@ static void tof_compose_display_frame(bool live_data)
 
     for (uint32_t i = 0u; i < 64u; i++)
     {
+        if ((s_step_mask & ((uint64_t)1u << i)) == 0u)
+        {
+            continue;
+        }
+
         const uint16_t v = src[i];
         if (tof_mm_valid(v))
         {
@@ -4243,7 +5372,7 @@ static void tof_compose_display_frame(bool live_data)
                 }
             }
 
-            if (scount >= 2u)
+            if (scount >= 2u && (s_step_mask & ((uint64_t)1u << idx)) != 0u)
             {
                 smooth[idx] = (uint16_t)(ssum / scount);
             }
@@ -4253,20 +5382,6 @@ static void tof_compose_display_frame(bool live_data)
 }
 #endif
 
-static uint32_t tof_count_valid(const uint16_t mm[64])
-{
-    uint32_t valid = 0u;
-    for (uint32_t i = 0; i < 64u; i++)
-    {
-        const uint16_t v = mm[i];
-        if (tof_mm_valid(v))
-        {
-            valid++;
-        }
-    }
-    return valid;
-}
-
 static void TOF_UNUSED tof_trace_quadrant_means(const uint16_t mm[64], uint32_t cycle_idx)
 {
     uint32_t q_sum[4] = {0u, 0u, 0u, 0u};
@@ -4305,72 +5420,6 @@ static void TOF_UNUSED tof_trace_quadrant_means(const uint16_t mm[64], uint32_t
            (unsigned)valid);
 }
 
-static void TOF_UNUSED tof_fill_synth_fixed(uint16_t out_mm[64], uint32_t tick)
-{
-    const uint32_t drift = (tick / 6u) & 0x3Fu;
-    for (uint32_t y = 0u; y < 8u; y++)
-    {
-        for (uint32_t x = 0u; x < 8u; x++)
-        {
-            const uint32_t idx = (y * 8u) + x;
-            uint32_t mm = 350u + (x * 140u) + (y * 90u);
-            mm += ((x + y + drift) & 0x7u) * 25u;
-            out_mm[idx] = (uint16_t)mm;
-        }
-    }
-}
-
-static uint32_t TOF_UNUSED tof_synth_zone_index_8x8(uint32_t capture, uint32_t zone16)
-{
-    uint32_t x = 0u;
-    uint32_t y = 0u;
-
-#if (TOF_SYNTH_MAP_MODE == 1u)
-    x = (zone16 & 0x3u) + ((capture & 0x1u) << 2u);
-    y = ((zone16 >> 2u) & 0x3u) + (((capture >> 1u) & 0x1u) << 2u);
-#elif (TOF_SYNTH_MAP_MODE == 2u)
-    x = zone16 & 0x7u;
-    y = ((zone16 >> 3u) & 0x1u) + (capture << 1u);
-#elif (TOF_SYNTH_MAP_MODE == 3u)
-    x = ((zone16 >> 3u) & 0x1u) + (capture << 1u);
-    y = zone16 & 0x7u;
-#else
-    const uint32_t phase_x = capture & 0x1u;
-    const uint32_t phase_y = (capture >> 1u) & 0x1u;
-    const uint32_t local_x = zone16 & 0x3u;
-    const uint32_t local_y = (zone16 >> 2u) & 0x3u;
-    x = (local_x << 1u) | phase_x;
-    y = (local_y << 1u) | phase_y;
-#endif
-
-    return (y * 8u) + x;
-}
-
-static bool TOF_UNUSED tof_fill_synth_subcap(uint16_t out_mm[64], uint32_t tick)
-{
-    const uint32_t capture = s_synth_subcap_capture;
-    const uint16_t wave = (uint16_t)(((tick / 4u) & 0xFu) * 8u);
-
-    for (uint32_t zone16 = 0u; zone16 < 16u; zone16++)
-    {
-        const uint32_t local_x = zone16 & 0x3u;
-        const uint32_t local_y = (zone16 >> 2u) & 0x3u;
-        const uint32_t dst = tof_synth_zone_index_8x8(capture, zone16);
-        if (dst >= 64u)
-        {
-            continue;
-        }
-
-        const uint16_t base = (uint16_t)(700u + (capture * 600u));
-        const uint16_t cell = (uint16_t)(base + (local_x * 90u) + (local_y * 120u) + wave);
-        s_synth_subcap_frame[dst] = cell;
-    }
-
-    memcpy(out_mm, s_synth_subcap_frame, sizeof(s_synth_subcap_frame));
-    s_synth_subcap_capture = (uint8_t)((s_synth_subcap_capture + 1u) & 0x3u);
-    return (s_synth_subcap_capture == 0u);
-}
-
 #if !TOF_DEBUG_RAW_DRAW
 static void tof_decay_frame(uint16_t mm[64])
 {
@@ -4381,10 +5430,10 @@ static void tof_decay_frame(uint16_t mm[64])
 }
 #endif
 
-static void tof_update_range(const uint16_t mm[64], bool live_data)
+static void tof_update_range(const tof_frame_summary_t *s, bool live_data)
 {
 #if !TOF_USE_DYNAMIC_RANGE
-    (void)mm;
+    (void)s;
     (void)live_data;
     s_range_near_mm = TOF_LOCKED_NEAR_MM;
     s_range_far_mm = TOF_LOCKED_FAR_MM;
@@ -4397,29 +5446,9 @@ static void tof_update_range(const uint16_t mm[64], bool live_data)
         return;
     }
 
-    uint16_t min_mm = 0xFFFFu;
-    uint16_t max_mm = 0u;
-    uint32_t valid_count = 0u;
-
-    for (uint32_t i = 0u; i < 64u; i++)
-    {
-        const uint16_t v = mm[i];
-        if (!tof_mm_valid(v))
-        {
-            continue;
-        }
-        valid_count++;
-        if (v < min_mm)
-        {
-            min_mm = v;
-        }
-        if (v > max_mm)
-        {
-            max_mm = v;
-        }
-    }
-
-    if (valid_count < 4u || min_mm >= max_mm)
+    const uint16_t min_mm = s->min_mm;
+    const uint16_t max_mm = s->max_mm;
+    if (s->valid_count < 4u || min_mm >= max_mm)
     {
         s_range_near_mm = TOF_LOCKED_NEAR_MM;
         s_range_far_mm = TOF_LOCKED_FAR_MM;
@@ -4439,27 +5468,47 @@ static void tof_update_range(const uint16_t mm[64], bool live_data)
 #endif
 }
 
-static int32_t tof_find_closest_idx(const uint16_t mm[64])
+/* First zone holding the nearest value inside the locked range. The frame
+ * minimum answers it outright unless something sits nearer than the range;
+ * then only rows reaching into the range are scanned.
+ */
+static int32_t tof_find_closest_idx(const tof_frame_summary_t *s)
 {
+    if (s->min_mm >= TOF_LOCKED_NEAR_MM && s->min_mm <= TOF_LOCKED_FAR_MM)
+    {
+        return s->min_idx;
+    }
+    if (s->min_mm == 0u || s->min_mm > TOF_LOCKED_FAR_MM)
+    {
+        return -1;
+    }
+
     int32_t best_idx = -1;
     uint16_t best_mm = 0xFFFFu;
-
-    for (uint32_t i = 0; i < 64u; i++)
+    for (uint32_t y = 0u; y < TOF_GRID_H; y++)
     {
-        const uint16_t v = mm[i];
-        if (v >= TOF_LOCKED_NEAR_MM && v <= TOF_LOCKED_FAR_MM && v < best_mm)
+        const uint16_t row_min = s->row_min_mm[y];
+        if (row_min == 0u || row_min > TOF_LOCKED_FAR_MM || row_min >= best_mm)
+        {
+            continue;
+        }
+        for (uint32_t i = y * TOF_GRID_W; i < ((y + 1u) * TOF_GRID_W); i++)
         {
-            best_mm = v;
-            best_idx = (int32_t)i;
+            const uint16_t v = s->mm[i];
+            if (v >= TOF_LOCKED_NEAR_MM && v <= TOF_LOCKED_FAR_MM && v < best_mm)
+            {
+                best_mm = v;
+                best_idx = (int32_t)i;
+            }
         }
     }
 
     return best_idx;
 }
 
-static void tof_update_hotspot(const uint16_t mm[64], bool live_data)
+static void tof_update_hotspot(const tof_frame_summary_t *s, bool live_data)
 {
-    const int32_t new_hot = live_data ? tof_find_closest_idx(mm) : -1;
+    const int32_t new_hot = live_data ? tof_find_closest_idx(s) : -1;
     if (new_hot == s_hot_idx)
     {
         return;
@@ -4477,6 +5526,99 @@ static void tof_update_hotspot(const uint16_t mm[64], bool live_data)
     }
 }
 
+#if TOF_HEATMAP_BLIT
+typedef struct
+{
+    int32_t gy0;
+    int32_t gy1;
+} tof_heatmap_rows_t;
+
+/* Paint grid rows gy0..gy1 from the cached cell and outline colours; this
+ * reproduces everything the UI has drawn inside the grid.
+ */
+static void tof_heatmap_rows_draw(const void *ctx)
+{
+    const tof_heatmap_rows_t *r = (const tof_heatmap_rows_t *)ctx;
+    const tof_cell_rect_t *first = &s_cells[r->gy0 * TOF_GRID_W];
+    const tof_cell_rect_t *last = &s_cells[(r->gy1 * TOF_GRID_W) + (TOF_GRID_W - 1)];
+    tof_canvas_fill_rect(first->x0, first->y0, last->x1, last->y1, s_ui_bg);
+
+    for (int32_t idx = r->gy0 * TOF_GRID_W; idx < ((r->gy1 + 1) * TOF_GRID_W); idx++)
+    {
+        const tof_cell_rect_t *c = &s_cells[idx];
+        tof_canvas_fill_rect(c->x0, c->y0, c->x1, c->y1, s_ui_border);
+        if (s_cell_outline[idx] != s_ui_border)
+        {
+            tof_canvas_fill_rect(c->ix0 - 1, c->iy0 - 1, c->ix1 + 1, c->iy1 + 1, s_cell_outline[idx]);
+        }
+        tof_canvas_fill_rect(c->ix0, c->iy0, c->ix1, c->iy1, s_cell_drawn[idx] ? s_last_cell_color[idx] : s_ui_bg);
+    }
+}
+#endif
+
+/* Bring the cell interiors up to date with mm[]. Changed cells are collected
+ * in a 64-bit mask; each run of grid rows holding a change is repainted as
+ * one off-screen region.
+ */
+static void tof_draw_heatmap_cells(const uint16_t mm[64])
+{
+    tof_color_lut_update();
+
+    uint64_t dirty = 0u;
+    for (uint32_t idx = 0; idx < 64u; idx++)
+    {
+        const uint16_t color = tof_color_lookup(mm[idx]);
+        if (!s_cell_drawn[idx] || s_last_cell_color[idx] != color)
+        {
+            dirty |= (uint64_t)1u << idx;
+            s_last_cell_color[idx] = color;
+            s_cell_drawn[idx] = true;
+        }
+    }
+
+#if TOF_HEATMAP_BLIT
+    if (dirty == 0u)
+    {
+        return;
+    }
+
+    const uint64_t row_mask = ((uint64_t)1u << TOF_GRID_W) - 1u;
+    int32_t gy = 0;
+    while (gy < TOF_GRID_H)
+    {
+        if (((dirty >> (gy * TOF_GRID_W)) & row_mask) == 0u)
+        {
+            gy++;
+            continue;
+        }
+
+        tof_heatmap_rows_t rows = {.gy0 = gy, .gy1 = gy};
+        while ((rows.gy1 + 1) < TOF_GRID_H && ((dirty >> ((rows.gy1 + 1) * TOF_GRID_W)) & row_mask) != 0u)
+        {
+            rows.gy1++;
+        }
+        const tof_cell_rect_t *first = &s_cells[rows.gy0 * TOF_GRID_W];
+        const tof_cell_rect_t *last = &s_cells[(rows.gy1 * TOF_GRID_W) + (TOF_GRID_W - 1)];
+        tof_canvas_render(first->x0, first->y0, last->x1, last->y1, tof_heatmap_rows_draw, &rows);
+        gy = rows.gy1 + 1;
+    }
+#else
+    for (uint32_t idx = 0; idx < 64u; idx++)
+    {
+        if ((dirty & ((uint64_t)1u << idx)) != 0u)
+        {
+            const tof_cell_rect_t *c = &s_cells[idx];
+            display_hal_fill_rect(c->ix0, c->iy0, c->ix1, c->iy1, s_last_cell_color[idx]);
+        }
+    }
+
+    /* Repainted every frame, dirty or not, as the per-cell path always has. */
+    const uint32_t corner_idx = (TOF_GRID_H - 1u) * TOF_GRID_W;
+    const tof_cell_rect_t *corner = &s_cells[corner_idx];
+    display_hal_fill_rect(corner->ix0, corner->iy1, corner->ix0, corner->iy1, s_last_cell_color[corner_idx]);
+#endif
+}
+
 #if !TOF_DEBUG_RAW_DRAW
 static void tof_make_fallback_frame(uint16_t out_mm[64], uint32_t tick)
 {
@@ -4510,10 +5652,11 @@ static void tof_draw_heatmap_incremental(const uint16_t mm[64], bool live_data)
         s_ai_grid_noise_mm = 0u;
     }
     tof_repair_corner_blindspots(s_display_mm);
-    tof_update_range(s_display_mm, live_data);
+    tof_processed_frame_publish(s_display_mm);
+    tof_update_range(&s_processed_summary, live_data);
     if (s_ai_runtime_on && live_data)
     {
-        (void)tof_calc_roll_curve_distance_mm(s_display_mm, s_curve_pick_idx);
+        (void)tof_calc_roll_curve_distance_mm(&s_processed_summary, s_curve_pick_idx);
     }
     else
     {
@@ -4523,25 +5666,9 @@ static void tof_draw_heatmap_incremental(const uint16_t mm[64], bool live_data)
         }
     }
 
-    for (uint32_t idx = 0; idx < 64u; idx++)
-    {
-        const tof_cell_rect_t *c = &s_cells[idx];
-        const uint16_t color = tof_color_from_mm(s_display_mm[idx], s_range_near_mm, s_range_far_mm);
-
-        if (!s_cell_drawn[idx] || s_last_cell_color[idx] != color)
-        {
-            display_hal_fill_rect(c->ix0, c->iy0, c->ix1, c->iy1, color);
-            s_last_cell_color[idx] = color;
-            s_cell_drawn[idx] = true;
-        }
-    }
-
-    const uint32_t corner_idx = (TOF_GRID_H - 1u) * TOF_GRID_W;
-    const tof_cell_rect_t *corner = &s_cells[corner_idx];
-    const uint16_t corner_color = tof_color_from_mm(s_display_mm[corner_idx], s_range_near_mm, s_range_far_mm);
-    display_hal_fill_rect(corner->ix0, corner->iy1, corner->ix0, corner->iy1, corner_color);
+    tof_draw_heatmap_cells(s_display_mm);
 
-    tof_update_hotspot(s_display_mm, live_data);
+    tof_update_hotspot(&s_processed_summary, live_data);
     tof_draw_curve_pick_overlay(s_ai_runtime_on && live_data);
 }
 #endif
@@ -4563,10 +5690,11 @@ static void tof_draw_heatmap_raw(const uint16_t mm[64], bool live_data)
         s_ai_grid_noise_mm = 0u;
     }
     tof_repair_corner_blindspots(draw_mm);
-    tof_update_range(draw_mm, live_data);
+    tof_processed_frame_publish(draw_mm);
+    tof_update_range(&s_processed_summary, live_data);
     if (s_ai_runtime_on && live_data)
     {
-        (void)tof_calc_roll_curve_distance_mm(draw_mm, s_curve_pick_idx);
+        (void)tof_calc_roll_curve_distance_mm(&s_processed_summary, s_curve_pick_idx);
     }
     else
     {
@@ -4576,30 +5704,21 @@ static void tof_draw_heatmap_raw(const uint16_t mm[64], bool live_data)
         }
     }
 
-    for (uint32_t idx = 0; idx < 64u; idx++)
-    {
-        const tof_cell_rect_t *c = &s_cells[idx];
-        const uint16_t color = tof_color_from_mm(draw_mm[idx], s_range_near_mm, s_range_far_mm);
-
-        if (!s_cell_drawn[idx] || s_last_cell_color[idx] != color)
-        {
-            display_hal_fill_rect(c->ix0, c->iy0, c->ix1, c->iy1, color);
-            s_last_cell_color[idx] = color;
-            s_cell_drawn[idx] = true;
-        }
-    }
-
-    const uint32_t corner_idx = (TOF_GRID_H - 1u) * TOF_GRID_W;
-    const tof_cell_rect_t *corner = &s_cells[corner_idx];
-    const uint16_t corner_color = tof_color_from_mm(draw_mm[corner_idx], s_range_near_mm, s_range_far_mm);
-    display_hal_fill_rect(corner->ix0, corner->iy1, corner->ix0, corner->iy1, corner_color);
+    tof_draw_heatmap_cells(draw_mm);
 
-    tof_update_hotspot(draw_mm, live_data);
+    tof_update_hotspot(&s_processed_summary, live_data);
     tof_draw_curve_pick_overlay(s_ai_runtime_on && live_data);
 }
 #endif
 
-int main(void)
+/* Host builds (tests/) rename the entry point and call it from their own
+ * main().
+ */
+#ifndef TOF_DEMO_MAIN
+#define TOF_DEMO_MAIN main
+#endif
+
+int TOF_DEMO_MAIN(void)
 {
     BOARD_InitHardware();
 
@@ -4608,17 +5727,11 @@ int main(void)
         for (;;) {}
     }
 
-    bool tof_ok = true;
-#if (TOF_DEBUG_INPUT_MODE == TOF_INPUT_MODE_LIVE)
-    tof_ok = tmf8828_quick_init();
-    PRINTF("TOF demo: TMF8828 %s\r\n", tof_ok ? "ready" : "fallback mode");
-#elif (TOF_DEBUG_INPUT_MODE == TOF_INPUT_MODE_SYNTH_FIXED)
-    PRINTF("TOF demo: synthetic fixed-frame mode enabled\r\n");
-#elif (TOF_DEBUG_INPUT_MODE == TOF_INPUT_MODE_SYNTH_SUBCAP)
-    PRINTF("TOF demo: synthetic 4-subcapture mode enabled (map=%u)\r\n", (unsigned)TOF_SYNTH_MAP_MODE);
-#else
-    PRINTF("TOF demo: invalid TOF_DEBUG_INPUT_MODE=%u\r\n", (unsigned)TOF_DEBUG_INPUT_MODE);
-    tof_ok = false;
+    const tof_source_t *source = &TOF_INPUT_SOURCE;
+    bool tof_ok = source->open();
+    PRINTF("TOF demo: %s %s\r\n", source->name, tof_ok ? "ready" : "fallback mode");
+#if (TOF_DEBUG_INPUT_MODE == TOF_INPUT_MODE_SYNTH_SUBCAP)
+    PRINTF("TOF demo: synthetic map=%u\r\n", (unsigned)TOF_SYNTH_MAP_MODE);
 #endif
 #if TOF_DEBUG_RAW_DRAW
     PRINTF("TOF demo: raw draw mode enabled (no smoothing/persistence/fallback)\r\n");
@@ -4626,8 +5739,6 @@ int main(void)
 
     tof_ui_init();
     tof_touch_init();
-    memset(s_synth_subcap_frame, 0, sizeof(s_synth_subcap_frame));
-    s_synth_subcap_capture = 0u;
 
     uint16_t frame_mm[64] = {0};
     uint32_t tick = 0u;
@@ -4652,50 +5763,52 @@ int main(void)
     tof_update_spool_model(boot_roll_mm, false, tick, true);
     s_tp_force_redraw = true;
 
+    uint64_t pending_zone_mask = 0u;
     for (;;)
     {
         bool got_live = false;
         bool got_complete = false;
+#if !TOF_DRAW_PARTIAL_UPDATES
         uint16_t complete_frame_mm[64];
+        uint8_t complete_frame_conf[64];
+#endif
         bool have_complete_frame = false;
         if (tof_ok)
         {
-#if (TOF_DEBUG_INPUT_MODE == TOF_INPUT_MODE_LIVE)
             for (uint32_t burst = 0u; burst < TOF_READ_BURST_MAX; burst++)
             {
-                bool packet_complete = false;
-                if (!tmf8828_quick_read_8x8(frame_mm, &packet_complete))
+                tof_source_frame_t src_frame;
+                if (!source->read(&src_frame, tick))
                 {
                     break;
                 }
+                tof_select_returns(&src_frame.ret, frame_mm, s_zone_conf);
+                s_zone_conf_live = src_frame.has_conf;
                 got_live = true;
-                if (packet_complete)
+                pending_zone_mask |= src_frame.zone_mask;
+                if (src_frame.complete)
                 {
+#if !TOF_DRAW_PARTIAL_UPDATES
                     memcpy(complete_frame_mm, frame_mm, sizeof(complete_frame_mm));
+                    memcpy(complete_frame_conf, s_zone_conf, sizeof(complete_frame_conf));
+#endif
                     have_complete_frame = true;
                 }
             }
             got_complete = have_complete_frame;
+#if !TOF_DRAW_PARTIAL_UPDATES
             if (have_complete_frame)
             {
                 memcpy(frame_mm, complete_frame_mm, sizeof(complete_frame_mm));
+                memcpy(s_zone_conf, complete_frame_conf, sizeof(s_zone_conf));
             }
-#elif (TOF_DEBUG_INPUT_MODE == TOF_INPUT_MODE_SYNTH_FIXED)
-            tof_fill_synth_fixed(frame_mm, tick);
-            got_live = true;
-            got_complete = true;
-#elif (TOF_DEBUG_INPUT_MODE == TOF_INPUT_MODE_SYNTH_SUBCAP)
-            got_complete = tof_fill_synth_subcap(frame_mm, tick);
-            got_live = true;
-#else
-            got_live = false;
-            got_complete = false;
 #endif
         }
 
         if (got_live)
         {
-            const uint32_t valid_count = tof_count_valid(frame_mm);
+            s_frame_seq++;
+            const uint32_t valid_count = tof_frame_summary(frame_mm)->valid_count;
             have_live = true;
             stale_frames = 0u;
             printed_timeout_once = false;
@@ -4744,27 +5857,26 @@ int main(void)
             }
 #endif
 
-#if (TOF_DEBUG_INPUT_MODE == TOF_INPUT_MODE_LIVE)
             if (TOF_ENABLE_AUTO_RECOVERY)
             {
-            if (tof_ok &&
+            if (tof_ok && source->restart &&
                 zero_live_frames >= TOF_ZERO_FRAME_RESTART_FRAMES &&
                 zero_restart_cooldown == 0u)
             {
                 PRINTF("TOF demo: zero-valid frame streak, restarting stream\r\n");
-                if (!tmf8828_quick_restart_measurement())
+                if (!source->restart())
                 {
                     PRINTF("TOF demo: zero-valid restart failed\r\n");
                 }
                 zero_restart_cooldown = TOF_ZERO_FRAME_RESTART_COOLDOWN_FRAMES;
             }
 
-            if (tof_ok &&
+            if (tof_ok && source->recover &&
                 zero_live_frames >= TOF_ZERO_FRAME_REINIT_FRAMES)
             {
-                PRINTF("TOF demo: persistent zero-valid frames, reinitializing sensor\r\n");
-                tof_ok = tmf8828_quick_init();
-                PRINTF("TOF demo: TMF8828 %s\r\n", tof_ok ? "ready" : "fallback mode");
+                PRINTF("TOF demo: persistent zero-valid frames, recovering sensor\r\n");
+                tof_ok = source->recover();
+                PRINTF("TOF demo: %s %s\r\n", source->name, tof_ok ? "ready" : "fallback mode");
                 stale_frames = 0u;
                 printed_live_once = false;
                 have_live = false;
@@ -4774,7 +5886,6 @@ int main(void)
                 had_nonzero_frame = false;
             }
             }
-#endif
         }
         else
         {
@@ -4790,29 +5901,35 @@ int main(void)
                     PRINTF("TOF demo: live stream timeout, waiting for stream\r\n");
                 }
                 have_live = false;
+                s_zone_conf_live = false;
+                s_surface_ref_mm = 0u;
                 if (!printed_timeout_once)
                 {
                     printed_timeout_once = true;
                 }
             }
 
-            if (tof_ok && stale_frames >= TOF_RESTART_LIMIT_FRAMES && !restart_attempted)
+            if (tof_ok && source->restart && stale_frames >= TOF_RESTART_LIMIT_FRAMES && !restart_attempted)
             {
-#if (TOF_DEBUG_INPUT_MODE == TOF_INPUT_MODE_LIVE)
                 if (TOF_ENABLE_AUTO_RECOVERY)
                 {
                     restart_attempted = true;
-                    if (!tmf8828_quick_restart_measurement())
+                    if (!source->restart())
                     {
                         PRINTF("TOF demo: stream restart failed\r\n");
                     }
                 }
-#endif
             }
         }
 
         bool draw_now = false;
 
+        if (!tof_ok || !have_live)
+        {
+            /* Fallback, decay and the confidence reset all rewrite the input. */
+            s_frame_seq++;
+        }
+
         if (!tof_ok)
         {
 #if TOF_DEBUG_RAW_DRAW
@@ -4836,7 +5953,9 @@ int main(void)
 #endif
         }
         else if (
-#if (TOF_DEBUG_INPUT_MODE == TOF_INPUT_MODE_LIVE)
+#if TOF_DRAW_PARTIAL_UPDATES
+            (got_complete || (pending_zone_mask != 0u))
+#elif (TOF_DEBUG_INPUT_MODE == TOF_INPUT_MODE_LIVE)
             (TOF_DRAW_ON_COMPLETE_ONLY ? got_complete : (got_live || got_complete))
 #else
             (got_live || got_complete)
@@ -4855,14 +5974,13 @@ int main(void)
             }
         }
 
-        if (tof_ok && stale_frames >= TOF_REINIT_LIMIT_FRAMES)
+        if (tof_ok && source->recover && stale_frames >= TOF_REINIT_LIMIT_FRAMES)
         {
-#if (TOF_DEBUG_INPUT_MODE == TOF_INPUT_MODE_LIVE)
             if (TOF_ENABLE_AUTO_RECOVERY)
             {
-                PRINTF("TOF demo: prolonged timeout, reinitializing sensor\r\n");
-                tof_ok = tmf8828_quick_init();
-                PRINTF("TOF demo: TMF8828 %s\r\n", tof_ok ? "ready" : "fallback mode");
+                PRINTF("TOF demo: prolonged timeout, recovering sensor\r\n");
+                tof_ok = source->recover();
+                PRINTF("TOF demo: %s %s\r\n", source->name, tof_ok ? "ready" : "fallback mode");
                 stale_frames = 0u;
                 printed_live_once = false;
                 have_live = false;
@@ -4871,19 +5989,28 @@ int main(void)
                 zero_restart_cooldown = 0u;
                 had_nonzero_frame = false;
             }
-#endif
         }
 
+        /* The previous frame's display list drains while the sensor burst
+         * above runs; fence here so this frame never queues behind it.
+         */
+        display_hal_wait_idle();
+
         const bool popup_visible = s_alert_runtime_on && s_alert_popup_active;
 
         if (draw_now && !popup_visible)
         {
+#if TOF_DRAW_PARTIAL_UPDATES
+            s_step_mask = (tof_ok && have_live) ? pending_zone_mask : TOF_ZONES_ALL;
+            pending_zone_mask = 0u;
+#endif
 #if TOF_DEBUG_RAW_DRAW
             const bool raw_live = (tof_ok && got_live);
             tof_draw_heatmap_raw(frame_mm, raw_live);
 #else
             tof_draw_heatmap_incremental(frame_mm, have_live);
 #endif
+            s_step_mask = TOF_ZONES_ALL;
             last_draw_tick = tick;
             have_drawn_frame = true;
         }
@@ -4903,7 +6030,45 @@ int main(void)
         }
         tof_update_roll_alert_ui(s_roll_fullness_q10, model_live, tick);
 
+        display_hal_frame_end();
+        if ((TOF_DISPLAY_STATS_LOG_TICKS > 0u) && ((tick % TOF_DISPLAY_STATS_LOG_TICKS) == 0u))
+        {
+            display_hal_frame_stats_t st;
+            display_hal_get_frame_stats(&st);
+            PRINTF("TOF LCD: frame=%u req=%uB pushed=%uB xfers=%u ovf=%u drop=%u\r\n",
+                   (unsigned)st.frame,
+                   (unsigned)st.bytes_requested,
+                   (unsigned)st.bytes_pushed,
+                   (unsigned)st.transfers,
+                   (unsigned)st.list_overflows,
+                   (unsigned)st.dropped_fills);
+
+            tmf8828_acq_stats_t acq;
+            tmf8828_quick_take_acq_stats(&acq);
+            PRINTF("TOF ACQ: results=%u wasted=%u dropped=%u full=%u err=%u lat=%u/%uus read=%u/%uus\r\n",
+                   (unsigned)acq.results,
+                   (unsigned)acq.wasted_polls,
+                   (unsigned)acq.dropped_captures,
+                   (unsigned)acq.ring_full,
+                   (unsigned)acq.i2c_errors,
+                   (unsigned)acq.latency_avg_us,
+                   (unsigned)acq.latency_max_us,
+                   (unsigned)acq.read_avg_us,
+                   (unsigned)acq.read_max_us);
+            PRINTF("TOF demo: return select ref=%umm model=%umm swaps=%u\r\n",
+                   (unsigned)s_return_ref_mm,
+                   (unsigned)s_surface_ref_mm,
+                   (unsigned)s_return_swaps);
+            s_return_swaps = 0u;
+        }
+
         tick++;
+        if (source->finished && source->finished())
+        {
+            break;
+        }
         SDK_DelayAtLeastUs(TOF_FRAME_US, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
     }
+
+    return 0;
 }
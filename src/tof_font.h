@@ -0,0 +1,317 @@
+#pragma once
+#include <stdint.h>
+
+/* Generated by tools/gen_tof_font.c from the 3x5 debug and 5x7 brand glyph
+ * sets; do not edit. One entry per printable ASCII character from
+ * TOF_FONT_FIRST; lowercase maps to the uppercase glyph and anything without
+ * a glyph gets the '?' box.
+ */
+#define TOF_FONT_FIRST 0x20u
+#define TOF_FONT_GLYPHS 96u
+#define TOF_FONT_FALLBACK ((uint32_t)'?' - TOF_FONT_FIRST)
+
+/* 3x5: five 3-bit rows, row 0 in bits 14..12, leftmost pixel is the MSB. */
+static const uint16_t g_tof_font3x5[TOF_FONT_GLYPHS] = {
+    0x0000u, /* ' ' */
+    0x7282u, /* '!' */
+    0x7282u, /* '"' */
+    0x7282u, /* '#' */
+    0x7282u, /* '$' */
+    0x7282u, /* '%' */
+    0x7282u, /* '&' */
+    0x7282u, /* '\'' */
+    0x1491u, /* '(' */
+    0x4494u, /* ')' */
+    0x7282u, /* '*' */
+    0x7282u, /* '+' */
+    0x7282u, /* ',' */
+    0x01C0u, /* '-' */
+    0x0002u, /* '.' */
+    0x12A4u, /* '/' */
+    0x7B6Fu, /* '0' */
+    0x2C97u, /* '1' */
+    0x73E7u, /* '2' */
+    0x73CFu, /* '3' */
+    0x5BC9u, /* '4' */
+    0x79CFu, /* '5' */
+    0x79EFu, /* '6' */
+    0x7292u, /* '7' */
+    0x7BEFu, /* '8' */
+    0x7BCFu, /* '9' */
+    0x0410u, /* ':' */
+    0x7282u, /* ';' */
+    0x7282u, /* '<' */
+    0x0E38u, /* '=' */
+    0x7282u, /* '>' */
+    0x7282u, /* '?' */
+    0x7282u, /* '@' */
+    0x2BEDu, /* 'A' */
+    0x6BAEu, /* 'B' */
+    0x3923u, /* 'C' */
+    0x6B6Eu, /* 'D' */
+    0x79A7u, /* 'E' */
+    0x79A4u, /* 'F' */
+    0x396Bu, /* 'G' */
+    0x5BEDu, /* 'H' */
+    0x7497u, /* 'I' */
+    0x126Au, /* 'J' */
+    0x5BADu, /* 'K' */
+    0x4927u, /* 'L' */
+    0x5FEDu, /* 'M' */
+    0x5FFDu, /* 'N' */
+    0x2B6Au, /* 'O' */
+    0x6BA4u, /* 'P' */
+    0x2B51u, /* 'Q' */
+    0x6BADu, /* 'R' */
+    0x388Eu, /* 'S' */
+    0x7492u, /* 'T' */
+    0x5B6Fu, /* 'U' */
+    0x5B6Au, /* 'V' */
+    0x5BFDu, /* 'W' */
+    0x5AADu, /* 'X' */
+    0x5A92u, /* 'Y' */
+    0x72A7u, /* 'Z' */
+    0x7282u, /* '[' */
+    0x7282u, /* '\\' */
+    0x7282u, /* ']' */
+    0x7282u, /* '^' */
+    0x7282u, /* '_' */
+    0x7282u, /* '`' */
+    0x2BEDu, /* 'a' */
+    0x6BAEu, /* 'b' */
+    0x3923u, /* 'c' */
+    0x6B6Eu, /* 'd' */
+    0x79A7u, /* 'e' */
+    0x79A4u, /* 'f' */
+    0x396Bu, /* 'g' */
+    0x5BEDu, /* 'h' */
+    0x7497u, /* 'i' */
+    0x126Au, /* 'j' */
+    0x5BADu, /* 'k' */
+    0x4927u, /* 'l' */
+    0x5FEDu, /* 'm' */
+    0x5FFDu, /* 'n' */
+    0x2B6Au, /* 'o' */
+    0x6BA4u, /* 'p' */
+    0x2B51u, /* 'q' */
+    0x6BADu, /* 'r' */
+    0x388Eu, /* 's' */
+    0x7492u, /* 't' */
+    0x5B6Fu, /* 'u' */
+    0x5B6Au, /* 'v' */
+    0x5BFDu, /* 'w' */
+    0x5AADu, /* 'x' */
+    0x5A92u, /* 'y' */
+    0x72A7u, /* 'z' */
+    0x7282u, /* '{' */
+    0x7282u, /* '|' */
+    0x7282u, /* '}' */
+    0x7282u, /* '~' */
+    0x7282u, /* DEL */
+};
+
+/* 3x5 pre-expanded 2x horizontally: five 6-bit rows, row 0 in bits 29..24. */
+static const uint32_t g_tof_font3x5_x2[TOF_FONT_GLYPHS] = {
+    0x00000000u, /* ' ' */
+    0x3F0CC00Cu, /* '!' */
+    0x3F0CC00Cu, /* '"' */
+    0x3F0CC00Cu, /* '#' */
+    0x3F0CC00Cu, /* '$' */
+    0x3F0CC00Cu, /* '%' */
+    0x3F0CC00Cu, /* '&' */
+    0x3F0CC00Cu, /* '\'' */
+    0x0330C303u, /* '(' */
+    0x3030C330u, /* ')' */
+    0x3F0CC00Cu, /* '*' */
+    0x3F0CC00Cu, /* '+' */
+    0x3F0CC00Cu, /* ',' */
+    0x0003F000u, /* '-' */
+    0x0000000Cu, /* '.' */
+    0x030CCC30u, /* '/' */
+    0x3FCF3CFFu, /* '0' */
+    0x0CF0C33Fu, /* '1' */
+    0x3F0FFC3Fu, /* '2' */
+    0x3F0FF0FFu, /* '3' */
+    0x33CFF0C3u, /* '4' */
+    0x3FC3F0FFu, /* '5' */
+    0x3FC3FCFFu, /* '6' */
+    0x3F0CC30Cu, /* '7' */
+    0x3FCFFCFFu, /* '8' */
+    0x3FCFF0FFu, /* '9' */
+    0x00300300u, /* ':' */
+    0x3F0CC00Cu, /* ';' */
+    0x3F0CC00Cu, /* '<' */
+    0x00FC0FC0u, /* '=' */
+    0x3F0CC00Cu, /* '>' */
+    0x3F0CC00Cu, /* '?' */
+    0x3F0CC00Cu, /* '@' */
+    0x0CCFFCF3u, /* 'A' */
+    0x3CCFCCFCu, /* 'B' */
+    0x0FC30C0Fu, /* 'C' */
+    0x3CCF3CFCu, /* 'D' */
+    0x3FC3CC3Fu, /* 'E' */
+    0x3FC3CC30u, /* 'F' */
+    0x0FC33CCFu, /* 'G' */
+    0x33CFFCF3u, /* 'H' */
+    0x3F30C33Fu, /* 'I' */
+    0x030C3CCCu, /* 'J' */
+    0x33CFCCF3u, /* 'K' */
+    0x30C30C3Fu, /* 'L' */
+    0x33FFFCF3u, /* 'M' */
+    0x33FFFFF3u, /* 'N' */
+    0x0CCF3CCCu, /* 'O' */
+    0x3CCFCC30u, /* 'P' */
+    0x0CCF3303u, /* 'Q' */
+    0x3CCFCCF3u, /* 'R' */
+    0x0FC0C0FCu, /* 'S' */
+    0x3F30C30Cu, /* 'T' */
+    0x33CF3CFFu, /* 'U' */
+    0x33CF3CCCu, /* 'V' */
+    0x33CFFFF3u, /* 'W' */
+    0x33CCCCF3u, /* 'X' */
+    0x33CCC30Cu, /* 'Y' */
+    0x3F0CCC3Fu, /* 'Z' */
+    0x3F0CC00Cu, /* '[' */
+    0x3F0CC00Cu, /* '\\' */
+    0x3F0CC00Cu, /* ']' */
+    0x3F0CC00Cu, /* '^' */
+    0x3F0CC00Cu, /* '_' */
+    0x3F0CC00Cu, /* '`' */
+    0x0CCFFCF3u, /* 'a' */
+    0x3CCFCCFCu, /* 'b' */
+    0x0FC30C0Fu, /* 'c' */
+    0x3CCF3CFCu, /* 'd' */
+    0x3FC3CC3Fu, /* 'e' */
+    0x3FC3CC30u, /* 'f' */
+    0x0FC33CCFu, /* 'g' */
+    0x33CFFCF3u, /* 'h' */
+    0x3F30C33Fu, /* 'i' */
+    0x030C3CCCu, /* 'j' */
+    0x33CFCCF3u, /* 'k' */
+    0x30C30C3Fu, /* 'l' */
+    0x33FFFCF3u, /* 'm' */
+    0x33FFFFF3u, /* 'n' */
+    0x0CCF3CCCu, /* 'o' */
+    0x3CCFCC30u, /* 'p' */
+    0x0CCF3303u, /* 'q' */
+    0x3CCFCCF3u, /* 'r' */
+    0x0FC0C0FCu, /* 's' */
+    0x3F30C30Cu, /* 't' */
+    0x33CF3CFFu, /* 'u' */
+    0x33CF3CCCu, /* 'v' */
+    0x33CFFFF3u, /* 'w' */
+    0x33CCCCF3u, /* 'x' */
+    0x33CCC30Cu, /* 'y' */
+    0x3F0CCC3Fu, /* 'z' */
+    0x3F0CC00Cu, /* '{' */
+    0x3F0CC00Cu, /* '|' */
+    0x3F0CC00Cu, /* '}' */
+    0x3F0CC00Cu, /* '~' */
+    0x3F0CC00Cu, /* DEL */
+};
+
+/* 5x7: one 5-bit row per byte, leftmost pixel is bit 4. */
+static const uint8_t g_tof_font5x7[TOF_FONT_GLYPHS][7] = {
+    {0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u}, /* ' ' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '!' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '"' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '#' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '$' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '%' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '&' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '\'' */
+    {0x02u, 0x04u, 0x08u, 0x08u, 0x08u, 0x04u, 0x02u}, /* '(' */
+    {0x08u, 0x04u, 0x02u, 0x02u, 0x02u, 0x04u, 0x08u}, /* ')' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '*' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '+' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* ',' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '-' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '.' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '/' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '0' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '1' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '2' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '3' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '4' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '5' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '6' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '7' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '8' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '9' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* ':' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* ';' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '<' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '=' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '>' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '?' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '@' */
+    {0x0Eu, 0x11u, 0x11u, 0x1Fu, 0x11u, 0x11u, 0x11u}, /* 'A' */
+    {0x1Eu, 0x11u, 0x11u, 0x1Eu, 0x11u, 0x11u, 0x1Eu}, /* 'B' */
+    {0x0Eu, 0x11u, 0x10u, 0x10u, 0x10u, 0x11u, 0x0Eu}, /* 'C' */
+    {0x1Eu, 0x11u, 0x11u, 0x11u, 0x11u, 0x11u, 0x1Eu}, /* 'D' */
+    {0x1Fu, 0x10u, 0x10u, 0x1Eu, 0x10u, 0x10u, 0x1Fu}, /* 'E' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'F' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'G' */
+    {0x11u, 0x11u, 0x11u, 0x1Fu, 0x11u, 0x11u, 0x11u}, /* 'H' */
+    {0x1Fu, 0x04u, 0x04u, 0x04u, 0x04u, 0x04u, 0x1Fu}, /* 'I' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'J' */
+    {0x11u, 0x12u, 0x14u, 0x18u, 0x14u, 0x12u, 0x11u}, /* 'K' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'L' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'M' */
+    {0x11u, 0x19u, 0x15u, 0x13u, 0x11u, 0x11u, 0x11u}, /* 'N' */
+    {0x0Eu, 0x11u, 0x11u, 0x11u, 0x11u, 0x11u, 0x0Eu}, /* 'O' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'P' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'Q' */
+    {0x1Eu, 0x11u, 0x11u, 0x1Eu, 0x14u, 0x12u, 0x11u}, /* 'R' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'S' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'T' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'U' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'V' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'W' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'X' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'Y' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'Z' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '[' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '\\' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* ']' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '^' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '_' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '`' */
+    {0x0Eu, 0x11u, 0x11u, 0x1Fu, 0x11u, 0x11u, 0x11u}, /* 'a' */
+    {0x1Eu, 0x11u, 0x11u, 0x1Eu, 0x11u, 0x11u, 0x1Eu}, /* 'b' */
+    {0x0Eu, 0x11u, 0x10u, 0x10u, 0x10u, 0x11u, 0x0Eu}, /* 'c' */
+    {0x1Eu, 0x11u, 0x11u, 0x11u, 0x11u, 0x11u, 0x1Eu}, /* 'd' */
+    {0x1Fu, 0x10u, 0x10u, 0x1Eu, 0x10u, 0x10u, 0x1Fu}, /* 'e' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'f' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'g' */
+    {0x11u, 0x11u, 0x11u, 0x1Fu, 0x11u, 0x11u, 0x11u}, /* 'h' */
+    {0x1Fu, 0x04u, 0x04u, 0x04u, 0x04u, 0x04u, 0x1Fu}, /* 'i' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'j' */
+    {0x11u, 0x12u, 0x14u, 0x18u, 0x14u, 0x12u, 0x11u}, /* 'k' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'l' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'm' */
+    {0x11u, 0x19u, 0x15u, 0x13u, 0x11u, 0x11u, 0x11u}, /* 'n' */
+    {0x0Eu, 0x11u, 0x11u, 0x11u, 0x11u, 0x11u, 0x0Eu}, /* 'o' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'p' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'q' */
+    {0x1Eu, 0x11u, 0x11u, 0x1Eu, 0x14u, 0x12u, 0x11u}, /* 'r' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 's' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 't' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'u' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'v' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'w' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'x' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'y' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* 'z' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '{' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '|' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '}' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* '~' */
+    {0x1Fu, 0x01u, 0x02u, 0x04u, 0x04u, 0x00u, 0x04u}, /* DEL */
+};
+
+static inline uint32_t tof_font_index(char ch)
+{
+    const uint32_t idx = (uint32_t)(uint8_t)ch - TOF_FONT_FIRST;
+    return (idx < TOF_FONT_GLYPHS) ? idx : TOF_FONT_FALLBACK;
+}
@@ -0,0 +1,226 @@
+#include "tof_grid_nbr.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#if TOF_GRID_NBR_SIMD && defined(__ARM_FEATURE_SIMD32)
+#include <arm_acle.h>
+#define TOF_GRID_NBR_LANES 2u
+#else
+#define TOF_GRID_NBR_LANES 1u
+#endif
+
+#define TOF_GRID_NBR_SUM_SPLIT 4u /* neighbours per 16-bit partial sum */
+
+/* Offsets from the centre zone in the padded (10-wide) grid. The ring is
+ * the box without its centre.
+ */
+static const int8_t s_box_off[9] = {-11, -10, -9, -1, 0, 1, 9, 10, 11};
+static const int8_t s_ring_off[8] = {-11, -10, -9, -1, 1, 9, 10, 11};
+
+static inline uint32_t tof_grid_nbr_pad_idx(uint32_t idx)
+{
+    return (((idx >> 3) + 1u) * TOF_GRID_NBR_PAD_W) + (idx & 7u) + 1u;
+}
+
+/* Distances of the zones handled together, one per 16-bit lane. */
+static inline uint32_t tof_grid_nbr_load_mm(const uint16_t *p)
+{
+#if (TOF_GRID_NBR_LANES == 2u)
+    uint32_t w;
+    memcpy(&w, p, sizeof(w));
+    return w;
+#else
+    return *p;
+#endif
+}
+
+/* Validity of the zones handled together, one per byte. */
+static inline uint32_t tof_grid_nbr_load_valid(const uint8_t *p)
+{
+#if (TOF_GRID_NBR_LANES == 2u)
+    uint16_t w;
+    memcpy(&w, p, sizeof(w));
+    return w;
+#else
+    return *p;
+#endif
+}
+
+static inline uint32_t tof_grid_nbr_lane16(uint32_t w, uint32_t lane)
+{
+#if (TOF_GRID_NBR_LANES == 2u)
+    return (w >> (16u * lane)) & 0xFFFFu;
+#else
+    (void)lane;
+    return w;
+#endif
+}
+
+/* Sort key: mm - 1 per lane, so invalid zones (0) wrap to 0xFFFF and sort
+ * after every valid distance.
+ */
+static inline uint32_t tof_grid_nbr_key(uint32_t w)
+{
+#if (TOF_GRID_NBR_LANES == 2u)
+    return __usub16(w, 0x00010001u);
+#else
+    return (w - 1u) & 0xFFFFu;
+#endif
+}
+
+/* Compare-exchange: *a gets the smaller, *b the larger key, per lane. */
+static inline void tof_grid_nbr_ce(uint32_t *a, uint32_t *b)
+{
+    const uint32_t x = *a;
+    const uint32_t y = *b;
+#if (TOF_GRID_NBR_LANES == 2u)
+    (void)__usub16(x, y); /* GE set per lane where x >= y */
+    *a = __sel(y, x);
+    *b = __sel(x, y);
+#else
+    const bool swap = (x > y);
+    *a = swap ? y : x;
+    *b = swap ? x : y;
+#endif
+}
+
+/* Leaves the five smallest of v[0..8] in v[0..4], in order; enough for
+ * element count / 2 at any count. A 25-comparator sorting network with the
+ * three comparators that only order v[5..8] dropped.
+ */
+static inline void tof_grid_nbr_select5(uint32_t v[9])
+{
+    tof_grid_nbr_ce(&v[0], &v[3]);
+    tof_grid_nbr_ce(&v[1], &v[7]);
+    tof_grid_nbr_ce(&v[2], &v[5]);
+    tof_grid_nbr_ce(&v[4], &v[8]);
+    tof_grid_nbr_ce(&v[0], &v[7]);
+    tof_grid_nbr_ce(&v[2], &v[4]);
+    tof_grid_nbr_ce(&v[3], &v[8]);
+    tof_grid_nbr_ce(&v[5], &v[6]);
+    tof_grid_nbr_ce(&v[0], &v[2]);
+    tof_grid_nbr_ce(&v[1], &v[3]);
+    tof_grid_nbr_ce(&v[4], &v[5]);
+    tof_grid_nbr_ce(&v[7], &v[8]);
+    tof_grid_nbr_ce(&v[1], &v[4]);
+    tof_grid_nbr_ce(&v[3], &v[6]);
+    tof_grid_nbr_ce(&v[5], &v[7]);
+    tof_grid_nbr_ce(&v[0], &v[1]);
+    tof_grid_nbr_ce(&v[2], &v[4]);
+    tof_grid_nbr_ce(&v[3], &v[5]);
+    tof_grid_nbr_ce(&v[2], &v[3]);
+    tof_grid_nbr_ce(&v[4], &v[5]);
+    tof_grid_nbr_ce(&v[1], &v[2]);
+    tof_grid_nbr_ce(&v[3], &v[4]);
+}
+
+void tof_grid_nbr_load(tof_grid_nbr_frame_t *f, const uint16_t mm[64], uint64_t valid_mask)
+{
+    const uint32_t last_row = TOF_GRID_NBR_PADDED - TOF_GRID_NBR_PAD_W;
+    memset(&f->mm[0], 0, TOF_GRID_NBR_PAD_W * sizeof(f->mm[0]));
+    memset(&f->mm[last_row], 0, TOF_GRID_NBR_PAD_W * sizeof(f->mm[0]));
+    memset(&f->valid[0], 0, TOF_GRID_NBR_PAD_W);
+    memset(&f->valid[last_row], 0, TOF_GRID_NBR_PAD_W);
+
+    for (uint32_t y = 0u; y < 8u; y++)
+    {
+        const uint32_t row = (y + 1u) * TOF_GRID_NBR_PAD_W;
+        f->mm[row] = 0u;
+        f->mm[row + TOF_GRID_NBR_PAD_W - 1u] = 0u;
+        f->valid[row] = 0u;
+        f->valid[row + TOF_GRID_NBR_PAD_W - 1u] = 0u;
+        for (uint32_t x = 0u; x < 8u; x++)
+        {
+            const uint32_t idx = (y * 8u) + x;
+            const uint8_t valid = (uint8_t)((valid_mask >> idx) & 1u);
+            f->mm[row + 1u + x] = valid ? mm[idx] : 0u;
+            f->valid[row + 1u + x] = valid;
+        }
+    }
+}
+
+void tof_grid_nbr_reduce(const tof_grid_nbr_frame_t *f,
+                         tof_grid_nbr_shape_t shape,
+                         tof_grid_nbr_op_t op,
+                         uint64_t zone_mask,
+                         uint16_t out_value[64],
+                         uint8_t out_count[64])
+{
+    const int8_t *off = (shape == kTofGridNbrBox) ? s_box_off : s_ring_off;
+    const uint32_t n = (shape == kTofGridNbrBox) ? 9u : 8u;
+    const bool want_value = (op != kTofGridNbrCount) && (out_value != NULL);
+
+    for (uint32_t idx = 0u; idx < 64u; idx += TOF_GRID_NBR_LANES)
+    {
+        const uint32_t lanes = (uint32_t)(zone_mask >> idx) & ((1u << TOF_GRID_NBR_LANES) - 1u);
+        if (lanes == 0u)
+        {
+            continue;
+        }
+
+        const uint32_t centre = tof_grid_nbr_pad_idx(idx);
+        const uint16_t *mm = &f->mm[centre];
+        const uint8_t *valid = &f->valid[centre];
+        uint32_t count = 0u; /* per-lane counts, one byte each */
+        for (uint32_t k = 0u; k < n; k++)
+        {
+            count += tof_grid_nbr_load_valid(valid + off[k]);
+        }
+
+        /* Two partial sums of at most five distances, so no lane carries. */
+        uint32_t sum_a = 0u;
+        uint32_t sum_b = 0u;
+        uint32_t key[9];
+        if (want_value && op == kTofGridNbrMedian)
+        {
+            for (uint32_t k = 0u; k < n; k++)
+            {
+                key[k] = tof_grid_nbr_key(tof_grid_nbr_load_mm(mm + off[k]));
+            }
+            if (n < 9u)
+            {
+                key[8] = 0xFFFFFFFFu;
+            }
+            tof_grid_nbr_select5(key);
+        }
+        else if (want_value)
+        {
+            for (uint32_t k = 0u; k < TOF_GRID_NBR_SUM_SPLIT; k++)
+            {
+                sum_a += tof_grid_nbr_load_mm(mm + off[k]);
+            }
+            for (uint32_t k = TOF_GRID_NBR_SUM_SPLIT; k < n; k++)
+            {
+                sum_b += tof_grid_nbr_load_mm(mm + off[k]);
+            }
+        }
+
+        for (uint32_t lane = 0u; lane < TOF_GRID_NBR_LANES; lane++)
+        {
+            if (((lanes >> lane) & 1u) == 0u)
+            {
+                continue;
+            }
+
+            const uint32_t cnt = (count >> (8u * lane)) & 0xFFu;
+            out_count[idx + lane] = (uint8_t)cnt;
+            if (!want_value)
+            {
+                continue;
+            }
+
+            uint32_t value = 0u;
+            if (cnt > 0u && op == kTofGridNbrMedian)
+            {
+                value = tof_grid_nbr_lane16(key[cnt / 2u], lane) + 1u;
+            }
+            else if (cnt > 0u)
+            {
+                const uint32_t sum = tof_grid_nbr_lane16(sum_a, lane) + tof_grid_nbr_lane16(sum_b, lane);
+                value = (op == kTofGridNbrMeanRound) ? ((sum + (cnt / 2u)) / cnt) : (sum / cnt);
+            }
+            out_value[idx + lane] = (uint16_t)value;
+        }
+    }
+}
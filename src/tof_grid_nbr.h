@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+
+/* 3x3 neighbourhood engine for 8x8 grids, used by the AI grid denoiser. A
+ * frame is loaded once into a padded 10x10 layout where invalid zones and
+ * the border read 0, so every reduction walks a constant offset table with
+ * no edge checks. The hole fills keep their own loops: they touch only the
+ * invalid zones, and the padded load costs more than it saves there.
+ */
+
+#define TOF_GRID_NBR_PAD_W  10u
+#define TOF_GRID_NBR_PADDED (TOF_GRID_NBR_PAD_W * TOF_GRID_NBR_PAD_W)
+
+/* Two zones per word on cores with the DSP extension (packed sums, USUB16 +
+ * SEL compare-exchange for the median); one zone at a time in plain C
+ * otherwise. Both give identical results.
+ */
+#ifndef TOF_GRID_NBR_SIMD
+#define TOF_GRID_NBR_SIMD 1u
+#endif
+
+typedef enum
+{
+    kTofGridNbrRing = 0, /* the 8 zones around the centre */
+    kTofGridNbrBox,      /* the 3x3 block, centre included */
+} tof_grid_nbr_shape_t;
+
+typedef enum
+{
+    kTofGridNbrCount = 0, /* valid zone count only */
+    kTofGridNbrMean,      /* truncated mean */
+    kTofGridNbrMeanRound, /* mean rounded to nearest */
+    kTofGridNbrMedian,    /* median, the upper one for even counts */
+} tof_grid_nbr_op_t;
+
+typedef struct
+{
+    uint16_t mm[TOF_GRID_NBR_PADDED];   /* valid zones, 0 elsewhere */
+    uint8_t valid[TOF_GRID_NBR_PADDED]; /* 1 for valid zones */
+} tof_grid_nbr_frame_t;
+
+/* valid_mask bit = row * 8 + col. Valid zones must read 1..13107 mm so
+ * five of them sum within a 16-bit lane.
+ */
+void tof_grid_nbr_load(tof_grid_nbr_frame_t *f, const uint16_t mm[64], uint64_t valid_mask);
+
+/* For each zone in zone_mask: the number of valid zones in its neighbourhood
+ * and, unless op is kTofGridNbrCount, their mean or median (0 when there are
+ * none). Zones outside zone_mask are left untouched; out_value may be NULL
+ * for kTofGridNbrCount.
+ */
+void tof_grid_nbr_reduce(const tof_grid_nbr_frame_t *f,
+                         tof_grid_nbr_shape_t shape,
+                         tof_grid_nbr_op_t op,
+                         uint64_t zone_mask,
+                         uint16_t out_value[64],
+                         uint8_t out_count[64]);
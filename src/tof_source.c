@@ -0,0 +1,169 @@
+#include "tof_source.h"
+
+#include <string.h>
+
+#define TOF_SOURCE_ZONES_ALL (~(uint64_t)0u)
+
+/* Live sensor. */
+
+static bool tof_live_open(void)
+{
+    return tmf8828_quick_init();
+}
+
+static bool tof_live_read(tof_source_frame_t *out, uint32_t tick)
+{
+    (void)tick;
+    bool complete = false;
+    if (!tmf8828_quick_read_dual(&out->ret, &complete))
+    {
+        return false;
+    }
+
+    tmf8828_update_t update;
+    tmf8828_quick_get_last_update(&update);
+    out->zone_mask = update.zone_mask;
+    out->has_conf = true;
+    out->complete = complete;
+    return true;
+}
+
+static bool tof_live_recover(void)
+{
+    return (tmf8828_quick_recover() != TMF8828_RECOVER_FAILED);
+}
+
+const tof_source_t g_tof_source_live = {
+    .name = "TMF8828",
+    .open = tof_live_open,
+    .read = tof_live_read,
+    .restart = tmf8828_quick_restart_measurement,
+    .recover = tof_live_recover,
+    .finished = NULL,
+};
+
+/* Synthetic generators: one frame per tick, no confidence plane. */
+
+static uint32_t s_synth_tick = 0u;
+static bool s_synth_tick_valid = false;
+static uint16_t s_synth_subcap_frame[64];
+static uint8_t s_synth_subcap_capture = 0u;
+
+static bool tof_synth_open(void)
+{
+    memset(s_synth_subcap_frame, 0, sizeof(s_synth_subcap_frame));
+    s_synth_subcap_capture = 0u;
+    s_synth_tick_valid = false;
+    return true;
+}
+
+static bool tof_synth_begin(tof_source_frame_t *out, uint32_t tick)
+{
+    if (s_synth_tick_valid && s_synth_tick == tick)
+    {
+        return false;
+    }
+    s_synth_tick = tick;
+    s_synth_tick_valid = true;
+    memset(out, 0, sizeof(*out));
+    return true;
+}
+
+static bool tof_synth_fixed_read(tof_source_frame_t *out, uint32_t tick)
+{
+    if (!tof_synth_begin(out, tick))
+    {
+        return false;
+    }
+
+    const uint32_t drift = (tick / 6u) & 0x3Fu;
+    for (uint32_t y = 0u; y < 8u; y++)
+    {
+        for (uint32_t x = 0u; x < 8u; x++)
+        {
+            const uint32_t idx = (y * 8u) + x;
+            uint32_t mm = 350u + (x * 140u) + (y * 90u);
+            mm += ((x + y + drift) & 0x7u) * 25u;
+            out->ret.mm[0][idx] = (uint16_t)mm;
+        }
+    }
+    out->zone_mask = TOF_SOURCE_ZONES_ALL;
+    out->complete = true;
+    return true;
+}
+
+static uint32_t tof_synth_zone_index_8x8(uint32_t capture, uint32_t zone16)
+{
+    uint32_t x = 0u;
+    uint32_t y = 0u;
+
+#if (TOF_SYNTH_MAP_MODE == 1u)
+    x = (zone16 & 0x3u) + ((capture & 0x1u) << 2u);
+    y = ((zone16 >> 2u) & 0x3u) + (((capture >> 1u) & 0x1u) << 2u);
+#elif (TOF_SYNTH_MAP_MODE == 2u)
+    x = zone16 & 0x7u;
+    y = ((zone16 >> 3u) & 0x1u) + (capture << 1u);
+#elif (TOF_SYNTH_MAP_MODE == 3u)
+    x = ((zone16 >> 3u) & 0x1u) + (capture << 1u);
+    y = zone16 & 0x7u;
+#else
+    const uint32_t phase_x = capture & 0x1u;
+    const uint32_t phase_y = (capture >> 1u) & 0x1u;
+    const uint32_t local_x = zone16 & 0x3u;
+    const uint32_t local_y = (zone16 >> 2u) & 0x3u;
+    x = (local_x << 1u) | phase_x;
+    y = (local_y << 1u) | phase_y;
+#endif
+
+    return (y * 8u) + x;
+}
+
+static bool tof_synth_subcap_read(tof_source_frame_t *out, uint32_t tick)
+{
+    if (!tof_synth_begin(out, tick))
+    {
+        return false;
+    }
+
+    const uint32_t capture = s_synth_subcap_capture;
+    const uint16_t wave = (uint16_t)(((tick / 4u) & 0xFu) * 8u);
+
+    for (uint32_t zone16 = 0u; zone16 < 16u; zone16++)
+    {
+        const uint32_t local_x = zone16 & 0x3u;
+        const uint32_t local_y = (zone16 >> 2u) & 0x3u;
+        const uint32_t dst = tof_synth_zone_index_8x8(capture, zone16);
+        if (dst >= 64u)
+        {
+            continue;
+        }
+
+        const uint16_t base = (uint16_t)(700u + (capture * 600u));
+        const uint16_t cell = (uint16_t)(base + (local_x * 90u) + (local_y * 120u) + wave);
+        s_synth_subcap_frame[dst] = cell;
+        out->zone_mask |= (uint64_t)1u << dst;
+    }
+
+    memcpy(out->ret.mm[0], s_synth_subcap_frame, sizeof(s_synth_subcap_frame));
+    s_synth_subcap_capture = (uint8_t)((s_synth_subcap_capture + 1u) & 0x3u);
+    out->complete = (s_synth_subcap_capture == 0u);
+    return true;
+}
+
+const tof_source_t g_tof_source_synth_fixed = {
+    .name = "synthetic fixed-frame",
+    .open = tof_synth_open,
+    .read = tof_synth_fixed_read,
+    .restart = NULL,
+    .recover = NULL,
+    .finished = NULL,
+};
+
+const tof_source_t g_tof_source_synth_subcap = {
+    .name = "synthetic 4-subcapture",
+    .open = tof_synth_open,
+    .read = tof_synth_subcap_read,
+    .restart = NULL,
+    .recover = NULL,
+    .finished = NULL,
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tmf8828_quick.h"
+
+/* Frame sources for the demo pipeline. main() polls one source every tick;
+ * the live sensor, the synthetic generators and the capture replay all fill
+ * the same record, so the spool pipeline runs unchanged on any of them.
+ */
+
+/* Synthetic 4-subcapture map, same modes as TMF8828_ZONE_MAP_MODE. */
+#ifndef TOF_SYNTH_MAP_MODE
+#define TOF_SYNTH_MAP_MODE 0u
+#endif
+
+typedef struct
+{
+    tmf8828_dual_frame_t ret; /* return 1 reads 0 mm when the source has one */
+    uint64_t zone_mask;       /* zones measured by this read, bit = row * 8 + col */
+    bool has_conf;            /* ret.conf holds sensor confidence */
+    bool complete;            /* last sub-capture of an 8x8 cycle */
+} tof_source_frame_t;
+
+typedef struct
+{
+    const char *name;
+    bool (*open)(void);
+    /* Next frame, false when none is ready at this tick. */
+    bool (*read)(tof_source_frame_t *out, uint32_t tick);
+    /* Stall handling; NULL when the source cannot be restarted. */
+    bool (*restart)(void);
+    bool (*recover)(void);
+    /* True once a finite source has nothing more to give; NULL for the
+     * sources that run forever.
+     */
+    bool (*finished)(void);
+} tof_source_t;
+
+extern const tof_source_t g_tof_source_live;
+extern const tof_source_t g_tof_source_synth_fixed;
+extern const tof_source_t g_tof_source_synth_subcap;
+
+/* Replay of recorded captures, host builds only (platform/tof_source_replay_host.c,
+ * run through tests/tof_demo_host.c).
+ * Reads either a serial log holding AI_F64 lines or a binary capture file:
+ *   header: "TOFC", u16 version (1), u16 record size (400)
+ *   record: u32 t_us, u8 flags (bit0 complete, bit1 has_conf), u8 pad[3],
+ *           u64 zone_mask, u16 mm[2][64], u8 conf[2][64]
+ * all little endian. At most one record is released per tick: with
+ * realtime set, once its timestamp is due at tick_us per tick; otherwise on
+ * every tick. The source finishes at end of file.
+ */
+extern const tof_source_t g_tof_source_replay;
+void tof_source_replay_configure(const char *path, bool realtime, uint32_t tick_us);
+/* Records handed out since the capture was opened. */
+uint32_t tof_source_replay_frames(void);
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+
+/* Host stand-in for the two ACLE SIMD32 intrinsics tof_grid_nbr.c uses, so
+ * its packed path can run on the host (test_grid_nbr_simd). __usub16 sets
+ * the APSR.GE bits per byte as the core does; __sel reads them.
+ */
+
+static uint32_t s_acle_ge;
+
+static inline uint32_t __usub16(uint32_t a, uint32_t b)
+{
+    uint32_t r = 0u;
+    s_acle_ge = 0u;
+    for (uint32_t lane = 0u; lane < 2u; lane++)
+    {
+        const uint32_t x = (a >> (16u * lane)) & 0xFFFFu;
+        const uint32_t y = (b >> (16u * lane)) & 0xFFFFu;
+        if (x >= y)
+        {
+            s_acle_ge |= 3u << (2u * lane);
+        }
+        r |= ((x - y) & 0xFFFFu) << (16u * lane);
+    }
+    return r;
+}
+
+static inline uint32_t __sel(uint32_t a, uint32_t b)
+{
+    uint32_t r = 0u;
+    for (uint32_t i = 0u; i < 4u; i++)
+    {
+        const uint32_t m = 0xFFu << (8u * i);
+        r |= (((s_acle_ge >> i) & 1u) != 0u) ? (a & m) : (b & m);
+    }
+    return r;
+}
@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tmf8828_decode.h"
+
+/* Fuzz target for tmf8828_decode_result(). The input is cut into
+ * TMF8828_RESULT_SIZE-byte result blocks (the last one zero-padded) that are
+ * decoded in order through one decoder, so sequence/capture id changes,
+ * repeats and gaps between blocks are covered. After every block:
+ *
+ * - a rejected block left the decoder untouched;
+ * - published, alternate and per-capture distances are 0 or below 12000 mm;
+ * - the caller's copy matches the published grid;
+ * - the update covers exactly one sub-capture (16 zones) and its changed
+ *   mask matches the grid before and after;
+ * - the capture assembly mask never holds a complete cycle.
+ *
+ * A violation prints the block index and aborts.
+ *
+ *   libFuzzer: cmake -S tests -B build-fuzz -DCMAKE_C_COMPILER=clang -DTOF_HOST_FUZZ=ON
+ *              build-fuzz/fuzz_tmf8828_decode_libfuzzer corpus/
+ *   AFL:       CC=afl-cc cmake -S tests -B build-afl && cmake --build build-afl
+ *              afl-fuzz -i seeds -o out -- build-afl/fuzz_tmf8828_decode @@
+ *
+ * The standalone driver (no TOF_FUZZ_LIBFUZZER) runs each file argument, or
+ * stdin without arguments. Define TOF_FUZZ_NO_MAIN to reuse the target.
+ */
+
+#define FUZZ_MM_LIMIT 12000u
+
+static void fuzz_fail(uint32_t block, const char *what, uint32_t zone)
+{
+    fprintf(stderr, "tmf8828_decode fuzz: block %u: %s (zone %u)\n", block, what, zone);
+    abort();
+}
+
+static void fuzz_check_mm(uint32_t block, const uint16_t *mm, uint32_t n, const char *what)
+{
+    for (uint32_t i = 0u; i < n; i++)
+    {
+        if (mm[i] >= FUZZ_MM_LIMIT)
+        {
+            fuzz_fail(block, what, i);
+        }
+    }
+}
+
+static void fuzz_decode_block(tmf8828_decoder_t *dec, const uint8_t block[TMF8828_RESULT_SIZE], uint32_t index)
+{
+    static tmf8828_decoder_t before;
+    uint16_t out_mm[64];
+    uint8_t out_conf[64];
+    bool complete = false;
+
+    before = *dec;
+    memset(out_mm, 0xA5, sizeof(out_mm));
+    if (!tmf8828_decode_result(dec, block, out_mm, out_conf, &complete))
+    {
+        if (memcmp(&before, dec, sizeof(before)) != 0)
+        {
+            fuzz_fail(index, "rejected block changed the decoder", 0u);
+        }
+        return;
+    }
+
+    fuzz_check_mm(index, dec->last_mm, 64u, "published distance out of range");
+    fuzz_check_mm(index, dec->alt_mm, 64u, "alternate distance out of range");
+    fuzz_check_mm(index, &dec->capture_mm[0][0], TMF8828_CAPTURE_COUNT_8X8 * TMF8828_ZONE_COUNT_8X8,
+                  "capture distance out of range");
+    if (memcmp(out_mm, dec->last_mm, sizeof(out_mm)) != 0)
+    {
+        fuzz_fail(index, "out_mm differs from the published grid", 0u);
+    }
+
+    const tmf8828_update_t *u = &dec->update;
+    if (u->capture >= TMF8828_CAPTURE_COUNT_8X8 || __builtin_popcountll(u->zone_mask) != (int)TMF8828_ZONE_COUNT_8X8)
+    {
+        fuzz_fail(index, "update does not cover one sub-capture", u->capture);
+    }
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        const bool changed = (out_mm[i] != before.last_mm[i]);
+        if (changed != (((u->changed_mask >> i) & 1u) != 0u))
+        {
+            fuzz_fail(index, "changed mask disagrees with the grid", i);
+        }
+    }
+    if (dec->capture_mask >= 0x0Fu || u->complete != complete)
+    {
+        fuzz_fail(index, "capture assembly state", dec->capture_mask);
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    static tmf8828_decoder_t dec;
+    tmf8828_decoder_reset(&dec);
+
+    uint32_t index = 0u;
+    for (size_t off = 0u; off < size; off += TMF8828_RESULT_SIZE)
+    {
+        uint8_t block[TMF8828_RESULT_SIZE];
+        const size_t n = ((size - off) < TMF8828_RESULT_SIZE) ? (size - off) : TMF8828_RESULT_SIZE;
+        memset(block, 0, sizeof(block));
+        memcpy(block, &data[off], n);
+        fuzz_decode_block(&dec, block, index++);
+    }
+    return 0;
+}
+
+#if !defined(TOF_FUZZ_LIBFUZZER) && !defined(TOF_FUZZ_NO_MAIN)
+static int fuzz_run_stream(FILE *f)
+{
+    size_t cap = 1u << 16;
+    size_t len = 0u;
+    uint8_t *buf = malloc(cap);
+    while (buf)
+    {
+        len += fread(&buf[len], 1u, cap - len, f);
+        if (len < cap)
+        {
+            break;
+        }
+        cap *= 2u;
+        buf = realloc(buf, cap);
+    }
+    if (!buf)
+    {
+        return 1;
+    }
+    LLVMFuzzerTestOneInput(buf, len);
+    free(buf);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        return fuzz_run_stream(stdin);
+    }
+    for (int i = 1; i < argc; i++)
+    {
+        FILE *f = fopen(argv[i], "rb");
+        if (!f)
+        {
+            fprintf(stderr, "cannot open %s\n", argv[i]);
+            return 1;
+        }
+        const int rc = fuzz_run_stream(f);
+        fclose(f);
+        if (rc != 0)
+        {
+            return rc;
+        }
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,5 @@
+#pragma once
+
+/* Host stand-in for the board app.h; see tests/host/host_board.c. */
+
+void BOARD_InitHardware(void);
@@ -0,0 +1,34 @@
+#pragma once
+
+/* Host stand-ins for the SDK pieces the demo sources use. Only what the
+ * host build needs is declared; hardware calls are no-ops in host_board.c.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int32_t status_t;
+
+enum
+{
+    kStatus_Success = 0,
+    kStatus_Fail = 1,
+    kStatus_ReadOnly = 2,
+    kStatus_OutOfRange = 3,
+    kStatus_InvalidArgument = 4,
+    kStatus_Timeout = 5,
+};
+
+#define MAKE_STATUS(group, code) ((((group) * 100) + (code)))
+
+#define SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY 150000000u
+
+void SDK_DelayAtLeastUs(uint32_t delayTime_us, uint32_t coreClock_Hz);
+
+typedef enum
+{
+    kCLOCK_Port4 = 0,
+} clock_ip_name_t;
+
+void CLOCK_EnableClock(clock_ip_name_t name);
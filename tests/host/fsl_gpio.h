@@ -0,0 +1,3 @@
+#pragma once
+
+#include "fsl_common.h"
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "fsl_common.h"
+
+typedef enum
+{
+    kGT911_IntPinPullUp = 0,
+    kGT911_IntPinPullDown,
+    kGT911_IntPinInput,
+} gt911_int_pin_mode_t;
+
+enum
+{
+    kGT911_I2cAddrAny = 0,
+};
+enum
+{
+    kGT911_IntFallingEdge = 0,
+};
+
+typedef status_t (*gt911_i2c_send_func_t)(uint8_t deviceAddress,
+                                          uint32_t subAddress,
+                                          uint8_t subaddressSize,
+                                          const uint8_t *txBuff,
+                                          uint8_t txBuffSize);
+typedef status_t (*gt911_i2c_receive_func_t)(uint8_t deviceAddress,
+                                             uint32_t subAddress,
+                                             uint8_t subaddressSize,
+                                             uint8_t *rxBuff,
+                                             uint8_t rxBuffSize);
+
+typedef struct
+{
+    gt911_i2c_send_func_t I2C_SendFunc;
+    gt911_i2c_receive_func_t I2C_ReceiveFunc;
+    void (*timeDelayMsFunc)(uint32_t delayMs);
+    void (*intPinFunc)(gt911_int_pin_mode_t mode);
+    void (*pullResetPinFunc)(bool pullUp);
+    uint8_t touchPointNum;
+    int i2cAddrMode;
+    int intTrigMode;
+} gt911_config_t;
+
+typedef struct
+{
+    uint16_t resolutionX;
+    uint16_t resolutionY;
+} gt911_handle_t;
+
+typedef struct
+{
+    bool valid;
+    uint8_t touchID;
+    uint16_t x;
+    uint16_t y;
+} touch_point_t;
+
+status_t GT911_Init(gt911_handle_t *handle, const gt911_config_t *config);
+status_t GT911_GetMultiTouch(gt911_handle_t *handle, uint8_t *touch_count, touch_point_t touch_array[]);
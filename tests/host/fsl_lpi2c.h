@@ -0,0 +1,35 @@
+#pragma once
+
+#include "fsl_common.h"
+
+typedef struct
+{
+    uint32_t unused;
+} LPI2C_Type;
+
+extern LPI2C_Type g_host_lpi2c2;
+#define LPI2C2 (&g_host_lpi2c2)
+
+typedef enum
+{
+    kLPI2C_Write = 0,
+    kLPI2C_Read = 1,
+} lpi2c_direction_t;
+
+enum
+{
+    kLPI2C_TransferDefaultFlag = 0,
+};
+
+typedef struct
+{
+    uint32_t flags;
+    uint16_t slaveAddress;
+    lpi2c_direction_t direction;
+    uint32_t subaddress;
+    size_t subaddressSize;
+    void *data;
+    size_t dataSize;
+} lpi2c_master_transfer_t;
+
+status_t LPI2C_MasterTransferBlocking(LPI2C_Type *base, lpi2c_master_transfer_t *transfer);
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "fsl_common.h"
+
+typedef struct
+{
+    uint32_t unused;
+} PORT_Type;
+
+extern PORT_Type g_host_port4;
+#define PORT4 (&g_host_port4)
+
+enum
+{
+    kPORT_PullDisable = 0,
+    kPORT_PullDown,
+    kPORT_PullUp,
+};
+enum
+{
+    kPORT_LowPullResistor = 0,
+    kPORT_HighPullResistor,
+};
+enum
+{
+    kPORT_FastSlewRate = 0,
+    kPORT_SlowSlewRate,
+};
+enum
+{
+    kPORT_PassiveFilterDisable = 0,
+    kPORT_PassiveFilterEnable,
+};
+enum
+{
+    kPORT_OpenDrainDisable = 0,
+    kPORT_OpenDrainEnable,
+};
+enum
+{
+    kPORT_LowDriveStrength = 0,
+    kPORT_HighDriveStrength,
+};
+enum
+{
+    kPORT_MuxAlt0 = 0,
+};
+enum
+{
+    kPORT_InputBufferDisable = 0,
+    kPORT_InputBufferEnable,
+};
+enum
+{
+    kPORT_InputNormal = 0,
+    kPORT_InputInvert,
+};
+enum
+{
+    kPORT_UnlockRegister = 0,
+    kPORT_LockRegister,
+};
+
+typedef struct
+{
+    int pullSelect;
+    int pullValueSelect;
+    int slewRate;
+    int passiveFilterEnable;
+    int openDrainEnable;
+    int driveStrength;
+    int mux;
+    int inputBuffer;
+    int invertInput;
+    int lockRegister;
+} port_pin_config_t;
+
+void PORT_SetPinConfig(PORT_Type *base, uint32_t pin, const port_pin_config_t *config);
@@ -0,0 +1,140 @@
+#include <string.h>
+
+#include "app.h"
+#include "fsl_common.h"
+#include "fsl_gt911.h"
+#include "fsl_lpi2c.h"
+#include "fsl_port.h"
+
+#include "tmf8828_quick.h"
+
+/* Board layer for host builds: no clocks, pins, touch panel or sensor.
+ * The live source reports no sensor, so host runs use the synthetic or
+ * replay sources.
+ */
+
+PORT_Type g_host_port4;
+LPI2C_Type g_host_lpi2c2;
+
+void BOARD_InitHardware(void)
+{
+}
+
+void SDK_DelayAtLeastUs(uint32_t delayTime_us, uint32_t coreClock_Hz)
+{
+    /* Ticks run back to back; realtime replay follows the tick count. */
+    (void)delayTime_us;
+    (void)coreClock_Hz;
+}
+
+void CLOCK_EnableClock(clock_ip_name_t name)
+{
+    (void)name;
+}
+
+void PORT_SetPinConfig(PORT_Type *base, uint32_t pin, const port_pin_config_t *config)
+{
+    (void)base;
+    (void)pin;
+    (void)config;
+}
+
+status_t LPI2C_MasterTransferBlocking(LPI2C_Type *base, lpi2c_master_transfer_t *transfer)
+{
+    (void)base;
+    (void)transfer;
+    return kStatus_Fail;
+}
+
+status_t GT911_Init(gt911_handle_t *handle, const gt911_config_t *config)
+{
+    (void)config;
+    memset(handle, 0, sizeof(*handle));
+    return kStatus_Fail;
+}
+
+status_t GT911_GetMultiTouch(gt911_handle_t *handle, uint8_t *touch_count, touch_point_t touch_array[])
+{
+    (void)handle;
+    (void)touch_array;
+    *touch_count = 0u;
+    return kStatus_Fail;
+}
+
+bool tmf8828_quick_init(void)
+{
+    return false;
+}
+
+bool tmf8828_quick_get_info(tmf8828_info_t *out)
+{
+    if (out)
+    {
+        memset(out, 0, sizeof(*out));
+    }
+    return false;
+}
+
+bool tmf8828_quick_read_8x8(uint16_t out_mm[64], bool *out_complete)
+{
+    (void)out_mm;
+    if (out_complete)
+    {
+        *out_complete = false;
+    }
+    return false;
+}
+
+bool tmf8828_quick_read_frame(tmf8828_frame_t *out, bool *out_complete)
+{
+    (void)out;
+    if (out_complete)
+    {
+        *out_complete = false;
+    }
+    return false;
+}
+
+bool tmf8828_quick_read_dual(tmf8828_dual_frame_t *out, bool *out_complete)
+{
+    (void)out;
+    if (out_complete)
+    {
+        *out_complete = false;
+    }
+    return false;
+}
+
+void tmf8828_quick_get_last_update(tmf8828_update_t *out)
+{
+    if (out)
+    {
+        memset(out, 0, sizeof(*out));
+    }
+}
+
+bool tmf8828_quick_restart_measurement(void)
+{
+    return false;
+}
+
+tmf8828_recover_tier_t tmf8828_quick_recover(void)
+{
+    return TMF8828_RECOVER_FAILED;
+}
+
+void tmf8828_quick_take_acq_stats(tmf8828_acq_stats_t *out)
+{
+    if (out)
+    {
+        memset(out, 0, sizeof(*out));
+    }
+}
+
+void tmf8828_quick_bus_lock(void)
+{
+}
+
+void tmf8828_quick_bus_unlock(void)
+{
+}
@@ -0,0 +1,115 @@
+#define TOF_DEMO_MAIN tof_demo_main
+#include "tof_demo.c"
+
+#include "platform/par_lcd_host.h"
+#include "tof_test.h"
+
+/* Brand mark through the line buffer: the box is recomposed from the
+ * spool-area background and the roll scene, then the glyphs go on top.
+ * The panel must end up exactly as with the glyphs filled straight onto
+ * it, including where the top of the roll scene reaches under the mark.
+ */
+
+#define TEST_FB_PX ((uint32_t)TOF_LCD_W * (uint32_t)TOF_LCD_H)
+
+static uint16_t s_scene_px[TEST_FB_PX];
+static uint16_t s_line_px[TEST_FB_PX];
+
+static void test_paint_scene(const tof_roll_scene_t *sc)
+{
+    display_hal_fill_rect(TOF_TP_X0, TOF_TP_Y0, TOF_TP_X1, TOF_TP_Y1, tof_tp_bg_color(255u, true));
+    tof_render_roll_scene(sc);
+}
+
+int main(void)
+{
+    if (!display_hal_init())
+    {
+        printf("display_hal_init failed\n");
+        return 1;
+    }
+    tof_ui_init();
+
+    uint32_t scene_under_mark = 0u;
+    for (uint32_t live = 0u; live < 2u; live++)
+    {
+        /* Flange tops from y 2 (under the mark) down to y 40 (clear of it). */
+        for (int32_t top = 2; top <= 40; top += 2)
+        {
+            const int32_t flange_ry = 96;
+            const int32_t cy = top + flange_ry;
+            const tof_roll_scene_t sc = {
+                .center_x = 385,
+                .depth = 60,
+                .cy = cy,
+                .roll_bottom = 230,
+                .back_cx = 355,
+                .front_cx = 415,
+                .flange_rx = 60,
+                .flange_ry = flange_ry,
+                .hub_outer_rx = 34,
+                .hub_outer_ry = 54,
+                .bore_rx = 20,
+                .bore_ry = 20,
+                .filament_rx = 55,
+                .filament_ry = 80,
+                .roll_x0 = TOF_TP_X0 + 50,
+                .roll_y0 = cy - flange_ry - 3,
+                .roll_x1 = TOF_TP_X1,
+                .roll_y1 = cy + flange_ry + 8,
+                .has_filament = true,
+                .render_live = (live != 0u),
+                .bar_segments = 5u,
+            };
+
+            test_paint_scene(&sc);
+            display_hal_flush();
+            memcpy(s_scene_px, par_lcd_host_framebuffer(), sizeof(s_scene_px));
+
+            s_tp_force_redraw = true;
+            tof_draw_brand_mark(&sc);
+            display_hal_flush();
+            memcpy(s_line_px, par_lcd_host_framebuffer(), sizeof(s_line_px));
+
+            /* Reference: the same glyphs with no canvas, one fill per pixel. */
+            test_paint_scene(&sc);
+            const tof_brand_mark_t mark = {
+                .scene = &sc,
+                .text = "(C)RICHARD HABERKERN",
+                .n = 20u,
+                .x0 = TOF_TP_X1 - 4 - 119 + 1,
+                .y0 = TOF_TP_Y0 + 4,
+                .x1 = TOF_TP_X1 - 4,
+                .y1 = TOF_TP_Y0 + 10,
+                .char_adv = 6,
+                .scale = 1u,
+                .fg = pack_rgb565(255u, 255u, 255u),
+            };
+            tof_brand_mark_draw(&mark);
+            display_hal_flush();
+            const uint16_t *ref = par_lcd_host_framebuffer();
+
+            uint32_t diff = 0u;
+            uint32_t lit = 0u;
+            for (uint32_t i = 0u; i < TEST_FB_PX; i++)
+            {
+                diff += (s_line_px[i] != ref[i]) ? 1u : 0u;
+                lit += (s_line_px[i] != s_scene_px[i]) ? 1u : 0u;
+            }
+            TOF_CHECK(diff == 0u, "live %u top %d: %u pixels differ", (unsigned)live, (int)top, (unsigned)diff);
+            TOF_CHECK(lit > 0u, "live %u top %d: no mark drawn", (unsigned)live, (int)top);
+
+            for (int32_t y = mark.y0; y <= mark.y1; y++)
+            {
+                for (int32_t x = mark.x0; x <= mark.x1; x++)
+                {
+                    const uint32_t i = ((uint32_t)y * (uint32_t)TOF_LCD_W) + (uint32_t)x;
+                    scene_under_mark += (s_scene_px[i] != tof_tp_bg_color(255u, true)) ? 1u : 0u;
+                }
+            }
+        }
+    }
+    TOF_CHECK(scene_under_mark > 0u, "the roll scene never reached under the mark");
+
+    return tof_test_finish("test_brand_mark");
+}
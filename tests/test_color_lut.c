@@ -0,0 +1,166 @@
+#define TOF_DEMO_MAIN tof_demo_main
+#include "tof_demo.c"
+
+#include "tof_test.h"
+
+/* Heatmap colour LUT: tof_color_lookup() after tof_color_lut_update() must
+ * give the colour the per-cell tof_color_from_mm() of the baseline gave, for
+ * every 16-bit distance and a spread of heatmap ranges, including near/far
+ * edges around TOF_HEATMAP_DARK_MM and inverted ranges. Also times the
+ * 64-cell colour pass both ways.
+ */
+
+/* tof_color_from_mm() as it was before the LUT. */
+static uint16_t ref_color_from_mm(uint16_t mm, uint16_t near_mm, uint16_t far_mm)
+{
+    if (!tof_mm_valid(mm))
+    {
+        return s_ui_invalid;
+    }
+
+    uint16_t color_far_mm = far_mm;
+    if (color_far_mm > TOF_HEATMAP_DARK_MM)
+    {
+        color_far_mm = TOF_HEATMAP_DARK_MM;
+    }
+    if (color_far_mm <= near_mm)
+    {
+        color_far_mm = (uint16_t)(near_mm + 1u);
+    }
+    if (mm < near_mm)
+    {
+        return s_ui_below_range;
+    }
+    if (mm > color_far_mm)
+    {
+        return s_ui_above_range;
+    }
+
+    uint32_t t = 0u;
+    if (mm <= near_mm)
+    {
+        t = 0u;
+    }
+    else if (mm >= color_far_mm)
+    {
+        t = 255u;
+    }
+    else
+    {
+        t = (uint32_t)(((uint32_t)(mm - near_mm) * 255u) / (color_far_mm - near_mm));
+    }
+
+    uint32_t r = 0u;
+    uint32_t g = 0u;
+    uint32_t b = 0u;
+    if (t < 128u)
+    {
+        const uint32_t u = t * 2u;
+        r = (u * 220u) / 255u;
+        g = 220u - ((u * 40u) / 255u);
+        b = 0u;
+    }
+    else
+    {
+        const uint32_t u = (t - 128u) * 2u;
+        r = 220u - ((u * 164u) / 255u);
+        g = 180u - ((u * 172u) / 255u);
+        b = (u * 8u) / 255u;
+    }
+    return pack_rgb565(r, g, b);
+}
+
+static uint32_t test_range(uint16_t near_mm, uint16_t far_mm)
+{
+    s_range_near_mm = near_mm;
+    s_range_far_mm = far_mm;
+    tof_color_lut_update();
+
+    uint32_t bad = 0u;
+    for (uint32_t mm = 0u; mm <= 0xFFFFu; mm++)
+    {
+        if (tof_color_lookup((uint16_t)mm) != ref_color_from_mm((uint16_t)mm, near_mm, far_mm))
+        {
+            bad++;
+        }
+    }
+    return bad;
+}
+
+static void test_bench(void)
+{
+    uint16_t mm[64];
+    uint32_t rng = 0x9E3779B9u;
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        mm[i] = (uint16_t)(20u + (tof_test_rand(&rng) % 120u));
+    }
+    s_range_near_mm = 30u;
+    s_range_far_mm = 90u;
+    tof_color_lut_update();
+
+    const uint32_t reps = 200000u;
+    volatile uint16_t sink = 0u;
+    const uint64_t t0 = tof_test_now_ns();
+    for (uint32_t k = 0u; k < reps; k++)
+    {
+        for (uint32_t i = 0u; i < 64u; i++)
+        {
+            sink ^= ref_color_from_mm(mm[i], s_range_near_mm, s_range_far_mm);
+        }
+        mm[k & 63u] ^= 1u;
+    }
+    const uint64_t t1 = tof_test_now_ns();
+    for (uint32_t k = 0u; k < reps; k++)
+    {
+        for (uint32_t i = 0u; i < 64u; i++)
+        {
+            sink ^= tof_color_lookup(mm[i]);
+        }
+        mm[k & 63u] ^= 1u;
+    }
+    const uint64_t t2 = tof_test_now_ns();
+    (void)sink;
+    printf("bench 64 cells: per-cell ramp %.0f ns, LUT %.0f ns\n", (double)(t1 - t0) / reps, (double)(t2 - t1) / reps);
+}
+
+int main(void)
+{
+    tof_ui_init();
+
+    static const uint16_t nears[] = {0u, 1u, 20u, 50u, 99u, 100u, 101u, 102u, 150u, 300u, 5000u, 11999u, 12000u};
+    static const uint16_t fars[] = {0u, 1u, 50u, 51u, 99u, 100u, 101u, 120u, 200u, 400u, 6000u, 12000u, 65535u};
+
+    uint32_t ranges = 0u;
+    uint32_t bad = 0u;
+    for (uint32_t a = 0u; a < (sizeof(nears) / sizeof(nears[0])); a++)
+    {
+        for (uint32_t b = 0u; b < (sizeof(fars) / sizeof(fars[0])); b++)
+        {
+            const uint32_t n = test_range(nears[a], fars[b]);
+            TOF_CHECK(n == 0u, "near %u far %u: %u distances differ", nears[a], fars[b], n);
+            bad += n;
+            ranges++;
+        }
+    }
+
+    /* Ranges as tof_update_range() moves them: small random steps, so the
+     * rebuild-on-change check is exercised as well as fresh builds.
+     */
+    uint32_t rng = 0x2545F491u;
+    uint16_t near_mm = 40u;
+    uint16_t far_mm = 80u;
+    for (uint32_t i = 0u; i < 200u; i++)
+    {
+        near_mm = (uint16_t)tof_clamp_i32((int32_t)near_mm + (int32_t)(tof_test_rand(&rng) % 7u) - 3, 0, 140);
+        far_mm = (uint16_t)tof_clamp_i32((int32_t)far_mm + (int32_t)(tof_test_rand(&rng) % 7u) - 3, 0, 160);
+        const uint32_t n = test_range(near_mm, far_mm);
+        TOF_CHECK(n == 0u, "step %u near %u far %u: %u distances differ", i, near_mm, far_mm, n);
+        bad += n;
+        ranges++;
+    }
+
+    printf("color lut: %u ranges x 65536 distances, %u differ\n", ranges, bad);
+    test_bench();
+    return tof_test_finish("color lut");
+}
@@ -0,0 +1,154 @@
+#define TOF_DEMO_MAIN tof_demo_main
+#include "tof_demo.c"
+
+#include "tof_test.h"
+
+/* Confidence weighting (TOF_CONF_WEIGHTING): tof_zone_weight_q8() over the
+ * confidence range and the estimator's weighted trimmed mean and centre
+ * blend on frames mixing strong and weak zones, against values worked out
+ * by hand below.
+ */
+
+static void test_frame_rows(uint16_t mm[64], uint8_t conf[64],
+                            uint16_t row0_mm, uint8_t row0_conf, uint16_t row7_mm, uint8_t row7_conf)
+{
+    memset(mm, 0, sizeof(uint16_t) * 64u);
+    memset(conf, 0, 64u);
+    for (uint32_t x = 0u; x < TOF_GRID_W; x++)
+    {
+        mm[x] = row0_mm;
+        conf[x] = row0_conf;
+        mm[(7u * TOF_GRID_W) + x] = row7_mm;
+        conf[(7u * TOF_GRID_W) + x] = row7_conf;
+    }
+}
+
+/* Centre 4x4 at centre_mm, the 48 zones around it at ring_mm. */
+static void test_frame_centre(uint16_t mm[64], uint8_t conf[64],
+                              uint16_t centre_mm, uint8_t centre_conf, uint16_t ring_mm, uint8_t ring_conf)
+{
+    for (uint32_t idx = 0u; idx < 64u; idx++)
+    {
+        const uint32_t x = idx % TOF_GRID_W;
+        const uint32_t y = idx / TOF_GRID_W;
+        const bool centre = (x >= 2u && x <= 5u) && (y >= 2u && y <= 5u);
+        mm[idx] = centre ? centre_mm : ring_mm;
+        conf[idx] = centre ? centre_conf : ring_conf;
+    }
+}
+
+static uint32_t test_measure(const uint16_t mm[64], const uint8_t conf[64], bool conf_live)
+{
+    memcpy(s_zone_conf, conf, sizeof(s_zone_conf));
+    s_zone_conf_live = conf_live;
+    tof_frame_summary_t s;
+    tof_frame_summary_build(mm, &s);
+    uint32_t mm_q8 = 0u;
+    TOF_CHECK(tof_estimator_measure_mm_q8(&s, &mm_q8), "no measurement");
+    return mm_q8;
+}
+
+int main(void)
+{
+    /* Weight table: linear up to TOF_CONF_FULL (64), floor at 32/256. */
+    static const struct
+    {
+        uint8_t conf;
+        uint32_t w_q8;
+    } k_weights[] = {
+        {0u, 32u}, {1u, 32u}, {7u, 32u}, {8u, 32u}, {9u, 36u}, {16u, 64u},
+        {32u, 128u}, {48u, 192u}, {63u, 252u}, {64u, 256u}, {200u, 256u}, {255u, 256u},
+    };
+    s_zone_conf_live = true;
+    for (uint32_t i = 0u; i < sizeof(k_weights) / sizeof(k_weights[0]); i++)
+    {
+        s_zone_conf[5] = k_weights[i].conf;
+        TOF_CHECK(tof_zone_weight_q8(5u) == k_weights[i].w_q8, "conf %u: weight %u, want %u",
+                  (unsigned)k_weights[i].conf, (unsigned)tof_zone_weight_q8(5u), (unsigned)k_weights[i].w_q8);
+    }
+    s_zone_conf_live = false;
+    for (uint32_t i = 0u; i < sizeof(k_weights) / sizeof(k_weights[0]); i++)
+    {
+        s_zone_conf[5] = k_weights[i].conf;
+        TOF_CHECK(tof_zone_weight_q8(5u) == 256u, "no plane, conf %u: weight %u",
+                  (unsigned)k_weights[i].conf, (unsigned)tof_zone_weight_q8(5u));
+    }
+
+    uint16_t mm[64];
+    uint8_t conf[64];
+
+    /* Rows 0 and 7 only: 16 valid zones, trim 2 each end, no centre blend.
+     * Kept: six 1000 mm zones at w 256 and six 1200 mm zones at w 64,
+     * (6*1000*256 + 6*1200*64) / (6*256 + 6*64) = 1040.
+     */
+    test_frame_rows(mm, conf, 1000u, 64u, 1200u, 16u);
+    uint32_t got = test_measure(mm, conf, true);
+    TOF_CHECK(got == (1040u << 8), "strong near, weak far: %u", (unsigned)(got >> 8));
+
+    /* Swapped: the strong zones pull toward 1200,
+     * (6*1000*64 + 6*1200*256) / 1920 = 1160.
+     */
+    test_frame_rows(mm, conf, 1000u, 16u, 1200u, 64u);
+    got = test_measure(mm, conf, true);
+    TOF_CHECK(got == (1160u << 8), "weak near, strong far: %u", (unsigned)(got >> 8));
+
+    /* Zero confidence on the far row still counts at the 32/256 floor:
+     * (6*1000*256 + 6*1200*32 + 864) / 1728 = 1022.
+     */
+    test_frame_rows(mm, conf, 1000u, 64u, 1200u, 0u);
+    got = test_measure(mm, conf, true);
+    TOF_CHECK(got == (1022u << 8), "zero-confidence far row: %u", (unsigned)(got >> 8));
+
+    /* All zones at zero confidence weigh the same: the plain trimmed mean,
+     * (6*1000 + 6*1200) / 12 = 1100, as with no confidence plane.
+     */
+    test_frame_rows(mm, conf, 1000u, 0u, 1200u, 0u);
+    got = test_measure(mm, conf, true);
+    TOF_CHECK(got == (1100u << 8), "all zero confidence: %u", (unsigned)(got >> 8));
+    test_frame_rows(mm, conf, 1000u, 64u, 1200u, 16u);
+    got = test_measure(mm, conf, false);
+    TOF_CHECK(got == (1100u << 8), "no confidence plane: %u", (unsigned)(got >> 8));
+
+    /* Full frame, trim 8 each end: strong 1000 mm centre, weak 1100 mm ring.
+     * Kept: eight 1000 mm zones at w 256 and forty 1100 mm zones at w 32,
+     * (2048000 + 1408000 + 1664) / 3328 = 1038; centre 1000;
+     * blend (1038*3 + 1000*2 + 2) / 5 = 1023.
+     */
+    test_frame_centre(mm, conf, 1000u, 64u, 1100u, 8u);
+    got = test_measure(mm, conf, true);
+    TOF_CHECK(got == (1023u << 8), "strong centre: %u", (unsigned)(got >> 8));
+
+    /* Same frame unweighted: (8*1000 + 40*1100) / 48 = 1083,
+     * blend (1083*3 + 1000*2 + 2) / 5 = 1050.
+     */
+    got = test_measure(mm, conf, false);
+    TOF_CHECK(got == (1050u << 8), "centre, no plane: %u", (unsigned)(got >> 8));
+
+    /* Weak centre at zero confidence against a strong ring: trimmed mean
+     * (8*1000*32 + 40*1100*256 + 5248) / 10496 = 1098; the centre blend
+     * weighs the centre zones only, all at the floor, so it stays 1000:
+     * (1098*3 + 1000*2 + 2) / 5 = 1059.
+     */
+    test_frame_centre(mm, conf, 1000u, 0u, 1100u, 64u);
+    got = test_measure(mm, conf, true);
+    TOF_CHECK(got == (1059u << 8), "zero-confidence centre: %u", (unsigned)(got >> 8));
+
+    /* Mixed centre: rows 2-3 strong at 1000 mm, rows 4-5 weak at 1200 mm,
+     * ring strong at 1100 mm. The trim drops both centre groups, so the
+     * mean is 1100; the centre is (8*1000*256 + 8*1200*64 + 1280) / 2560
+     * = 1040; blend (1100*3 + 1040*2 + 2) / 5 = 1076.
+     */
+    test_frame_centre(mm, conf, 1000u, 64u, 1100u, 64u);
+    for (uint32_t y = 4u; y <= 5u; y++)
+    {
+        for (uint32_t x = 2u; x <= 5u; x++)
+        {
+            mm[(y * TOF_GRID_W) + x] = 1200u;
+            conf[(y * TOF_GRID_W) + x] = 16u;
+        }
+    }
+    got = test_measure(mm, conf, true);
+    TOF_CHECK(got == (1076u << 8), "mixed centre: %u", (unsigned)(got >> 8));
+
+    return tof_test_finish("test_conf_weight");
+}
@@ -0,0 +1,192 @@
+#define TOF_FUZZ_NO_MAIN
+#include "fuzz_tmf8828_decode.c"
+
+#include "tof_test.h"
+
+/* tmf8828_decode_result() off target: the fuzz target's invariants over
+ * random block streams with corrupt sequence/capture ids and payloads, a
+ * scripted stream of bad ids against a clean one, and the decode rate.
+ */
+
+#define TEST_RANDOM_INPUTS 20000u
+#define TEST_BENCH_BLOCKS 1000000u
+
+static void test_put_entry(uint8_t *block, uint32_t raw, uint8_t conf0, uint16_t d0, uint8_t conf1, uint16_t d1)
+{
+    uint8_t *e = &block[24u + (raw * 6u)];
+    e[0] = conf0;
+    e[1] = (uint8_t)d0;
+    e[2] = (uint8_t)(d0 >> 8);
+    e[3] = conf1;
+    e[4] = (uint8_t)d1;
+    e[5] = (uint8_t)(d1 >> 8);
+}
+
+/* A plausible result block: spool surface distances with some dropouts and
+ * a second return behind the first.
+ */
+static void test_make_block(uint8_t block[TMF8828_RESULT_SIZE], uint8_t result_number, uint32_t *rng)
+{
+    memset(block, 0, TMF8828_RESULT_SIZE);
+    block[0] = 0x10u;
+    block[4] = result_number;
+    for (uint32_t raw = 0u; raw < 18u; raw++)
+    {
+        const uint32_t r = tof_test_rand(rng);
+        if ((r & 0xFu) == 0u)
+        {
+            continue;
+        }
+        const uint16_t d0 = (uint16_t)(40u + ((r >> 4) % 110u));
+        const uint16_t d1 = ((r >> 12) & 1u) ? (uint16_t)(d0 + 200u + ((r >> 13) % 400u)) : 0u;
+        test_put_entry(block, raw, (uint8_t)(30u + ((r >> 20) % 200u)), d0, (d1 > 0u) ? 20u : 0u, d1);
+    }
+}
+
+/* Random streams through the fuzz target; it aborts on a violated invariant. */
+static void test_random_streams(void)
+{
+    static uint8_t input[24u * TMF8828_RESULT_SIZE];
+    uint32_t rng = 0x1234567u;
+    uint64_t blocks = 0u;
+
+    for (uint32_t n = 0u; n < TEST_RANDOM_INPUTS; n++)
+    {
+        const uint32_t count = 1u + (tof_test_rand(&rng) % 24u);
+        for (uint32_t b = 0u; b < count; b++)
+        {
+            uint8_t *block = &input[b * TMF8828_RESULT_SIZE];
+            const uint32_t kind = tof_test_rand(&rng) % 8u;
+            test_make_block(block, (uint8_t)tof_test_rand(&rng), &rng);
+            if (kind == 0u)
+            {
+                /* Payload bytes anywhere, including distances >= 12000 mm
+                 * in either byte order.
+                 */
+                for (uint32_t i = 1u; i < TMF8828_RESULT_SIZE; i++)
+                {
+                    block[i] = (uint8_t)tof_test_rand(&rng);
+                }
+            }
+            else if (kind == 1u)
+            {
+                block[0] = (uint8_t)tof_test_rand(&rng);
+            }
+            else if (kind == 2u)
+            {
+                memset(&block[24], 0, TMF8828_RESULT_SIZE - 24u);
+            }
+            else if (kind == 3u)
+            {
+                for (uint32_t k = 0u; k < 8u; k++)
+                {
+                    block[tof_test_rand(&rng) % TMF8828_RESULT_SIZE] ^= (uint8_t)(1u << (tof_test_rand(&rng) % 8u));
+                }
+            }
+        }
+        const uint32_t tail = tof_test_rand(&rng) % TMF8828_RESULT_SIZE;
+        LLVMFuzzerTestOneInput(input, ((count - 1u) * TMF8828_RESULT_SIZE) + ((tail > 0u) ? tail : TMF8828_RESULT_SIZE));
+        blocks += count;
+    }
+    printf("random streams: %u inputs, %llu blocks, invariants held\n", TEST_RANDOM_INPUTS, (unsigned long long)blocks);
+}
+
+static uint32_t test_count_out_of_range(const uint16_t mm[64])
+{
+    uint32_t n = 0u;
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        n += (mm[i] >= FUZZ_MM_LIMIT) ? 1u : 0u;
+    }
+    return n;
+}
+
+/* Bad ids in an otherwise clean stream: repeated and skipped captures,
+ * sequence ids that jump, go backwards or change mid-cycle. last_mm must stay
+ * in range throughout and a clean cycle afterwards must complete normally.
+ */
+static void test_bad_ids(void)
+{
+    static const uint8_t ids[] = {
+        0x00u, 0x01u, 0x02u, 0x03u,        /* clean cycle, sequence 0 */
+        0x05u, 0x05u, 0x05u, 0x06u,        /* repeats */
+        0x0Bu, 0x04u, 0x13u, 0x0Cu,        /* sequence changes every block */
+        0xFFu, 0x00u, 0xFEu, 0x01u, 0xFDu, /* wrap around and back */
+        0x2Au, 0x28u, 0x2Bu,               /* missing capture */
+        0x80u, 0x81u, 0x82u, 0x83u,        /* clean cycle, sequence 32 */
+    };
+
+    tmf8828_decoder_t dec;
+    tmf8828_decoder_reset(&dec);
+    uint32_t rng = 0xC0FFEEu;
+    uint32_t bad = 0u;
+    uint32_t completes = 0u;
+    bool last_complete = false;
+    for (uint32_t i = 0u; i < (sizeof(ids) / sizeof(ids[0])); i++)
+    {
+        uint8_t block[TMF8828_RESULT_SIZE];
+        test_make_block(block, ids[i], &rng);
+        if ((i & 3u) == 1u)
+        {
+            /* Garbage distances on top of the bad id. */
+            for (uint32_t raw = 0u; raw < 18u; raw++)
+            {
+                test_put_entry(block, raw, 200u, (uint16_t)(12000u + raw), 200u, 0xFFFFu);
+            }
+        }
+        fuzz_decode_block(&dec, block, i);
+        bad += test_count_out_of_range(dec.last_mm);
+        completes += dec.update.complete ? 1u : 0u;
+        last_complete = dec.update.complete;
+    }
+
+    TOF_CHECK(bad == 0u, "%u published zones out of range", bad);
+    TOF_CHECK(last_complete, "final clean cycle did not complete");
+    printf("bad ids: %u blocks, %u out of range, %u complete cycles\n",
+           (unsigned)(sizeof(ids) / sizeof(ids[0])),
+           bad,
+           completes);
+}
+
+static void test_bench(void)
+{
+    enum
+    {
+        kBlocks = 256
+    };
+    static uint8_t blocks[kBlocks][TMF8828_RESULT_SIZE];
+    uint32_t rng = 0xBEEFu;
+    for (uint32_t i = 0u; i < kBlocks; i++)
+    {
+        test_make_block(blocks[i], (uint8_t)i, &rng);
+    }
+
+    tmf8828_decoder_t dec;
+    tmf8828_decoder_reset(&dec);
+    uint16_t mm[64];
+    uint8_t conf[64];
+    bool complete = false;
+    uint32_t decoded = 0u;
+    const uint64_t t0 = tof_test_now_ns();
+    for (uint32_t i = 0u; i < TEST_BENCH_BLOCKS; i++)
+    {
+        decoded += tmf8828_decode_result(&dec, blocks[i % kBlocks], mm, conf, &complete) ? 1u : 0u;
+    }
+    const uint64_t t1 = tof_test_now_ns();
+
+    TOF_CHECK(decoded == TEST_BENCH_BLOCKS, "%u of %u blocks decoded", decoded, TEST_BENCH_BLOCKS);
+    const double s = (double)(t1 - t0) / 1e9;
+    printf("bench: %u blocks in %.3f s, %.0f packets/s, %.0f ns/packet\n",
+           TEST_BENCH_BLOCKS,
+           s,
+           (double)TEST_BENCH_BLOCKS / s,
+           (double)(t1 - t0) / TEST_BENCH_BLOCKS);
+}
+
+int main(void)
+{
+    test_random_streams();
+    test_bad_ids();
+    test_bench();
+    return tof_test_finish("decode");
+}
@@ -0,0 +1,386 @@
+#define TOF_DEMO_MAIN tof_demo_main
+#include "tof_demo.c"
+
+#include "tof_test.h"
+
+/* The AI grid denoiser against the same denoiser with the neighbour median
+ * of the baseline: a bounds-checked 3x3 gather of the valid zones and an
+ * insertion sort (tof_ai_grid_median_u16). Outputs and filter state must
+ * match frame for frame over random streams with dropouts, duplicates, far
+ * and near outliers, and with the confidence plane on and off. Also times
+ * the median stage and the whole denoiser both ways.
+ */
+
+#define TEST_STREAMS 2000u
+#define TEST_STREAM_FRAMES 100u
+#define TEST_BENCH_FRAMES 200000u
+
+/* Baseline neighbour gather plus insertion-sort median. */
+static void ref_nbr_median(const uint16_t in_mm[64], uint16_t median[64], uint8_t count[64])
+{
+    for (uint32_t y = 0u; y < TOF_GRID_H; y++)
+    {
+        for (uint32_t x = 0u; x < TOF_GRID_W; x++)
+        {
+            uint16_t neighbors[9];
+            uint32_t ncount = 0u;
+            for (int32_t dy = -1; dy <= 1; dy++)
+            {
+                for (int32_t dx = -1; dx <= 1; dx++)
+                {
+                    const int32_t nx = (int32_t)x + dx;
+                    const int32_t ny = (int32_t)y + dy;
+                    if (nx < 0 || nx >= TOF_GRID_W || ny < 0 || ny >= TOF_GRID_H)
+                    {
+                        continue;
+                    }
+
+                    const uint16_t nv = in_mm[(uint32_t)ny * TOF_GRID_W + (uint32_t)nx];
+                    if (tof_mm_valid(nv))
+                    {
+                        neighbors[ncount++] = nv;
+                    }
+                }
+            }
+
+            const uint32_t idx = (y * TOF_GRID_W) + x;
+            median[idx] = tof_ai_grid_median_u16(neighbors, ncount);
+            count[idx] = (uint8_t)ncount;
+        }
+    }
+}
+
+/* tof_ai_denoise_heatmap_frame() for live data, median stage swapped for
+ * ref_nbr_median().
+ */
+static void ref_ai_denoise_live(const uint16_t in_mm[64], uint16_t out_mm[64])
+{
+    tof_frame_summary_t in_summary;
+    tof_frame_summary_build(in_mm, &in_summary);
+    const uint16_t outlier_threshold_mm = tof_ai_grid_outlier_threshold_mm(tof_frame_summary_spread_mm(&in_summary));
+    const uint16_t conf_q10 = tof_estimator_confidence_q10(&in_summary, true);
+
+    uint16_t nbr_median[64];
+    uint8_t nbr_count[64];
+    ref_nbr_median(in_mm, nbr_median, nbr_count);
+
+    uint16_t candidate[64];
+    uint32_t noise_sum = 0u;
+    uint32_t noise_count = 0u;
+
+    for (uint32_t idx = 0u; idx < 64u; idx++)
+    {
+        const uint16_t raw = in_mm[idx];
+
+        uint16_t pred = 0u;
+        bool have_pred = false;
+        if (nbr_count[idx] >= TOF_AI_GRID_NEIGHBOR_MIN)
+        {
+            pred = nbr_median[idx];
+            have_pred = true;
+        }
+        else if (tof_mm_valid(s_ai_grid_mm[idx]))
+        {
+            pred = s_ai_grid_mm[idx];
+            have_pred = true;
+        }
+
+        if (tof_mm_valid(raw))
+        {
+            uint16_t fused = raw;
+            if (have_pred)
+            {
+                const uint16_t delta = tof_abs_diff_u16(raw, pred);
+                noise_sum += delta;
+                noise_count++;
+                /* Weak returns have to agree more closely with their
+                 * neighbours before they are trusted.
+                 */
+                uint32_t zone_threshold_mm = (outlier_threshold_mm * tof_zone_weight_q8(idx)) >> 8;
+                if (zone_threshold_mm < TOF_AI_GRID_OUTLIER_MM_MIN)
+                {
+                    zone_threshold_mm = TOF_AI_GRID_OUTLIER_MM_MIN;
+                }
+                if (zone_threshold_mm > outlier_threshold_mm)
+                {
+                    zone_threshold_mm = outlier_threshold_mm;
+                }
+                if (delta > zone_threshold_mm)
+                {
+                    fused = (uint16_t)((((uint32_t)pred * 3u) + raw + 2u) / 4u);
+                }
+                else if (delta > (zone_threshold_mm / 2u))
+                {
+                    fused = (uint16_t)(((uint32_t)pred + raw + 1u) / 2u);
+                }
+            }
+            candidate[idx] = fused;
+        }
+        else if (have_pred)
+        {
+            candidate[idx] = pred;
+        }
+        else
+        {
+            candidate[idx] = 0u;
+        }
+    }
+
+    uint32_t slow_den = 6u;
+    if (conf_q10 >= 768u)
+    {
+        slow_den = 3u;
+    }
+    else if (conf_q10 >= 512u)
+    {
+        slow_den = 4u;
+    }
+    else if (conf_q10 >= 256u)
+    {
+        slow_den = 5u;
+    }
+
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        const uint16_t prev = s_ai_grid_mm[i];
+        const uint16_t cur = candidate[i];
+        uint16_t next = 0u;
+
+        if ((s_step_mask & ((uint64_t)1u << i)) == 0u)
+        {
+            out_mm[i] = prev;
+            continue;
+        }
+
+        if (tof_mm_valid(cur))
+        {
+            if (tof_mm_valid(prev))
+            {
+                const uint16_t delta = tof_abs_diff_u16(prev, cur);
+                uint32_t den = (delta >= TOF_AI_GRID_FAST_DELTA_MM) ? 2u : slow_den;
+#if TOF_CONF_WEIGHTING
+                if (s_zone_conf_live && den > 2u)
+                {
+                    /* Strong returns follow with less lag, weak ones are
+                     * smoothed harder.
+                     */
+                    const uint32_t w = tof_zone_weight_q8(i);
+                    if (w >= 256u)
+                    {
+                        den--;
+                    }
+                    else if (w < 128u)
+                    {
+                        den++;
+                    }
+                }
+#endif
+                next = (uint16_t)(((uint32_t)prev * (den - 1u) + cur + (den / 2u)) / den);
+            }
+            else
+            {
+                next = cur;
+            }
+            s_ai_grid_hold_age[i] = 0u;
+        }
+        else if (tof_mm_valid(prev) && (s_ai_grid_hold_age[i] < TOF_AI_GRID_HOLD_FRAMES))
+        {
+            s_ai_grid_hold_age[i]++;
+            next = prev;
+        }
+        else if (tof_mm_valid(prev))
+        {
+            next = (uint16_t)(((uint32_t)prev * 31u) / 32u);
+            if (next < 8u)
+            {
+                next = 0u;
+            }
+        }
+        else
+        {
+            next = 0u;
+        }
+
+        s_ai_grid_mm[i] = next;
+        out_mm[i] = next;
+    }
+
+    s_ai_grid_noise_mm = (noise_count > 0u) ? (uint16_t)(noise_sum / noise_count) : 0u;
+}
+
+typedef struct
+{
+    uint16_t grid_mm[64];
+    uint8_t hold_age[64];
+    uint16_t noise_mm;
+} test_dn_state_t;
+
+static void test_dn_save(test_dn_state_t *st)
+{
+    memcpy(st->grid_mm, s_ai_grid_mm, sizeof(st->grid_mm));
+    memcpy(st->hold_age, s_ai_grid_hold_age, sizeof(st->hold_age));
+    st->noise_mm = s_ai_grid_noise_mm;
+}
+
+static void test_dn_load(const test_dn_state_t *st)
+{
+    memcpy(s_ai_grid_mm, st->grid_mm, sizeof(st->grid_mm));
+    memcpy(s_ai_grid_hold_age, st->hold_age, sizeof(st->hold_age));
+    s_ai_grid_noise_mm = st->noise_mm;
+}
+
+/* A surface that drifts over the stream, with per-zone jitter, dropouts,
+ * duplicates (coarse quantisation), near spikes and far returns.
+ */
+static void test_make_frame(uint32_t f, uint32_t kind, uint32_t *rng, uint16_t mm[64])
+{
+    const uint32_t surface = 30u + ((f * (1u + kind)) % 200u);
+    const uint32_t drop = 4u + (kind % 12u);
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        const uint32_t r = tof_test_rand(rng);
+        uint32_t v = surface + (r % (1u + (kind * 7u)));
+        if ((kind & 1u) != 0u)
+        {
+            v &= ~7u;
+        }
+        if ((r >> 8) % drop == 0u)
+        {
+            v = ((r >> 16) & 1u) ? 0u : 12000u + ((r >> 17) % 3000u);
+        }
+        else if ((r >> 8) % 29u == 1u)
+        {
+            v = 1u + ((r >> 16) % 20u);
+        }
+        else if ((r >> 8) % 37u == 2u)
+        {
+            v = 400u + ((r >> 16) % 11599u);
+        }
+        mm[i] = (uint16_t)v;
+    }
+}
+
+static void test_randomise_conf(uint32_t *rng)
+{
+#if TOF_CONF_WEIGHTING
+    s_zone_conf_live = (tof_test_rand(rng) & 1u) != 0u;
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        s_zone_conf[i] = (uint8_t)tof_test_rand(rng);
+    }
+#else
+    (void)rng;
+#endif
+}
+
+static void test_equivalence(void)
+{
+    uint32_t rng = 0x1B873593u;
+    uint32_t frames = 0u;
+    uint32_t mismatches = 0u;
+    uint16_t mm[64];
+
+    for (uint32_t stream = 0u; stream < TEST_STREAMS && mismatches < 10u; stream++)
+    {
+        memset(s_ai_grid_mm, 0, sizeof(s_ai_grid_mm));
+        memset(s_ai_grid_hold_age, 0, sizeof(s_ai_grid_hold_age));
+        s_ai_grid_noise_mm = 0u;
+        const uint32_t kind = tof_test_rand(&rng) % 16u;
+
+        for (uint32_t f = 0u; f < TEST_STREAM_FRAMES; f++)
+        {
+            test_make_frame(f, kind, &rng, mm);
+            if ((f % 25u) == 0u)
+            {
+                test_randomise_conf(&rng);
+            }
+
+            test_dn_state_t before;
+            test_dn_state_t ref_state;
+            test_dn_state_t new_state;
+            uint16_t ref_out[64];
+            uint16_t new_out[64];
+
+            test_dn_save(&before);
+            ref_ai_denoise_live(mm, ref_out);
+            test_dn_save(&ref_state);
+            test_dn_load(&before);
+            tof_ai_denoise_heatmap_frame(mm, new_out, true);
+            test_dn_save(&new_state);
+            frames++;
+
+            const bool same = (memcmp(ref_out, new_out, sizeof(ref_out)) == 0) &&
+                              (memcmp(&ref_state, &new_state, sizeof(ref_state)) == 0);
+            TOF_CHECK(same, "stream %u frame %u: denoiser differs from the insertion-sort median", stream, f);
+            mismatches += same ? 0u : 1u;
+        }
+    }
+    printf("test_denoise_median: %u frames compared, %u differ\n", frames, mismatches);
+}
+
+static void test_bench(void)
+{
+    uint32_t rng = 0x85EBCA6Bu;
+    static uint16_t frames[64][64];
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        test_make_frame(i, i % 16u, &rng, frames[i]);
+    }
+
+    uint16_t median[64];
+    uint8_t count[64];
+    uint32_t sink = 0u;
+
+    uint64_t t0 = tof_test_now_ns();
+    for (uint32_t f = 0u; f < TEST_BENCH_FRAMES; f++)
+    {
+        ref_nbr_median(frames[f & 63u], median, count);
+        sink += median[f & 63u];
+    }
+    const uint64_t ref_ns = tof_test_now_ns() - t0;
+
+    t0 = tof_test_now_ns();
+    for (uint32_t f = 0u; f < TEST_BENCH_FRAMES; f++)
+    {
+        /* The denoiser takes the valid mask from its frame summary. */
+        tof_frame_summary_t in_summary;
+        tof_frame_summary_build(frames[f & 63u], &in_summary);
+        tof_grid_nbr_frame_t nbr;
+        tof_grid_nbr_load(&nbr, frames[f & 63u], in_summary.valid_mask);
+        tof_grid_nbr_reduce(&nbr, kTofGridNbrBox, kTofGridNbrMedian, TOF_ZONES_ALL, median, count);
+        sink += median[f & 63u];
+    }
+    const uint64_t new_ns = tof_test_now_ns() - t0;
+
+    uint16_t out[64];
+    t0 = tof_test_now_ns();
+    for (uint32_t f = 0u; f < TEST_BENCH_FRAMES; f++)
+    {
+        ref_ai_denoise_live(frames[f & 63u], out);
+        sink += out[f & 63u];
+    }
+    const uint64_t ref_dn_ns = tof_test_now_ns() - t0;
+
+    t0 = tof_test_now_ns();
+    for (uint32_t f = 0u; f < TEST_BENCH_FRAMES; f++)
+    {
+        tof_ai_denoise_heatmap_frame(frames[f & 63u], out, true);
+        sink += out[f & 63u];
+    }
+    const uint64_t new_dn_ns = tof_test_now_ns() - t0;
+
+    printf("test_denoise_median: ns per frame: median stage %llu (insertion sort) vs %llu (nbr engine), "
+           "denoiser %llu vs %llu (sink %u)\n",
+           (unsigned long long)(ref_ns / TEST_BENCH_FRAMES),
+           (unsigned long long)(new_ns / TEST_BENCH_FRAMES),
+           (unsigned long long)(ref_dn_ns / TEST_BENCH_FRAMES),
+           (unsigned long long)(new_dn_ns / TEST_BENCH_FRAMES),
+           (unsigned)sink);
+}
+
+int main(void)
+{
+    test_equivalence();
+    test_bench();
+    return tof_test_finish("test_denoise_median");
+}
@@ -0,0 +1,147 @@
+#define TOF_DEMO_MAIN tof_demo_main
+#include "tof_demo.c"
+
+#include "tof_test.h"
+
+/* The heatmap denoiser is stateful (s_ai_grid_mm, s_ai_grid_hold_age), so
+ * it must step exactly once per input frame. Runs main()'s per-tick order
+ * with the AI path on and checks that:
+ * - the heatmap draw steps the filter, and the spool model, debug panel and
+ *   alert UI after it leave the state alone;
+ * - in the raw draw path, the state after the draw equals one
+ *   tof_ai_denoise_heatmap_frame() call on the input from the state before;
+ * - the debug metrics read the frame the draw published.
+ * Built once per draw mode.
+ */
+
+#define TEST_FRAMES 400u
+#define TEST_GAP_FIRST 150u
+#define TEST_GAP_LAST 170u
+
+typedef struct
+{
+    uint16_t grid_mm[64];
+    uint8_t hold_age[64];
+    uint16_t noise_mm;
+} test_dn_state_t;
+
+static void test_dn_save(test_dn_state_t *st)
+{
+    memcpy(st->grid_mm, s_ai_grid_mm, sizeof(st->grid_mm));
+    memcpy(st->hold_age, s_ai_grid_hold_age, sizeof(st->hold_age));
+    st->noise_mm = s_ai_grid_noise_mm;
+}
+
+#if TOF_DEBUG_RAW_DRAW
+static void test_dn_load(const test_dn_state_t *st)
+{
+    memcpy(s_ai_grid_mm, st->grid_mm, sizeof(st->grid_mm));
+    memcpy(s_ai_grid_hold_age, st->hold_age, sizeof(st->hold_age));
+    s_ai_grid_noise_mm = st->noise_mm;
+}
+#endif
+
+static bool test_dn_equal(const test_dn_state_t *a, const test_dn_state_t *b)
+{
+    return (memcmp(a->grid_mm, b->grid_mm, sizeof(a->grid_mm)) == 0) &&
+           (memcmp(a->hold_age, b->hold_age, sizeof(a->hold_age)) == 0) && (a->noise_mm == b->noise_mm);
+}
+
+/* Surface with per-zone jitter, dropouts, far outliers and a few near
+ * spikes for the outlier rejection to work on.
+ */
+static void test_make_frame(uint32_t f, uint32_t *rng, uint16_t mm[64])
+{
+    const uint32_t surface = 40u + ((f * 3u) % 60u);
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        const uint32_t r = tof_test_rand(rng);
+        uint32_t v = surface + (r % 9u);
+        if ((r >> 8) % 9u == 0u)
+        {
+            v = 0u;
+        }
+        else if ((r >> 8) % 31u == 1u)
+        {
+            v = 12500u;
+        }
+        else if ((r >> 8) % 23u == 2u)
+        {
+            v = surface / 3u;
+        }
+        mm[i] = (uint16_t)v;
+    }
+}
+
+int main(void)
+{
+    if (!display_hal_init())
+    {
+        printf("display_hal_init failed\n");
+        return 1;
+    }
+    tof_ui_init();
+    s_ai_runtime_on = true;
+
+    uint16_t mm[64];
+    memset(mm, 0, sizeof(mm));
+    uint32_t rng = 0x6C078965u;
+    uint32_t draw_steps = 0u;
+    uint32_t metric_processed = 0u;
+
+    for (uint32_t tick = 0u; tick < TEST_FRAMES; tick++)
+    {
+        const bool live = (tick < TEST_GAP_FIRST) || (tick > TEST_GAP_LAST);
+        if (live)
+        {
+            test_make_frame(tick, &rng, mm);
+        }
+        s_frame_seq++;
+
+        test_dn_state_t before;
+        test_dn_state_t after_draw;
+        test_dn_state_t after_tick;
+        test_dn_save(&before);
+
+        display_hal_wait_idle();
+#if TOF_DEBUG_RAW_DRAW
+        tof_draw_heatmap_raw(mm, live);
+#else
+        tof_draw_heatmap_incremental(mm, live);
+#endif
+        test_dn_save(&after_draw);
+        draw_steps += test_dn_equal(&before, &after_draw) ? 0u : 1u;
+
+        tof_update_spool_model(mm, live, tick, true);
+        s_dbg_force_redraw = true;
+        tof_update_debug_panel(mm, live, live, live, live ? 0u : (tick - TEST_GAP_FIRST), 0u, tick);
+        tof_update_roll_alert_ui(s_roll_fullness_q10, live, tick);
+        display_hal_frame_end();
+        test_dn_save(&after_tick);
+        TOF_CHECK(test_dn_equal(&after_draw, &after_tick), "tick %u: denoiser stepped outside the heatmap draw", tick);
+
+        const tof_frame_summary_t *metric = tof_calc_metric_summary(mm, live);
+        if (live && metric->mm == s_processed_mm)
+        {
+            metric_processed++;
+        }
+        TOF_CHECK(!live || s_processed_summary.valid_count < TOF_EST_VALID_MIN || metric->mm == s_processed_mm,
+                  "tick %u: debug metrics did not read the published frame", tick);
+
+#if TOF_DEBUG_RAW_DRAW
+        /* Replay the one step from the saved state. */
+        uint16_t out[64];
+        test_dn_state_t replay;
+        test_dn_load(&before);
+        tof_ai_denoise_heatmap_frame(mm, out, live);
+        test_dn_save(&replay);
+        test_dn_load(&after_tick);
+        TOF_CHECK(test_dn_equal(&replay, &after_draw), "tick %u: draw state is not one denoiser step", tick);
+#endif
+    }
+
+    printf("test_denoise_once: %u frames, draw stepped the filter on %u, metrics on the processed frame %u\n",
+           TEST_FRAMES, draw_steps, metric_processed);
+    TOF_CHECK(draw_steps > (TEST_FRAMES / 2u), "draw stepped the filter on only %u frames", draw_steps);
+    return tof_test_finish("test_denoise_once");
+}
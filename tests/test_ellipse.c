@@ -0,0 +1,445 @@
+#define TOF_DEMO_MAIN tof_demo_main
+#include "tof_demo.c"
+
+#include "tof_test.h"
+
+/* Incremental ellipse spans against the isqrt-per-row rasterizer they
+ * replaced: half widths for every rx, ry up to 400, then pixels of filled
+ * ellipses, rings and annuli at random positions (partly off the TP area)
+ * rendered into a canvas covering the TP area, and the same shapes and the
+ * roll scene replayed in strips. Ends with the per-ellipse cost of both
+ * generators and the roll scene's cost in strips against one pass.
+ */
+
+#define TEST_CANVAS_W ((TOF_TP_X1 - TOF_TP_X0) + 1)
+#define TEST_CANVAS_H ((TOF_TP_Y1 - TOF_TP_Y0) + 1)
+#define TEST_BG 0x1234u
+
+static uint16_t s_new_px[TEST_CANVAS_W * TEST_CANVAS_H];
+static uint16_t s_ref_px[TEST_CANVAS_W * TEST_CANVAS_H];
+
+/* Reference: the removed tof_isqrt_u32 / tof_ellipse_half_width. */
+static uint32_t ref_isqrt_u32(uint32_t n)
+{
+    uint32_t op = n;
+    uint32_t res = 0u;
+    uint32_t one = (uint32_t)1u << 30;
+
+    while (one > op)
+    {
+        one >>= 2;
+    }
+    while (one != 0u)
+    {
+        if (op >= (res + one))
+        {
+            op -= (res + one);
+            res = (res >> 1) + one;
+        }
+        else
+        {
+            res >>= 1;
+        }
+        one >>= 2;
+    }
+    return res;
+}
+
+static int32_t ref_ellipse_half_width(int32_t rx, int32_t ry, int32_t y_abs)
+{
+    if (rx <= 0 || ry <= 0 || y_abs >= ry)
+    {
+        return 0;
+    }
+
+    const uint32_t ry_u = (uint32_t)ry;
+    const uint32_t y_u = (uint32_t)y_abs;
+    const uint32_t term = (ry_u * ry_u) - (y_u * y_u);
+    const uint32_t root = ref_isqrt_u32(term);
+    return (int32_t)(((uint64_t)(uint32_t)rx * (uint64_t)root) / (uint64_t)ry_u);
+}
+
+/* The removed tof_draw_filled_ellipse, into s_ref_px; mask (may be NULL)
+ * marks the pixels written.
+ */
+static void ref_fill_ellipse(int32_t cx, int32_t cy, int32_t rx, int32_t ry, uint16_t color, uint8_t *mask)
+{
+    if (rx <= 0 || ry <= 0)
+    {
+        return;
+    }
+
+    for (int32_t y = -ry; y <= ry; y++)
+    {
+        const int32_t y_abs = (y < 0) ? -y : y;
+        const int32_t xw = ref_ellipse_half_width(rx, ry, y_abs);
+        const int32_t py = cy + y;
+        if (py < TOF_TP_Y0 || py > TOF_TP_Y1)
+        {
+            continue;
+        }
+
+        const int32_t x0 = tof_clamp_i32(cx - xw, TOF_TP_X0, TOF_TP_X1);
+        const int32_t x1 = tof_clamp_i32(cx + xw, TOF_TP_X0, TOF_TP_X1);
+        for (int32_t x = x0; x <= x1; x++)
+        {
+            const int32_t i = ((py - TOF_TP_Y0) * TEST_CANVAS_W) + (x - TOF_TP_X0);
+            if (mask)
+            {
+                mask[i] = 1u;
+            }
+            else
+            {
+                s_ref_px[i] = color;
+            }
+        }
+    }
+}
+
+static uint8_t s_outer_mask[TEST_CANVAS_W * TEST_CANVAS_H];
+static uint8_t s_inner_mask[TEST_CANVAS_W * TEST_CANVAS_H];
+
+/* Annulus: the outer ellipse's pixels that the inner one would not cover. */
+static void ref_annulus(int32_t cx, int32_t cy, int32_t rx, int32_t ry, int32_t thickness, uint16_t color)
+{
+    memset(s_outer_mask, 0, sizeof(s_outer_mask));
+    memset(s_inner_mask, 0, sizeof(s_inner_mask));
+    ref_fill_ellipse(cx, cy, rx, ry, color, s_outer_mask);
+    if ((rx - thickness) > 0 && (ry - thickness) > 0)
+    {
+        ref_fill_ellipse(cx, cy, rx - thickness, ry - thickness, color, s_inner_mask);
+    }
+    for (uint32_t i = 0u; i < (uint32_t)(TEST_CANVAS_W * TEST_CANVAS_H); i++)
+    {
+        if (s_outer_mask[i] && !s_inner_mask[i])
+        {
+            s_ref_px[i] = color;
+        }
+    }
+}
+
+static void test_half_widths(void)
+{
+    uint32_t mismatches = 0u;
+    for (int32_t rx = 1; rx <= 400; rx++)
+    {
+        for (int32_t ry = 1; ry <= 400; ry++)
+        {
+            tof_ellipse_spans_t e;
+            tof_ellipse_spans_init(&e, rx, ry);
+            for (int32_t y = 0; y <= ry; y++)
+            {
+                const int32_t got = tof_ellipse_spans_next(&e);
+                const int32_t want = ref_ellipse_half_width(rx, ry, y);
+                if (got != want)
+                {
+                    mismatches++;
+                    TOF_CHECK(got == want, "rx=%d ry=%d y=%d: %d, reference %d", (int)rx, (int)ry, (int)y, (int)got, (int)want);
+                }
+            }
+        }
+    }
+    printf("half widths: 160000 ellipses, %u mismatches\n", (unsigned)mismatches);
+
+    /* Seeking to |y| and stepping on from there gives the same widths. */
+    uint32_t rng = 0x243F6A88u;
+    uint32_t seek_mismatches = 0u;
+    for (int32_t rx = 1; rx <= 400; rx++)
+    {
+        for (int32_t ry = 1; ry <= 400; ry++)
+        {
+            const int32_t y0 = (int32_t)(tof_test_rand(&rng) % (uint32_t)(ry + 1));
+            tof_ellipse_spans_t e;
+            tof_ellipse_spans_init(&e, rx, ry);
+            tof_ellipse_spans_seek(&e, y0);
+            for (int32_t y = y0; y <= ry; y++)
+            {
+                const int32_t got = tof_ellipse_spans_next(&e);
+                const int32_t want = ref_ellipse_half_width(rx, ry, y);
+                if (got != want)
+                {
+                    seek_mismatches++;
+                    TOF_CHECK(got == want, "seek %d: rx=%d ry=%d y=%d: %d, reference %d", (int)y0, (int)rx, (int)ry, (int)y,
+                              (int)got, (int)want);
+                }
+            }
+        }
+    }
+    printf("seek: 160000 ellipses, %u mismatches\n", (unsigned)seek_mismatches);
+}
+
+static void test_pixels(void)
+{
+    tof_canvas_t canvas = {
+        .px = s_new_px,
+        .x0 = TOF_TP_X0,
+        .y0 = TOF_TP_Y0,
+        .x1 = TOF_TP_X1,
+        .y1 = TOF_TP_Y1,
+    };
+    uint32_t rng = 0x9E3779B9u;
+    uint32_t bad_shapes = 0u;
+    const uint32_t trials = 1500u;
+
+    for (uint32_t t = 0u; t < trials; t++)
+    {
+        const int32_t cx = TOF_TP_X0 - 60 + (int32_t)(tof_test_rand(&rng) % (uint32_t)(TEST_CANVAS_W + 120));
+        const int32_t cy = -60 + (int32_t)(tof_test_rand(&rng) % (uint32_t)(TEST_CANVAS_H + 120));
+        const int32_t rx = (int32_t)(tof_test_rand(&rng) % 220u);
+        const int32_t ry = (int32_t)(tof_test_rand(&rng) % 200u);
+        const int32_t thickness = 1 + (int32_t)(tof_test_rand(&rng) % 24u);
+        const uint16_t ring = (uint16_t)tof_test_rand(&rng);
+        const uint16_t fill = (uint16_t)(ring ^ 0x5555u);
+        const uint32_t kind = t % 3u;
+
+        for (uint32_t i = 0u; i < (uint32_t)(TEST_CANVAS_W * TEST_CANVAS_H); i++)
+        {
+            s_new_px[i] = TEST_BG;
+            s_ref_px[i] = TEST_BG;
+        }
+
+        s_canvas = &canvas;
+        if (kind == 0u)
+        {
+            tof_draw_filled_ellipse(cx, cy, rx, ry, ring);
+            ref_fill_ellipse(cx, cy, rx, ry, ring, NULL);
+        }
+        else if (kind == 1u)
+        {
+            tof_draw_ellipse_ring(cx, cy, rx, ry, thickness, ring, fill);
+            if (rx > 0 && ry > 0)
+            {
+                ref_fill_ellipse(cx, cy, rx, ry, ring, NULL);
+                ref_fill_ellipse(cx, cy, rx - thickness, ry - thickness, fill, NULL);
+            }
+        }
+        else
+        {
+            tof_draw_ellipse_annulus(cx, cy, rx, ry, thickness, ring);
+            if (rx > 0 && ry > 0)
+            {
+                ref_annulus(cx, cy, rx, ry, thickness, ring);
+            }
+        }
+        s_canvas = NULL;
+
+        if (memcmp(s_new_px, s_ref_px, sizeof(s_new_px)) != 0)
+        {
+            bad_shapes++;
+            TOF_CHECK(false, "kind=%u c=(%d,%d) r=(%d,%d) t=%d differs", (unsigned)kind, (int)cx, (int)cy, (int)rx, (int)ry, (int)thickness);
+        }
+    }
+    printf("pixels: %u filled/ring/annulus shapes, %u differ\n", (unsigned)trials, (unsigned)bad_shapes);
+}
+
+/* A spool scene laid out as tof_update_spool_model() does for a full roll. */
+static const tof_roll_scene_t k_scene = {
+    .center_x = TOF_TP_X0 + 150,
+    .depth = 64,
+    .cy = 118,
+    .roll_bottom = 230,
+    .back_cx = TOF_TP_X0 + 118,
+    .front_cx = TOF_TP_X0 + 182,
+    .flange_rx = 120,
+    .flange_ry = 92,
+    .hub_outer_rx = 67,
+    .hub_outer_ry = 51,
+    .bore_rx = 28,
+    .bore_ry = 28,
+    .filament_rx = 115,
+    .filament_ry = 88,
+    .roll_x0 = TOF_TP_X0 + 18,
+    .roll_y0 = 23,
+    .roll_x1 = TOF_TP_X0 + 282,
+    .roll_y1 = 218,
+    .has_filament = true,
+    .render_live = true,
+    .bar_segments = TOF_ROLL_SEGMENT_COUNT,
+};
+
+/* Leave junk where the draw code keeps its tables, so a strip that reads
+ * rows it did not compute cannot pick up the previous strip's values.
+ */
+static void __attribute__((noinline)) test_scrub_stack(void)
+{
+    volatile uint8_t junk[4096];
+    for (uint32_t i = 0u; i < sizeof(junk); i++)
+    {
+        junk[i] = (uint8_t)(0xA5u ^ i);
+    }
+}
+
+static void test_draw_strips(int32_t rows, bool scrub, void (*draw)(const void *), const void *ctx)
+{
+    for (int32_t sy = TOF_TP_Y0; sy <= TOF_TP_Y1; sy += rows)
+    {
+        tof_canvas_t canvas = {
+            .px = &s_new_px[(sy - TOF_TP_Y0) * TEST_CANVAS_W],
+            .x0 = TOF_TP_X0,
+            .y0 = sy,
+            .x1 = TOF_TP_X1,
+            .y1 = ((sy + rows - 1) < TOF_TP_Y1) ? (sy + rows - 1) : TOF_TP_Y1,
+        };
+        if (scrub)
+        {
+            test_scrub_stack();
+        }
+        s_canvas = &canvas;
+        draw(ctx);
+        s_canvas = NULL;
+    }
+}
+
+static void test_draw_whole(void (*draw)(const void *), const void *ctx)
+{
+    test_draw_strips(TEST_CANVAS_H, false, draw, ctx);
+}
+
+typedef struct
+{
+    int32_t cx;
+    int32_t cy;
+    int32_t rx;
+    int32_t ry;
+    int32_t thickness;
+    uint16_t ring;
+    uint16_t fill;
+} test_shape_t;
+
+static void test_shape_draw(const void *ctx)
+{
+    const test_shape_t *sh = (const test_shape_t *)ctx;
+    tof_draw_ellipse_ring(sh->cx, sh->cy, sh->rx, sh->ry, sh->thickness, sh->ring, sh->fill);
+    tof_draw_ellipse_annulus(sh->cx + 7, sh->cy - 5, sh->rx / 2, sh->ry / 2, sh->thickness, sh->fill);
+}
+
+static void test_scene_draw(const void *ctx)
+{
+    tof_draw_roll_scene((const tof_roll_scene_t *)ctx);
+}
+
+static void test_fill_bg(void)
+{
+    for (uint32_t i = 0u; i < (uint32_t)(TEST_CANVAS_W * TEST_CANVAS_H); i++)
+    {
+        s_new_px[i] = TEST_BG;
+    }
+}
+
+/* Strip replay starts each generator at the strip's first row: any strip
+ * height must give the pixels of one pass over the whole area.
+ */
+static void test_strips(void)
+{
+    uint32_t rng = 0xB7E15162u;
+    uint32_t bad = 0u;
+    const uint32_t trials = 400u;
+
+    for (uint32_t t = 0u; t < trials; t++)
+    {
+        const test_shape_t sh = {
+            .cx = TOF_TP_X0 - 60 + (int32_t)(tof_test_rand(&rng) % (uint32_t)(TEST_CANVAS_W + 120)),
+            .cy = -60 + (int32_t)(tof_test_rand(&rng) % (uint32_t)(TEST_CANVAS_H + 120)),
+            .rx = (int32_t)(tof_test_rand(&rng) % 220u),
+            .ry = (int32_t)(tof_test_rand(&rng) % 200u),
+            .thickness = 1 + (int32_t)(tof_test_rand(&rng) % 24u),
+            .ring = (uint16_t)tof_test_rand(&rng),
+            .fill = (uint16_t)tof_test_rand(&rng),
+        };
+        const int32_t rows = 1 + (int32_t)(tof_test_rand(&rng) % 40u);
+
+        test_fill_bg();
+        test_draw_whole(test_shape_draw, &sh);
+        memcpy(s_ref_px, s_new_px, sizeof(s_ref_px));
+        test_fill_bg();
+        test_draw_strips(rows, true, test_shape_draw, &sh);
+        if (memcmp(s_new_px, s_ref_px, sizeof(s_new_px)) != 0)
+        {
+            bad++;
+            TOF_CHECK(false, "c=(%d,%d) r=(%d,%d) %d-row strips differ", (int)sh.cx, (int)sh.cy, (int)sh.rx, (int)sh.ry,
+                      (int)rows);
+        }
+    }
+
+    for (int32_t rows = 1; rows <= 40; rows++)
+    {
+        test_fill_bg();
+        test_draw_whole(test_scene_draw, &k_scene);
+        memcpy(s_ref_px, s_new_px, sizeof(s_ref_px));
+        test_fill_bg();
+        test_draw_strips(rows, true, test_scene_draw, &k_scene);
+        TOF_CHECK(memcmp(s_new_px, s_ref_px, sizeof(s_new_px)) == 0, "roll scene: %d-row strips differ", (int)rows);
+    }
+    printf("strips: %u shapes and the roll scene, %u differ\n", (unsigned)trials, (unsigned)bad);
+}
+
+static void test_bench(void)
+{
+    /* Back flange of the full spool: the largest ellipse drawn per frame. */
+    const int32_t rx = 120;
+    const int32_t ry = 92;
+    const uint32_t reps = 20000u;
+    volatile int32_t sink = 0;
+
+    const uint64_t t0 = tof_test_now_ns();
+    const uint64_t c0 = tof_test_cycles();
+    for (uint32_t k = 0u; k < reps; k++)
+    {
+        for (int32_t y = 0; y <= ry; y++)
+        {
+            sink += ref_ellipse_half_width(rx, ry + (int32_t)(k & 1u), y);
+        }
+    }
+    const uint64_t t1 = tof_test_now_ns();
+    const uint64_t c1 = tof_test_cycles();
+    for (uint32_t k = 0u; k < reps; k++)
+    {
+        tof_ellipse_spans_t e;
+        tof_ellipse_spans_init(&e, rx, ry + (int32_t)(k & 1u));
+        for (int32_t y = 0; y <= ry; y++)
+        {
+            sink += tof_ellipse_spans_next(&e);
+        }
+    }
+    const uint64_t t2 = tof_test_now_ns();
+    const uint64_t c2 = tof_test_cycles();
+    (void)sink;
+
+    printf("bench rx=%d ry=%d per ellipse: isqrt per row %.0f ns / %.0f cycles, incremental %.0f ns / %.0f cycles\n",
+           (int)rx,
+           (int)ry,
+           (double)(t1 - t0) / reps,
+           (double)(c1 - c0) / reps,
+           (double)(t2 - t1) / reps,
+           (double)(c2 - c1) / reps);
+
+    /* The roll scene as tof_render_roll_scene() replays it, in strips of
+     * TOF_TP_STRIP_PX, against one pass over the same rows.
+     */
+    const int32_t strip_rows = (int32_t)TOF_TP_STRIP_PX / TEST_CANVAS_W;
+    const uint32_t scene_reps = 200u;
+    const uint64_t s0 = tof_test_now_ns();
+    for (uint32_t k = 0u; k < scene_reps; k++)
+    {
+        test_draw_whole(test_scene_draw, &k_scene);
+    }
+    const uint64_t s1 = tof_test_now_ns();
+    for (uint32_t k = 0u; k < scene_reps; k++)
+    {
+        test_draw_strips(strip_rows, false, test_scene_draw, &k_scene);
+    }
+    const uint64_t s2 = tof_test_now_ns();
+    printf("bench roll scene: one pass %.0f ns, %d-row strips %.0f ns\n",
+           (double)(s1 - s0) / scene_reps,
+           (int)strip_rows,
+           (double)(s2 - s1) / scene_reps);
+}
+
+int main(void)
+{
+    test_half_widths();
+    test_pixels();
+    test_strips();
+    test_bench();
+    return tof_test_finish("ellipse");
+}
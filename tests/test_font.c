@@ -0,0 +1,72 @@
+#define GEN_TOF_FONT_NO_MAIN
+#include "../tools/gen_tof_font.c"
+
+#include "tof_font.h"
+#include "tof_test.h"
+
+/* The font tables in src/tof_font.h against the glyph sets they are
+ * generated from: every char value must index a glyph whose 3x5, 3x5 2x and
+ * 5x7 rows are exactly what the glyph switch gives for that char (lowercase
+ * folded, everything else on the '?' box). The font_header test checks that
+ * the checked-in header is the generator's current output.
+ */
+
+int main(void)
+{
+    uint32_t bad_index = 0u;
+    uint32_t bad_3x5 = 0u;
+    uint32_t bad_x2 = 0u;
+    uint32_t bad_5x7 = 0u;
+
+    for (int32_t c = -128; c < 128; c++)
+    {
+        const char ch = (char)c;
+        const uint32_t idx = tof_font_index(ch);
+        if (idx >= TOF_FONT_GLYPHS)
+        {
+            bad_index++;
+            continue;
+        }
+        const uint32_t u = (uint32_t)(uint8_t)ch;
+        if ((u >= TOF_FONT_FIRST) && (u < (TOF_FONT_FIRST + TOF_FONT_GLYPHS)) && (idx != (u - TOF_FONT_FIRST)))
+        {
+            bad_index++;
+        }
+
+        uint8_t rows[7];
+        gen_glyph_3x5(ch, rows);
+        const uint16_t g = g_tof_font3x5[idx];
+        const uint32_t g2 = g_tof_font3x5_x2[idx];
+        for (uint32_t y = 0u; y < 5u; y++)
+        {
+            if (((g >> (3u * (4u - y))) & 0x7u) != rows[y])
+            {
+                bad_3x5++;
+            }
+            for (uint32_t x = 0u; x < 6u; x++)
+            {
+                const uint32_t wide = (g2 >> ((6u * (4u - y)) + (5u - x))) & 1u;
+                if (wide != ((rows[y] >> (2u - (x / 2u))) & 1u))
+                {
+                    bad_x2++;
+                }
+            }
+        }
+
+        gen_glyph_5x7(ch, rows);
+        for (uint32_t y = 0u; y < 7u; y++)
+        {
+            if (g_tof_font5x7[idx][y] != rows[y])
+            {
+                bad_5x7++;
+            }
+        }
+    }
+
+    TOF_CHECK(bad_index == 0u, "%u chars index outside their glyph", bad_index);
+    TOF_CHECK(bad_3x5 == 0u, "%u 3x5 rows differ", bad_3x5);
+    TOF_CHECK(bad_x2 == 0u, "%u 3x5 2x pixels differ", bad_x2);
+    TOF_CHECK(bad_5x7 == 0u, "%u 5x7 rows differ", bad_5x7);
+    printf("font: 256 chars, index %u / 3x5 %u / 2x %u / 5x7 %u mismatches\n", bad_index, bad_3x5, bad_x2, bad_5x7);
+    return tof_test_finish("font");
+}
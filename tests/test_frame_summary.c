@@ -0,0 +1,287 @@
+#define TOF_DEMO_MAIN tof_demo_main
+#include "tof_demo.c"
+
+#include "tof_test.h"
+
+/* tof_frame_summary_build() against direct scans of the frame, and the
+ * consumers that now read its closest index and row minima (hotspot,
+ * closest-in-range distance, roll curve) against their baseline full-frame
+ * versions, over random frames with dropouts, out-of-range and near zones.
+ */
+
+#define TEST_FRAMES 200000u
+
+/* Baseline tof_calc_actual_distance_mm(). */
+static uint16_t ref_actual_distance_mm(const uint16_t mm[64])
+{
+    uint16_t closest_in_range = 0xFFFFu;
+    uint16_t closest_any = 0xFFFFu;
+
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        const uint16_t v = mm[i];
+        if (!tof_mm_valid(v))
+        {
+            continue;
+        }
+
+        if (v < closest_any)
+        {
+            closest_any = v;
+        }
+
+        if (v >= s_range_near_mm && v <= s_range_far_mm && v < closest_in_range)
+        {
+            closest_in_range = v;
+        }
+    }
+
+    if (closest_in_range != 0xFFFFu)
+    {
+        return closest_in_range;
+    }
+
+    if (closest_any != 0xFFFFu)
+    {
+        return closest_any;
+    }
+
+    return 0u;
+}
+
+/* Baseline tof_calc_roll_curve_distance_mm(). */
+static uint16_t ref_roll_curve_distance_mm(const uint16_t mm[64], int16_t row_pick_idx_out[TOF_GRID_H])
+{
+    uint16_t row_near_mm[TOF_GRID_H];
+    uint32_t row_count = 0u;
+
+    if (row_pick_idx_out != NULL)
+    {
+        for (uint32_t y = 0u; y < TOF_GRID_H; y++)
+        {
+            row_pick_idx_out[y] = -1;
+        }
+    }
+
+    for (uint32_t y = 0u; y < TOF_GRID_H; y++)
+    {
+        uint16_t low0 = 0xFFFFu;
+        uint16_t low1 = 0xFFFFu;
+        int32_t low0_idx = -1;
+        uint32_t valid = 0u;
+        const uint32_t row_base = y * TOF_GRID_W;
+        uint32_t x_start = TOF_TP_CURVE_EDGE_GUARD_COLS;
+        uint32_t x_end = TOF_GRID_W - TOF_TP_CURVE_EDGE_GUARD_COLS;
+        if (x_start >= x_end)
+        {
+            x_start = 0u;
+            x_end = TOF_GRID_W;
+        }
+
+        for (uint32_t x = x_start; x < x_end; x++)
+        {
+            const uint16_t v = mm[row_base + x];
+            if (!tof_mm_valid(v))
+            {
+                continue;
+            }
+
+            valid++;
+            if (v < low0)
+            {
+                low1 = low0;
+                low0 = v;
+                low0_idx = (int32_t)(row_base + x);
+            }
+            else if (v < low1)
+            {
+                low1 = v;
+            }
+        }
+
+        if (valid == 0u || low0 == 0xFFFFu)
+        {
+            continue;
+        }
+        if (row_pick_idx_out != NULL)
+        {
+            row_pick_idx_out[y] = (int16_t)low0_idx;
+        }
+
+        uint16_t row_mm = low0;
+        if (valid >= 3u && low1 != 0xFFFFu)
+        {
+            /* Use second-nearest sample per row to reduce single-pixel near outliers. */
+            row_mm = low1;
+        }
+        else if (valid >= 2u && low1 != 0xFFFFu)
+        {
+            row_mm = (uint16_t)(((uint32_t)low0 + (uint32_t)low1 + 1u) / 2u);
+        }
+        row_near_mm[row_count++] = row_mm;
+    }
+
+    if (row_count < TOF_TP_CURVE_MIN_ROWS)
+    {
+        return 0u;
+    }
+
+    for (uint32_t i = 1u; i < row_count; i++)
+    {
+        const uint16_t key = row_near_mm[i];
+        uint32_t j = i;
+        while (j > 0u && row_near_mm[j - 1u] > key)
+        {
+            row_near_mm[j] = row_near_mm[j - 1u];
+            j--;
+        }
+        row_near_mm[j] = key;
+    }
+
+    if ((row_count & 1u) == 0u)
+    {
+        const uint16_t a = row_near_mm[(row_count / 2u) - 1u];
+        const uint16_t b = row_near_mm[row_count / 2u];
+        return (uint16_t)(((uint32_t)a + (uint32_t)b + 1u) / 2u);
+    }
+    return row_near_mm[row_count / 2u];
+}
+
+/* Baseline tof_find_closest_idx(). */
+static int32_t ref_find_closest_idx(const uint16_t mm[64])
+{
+    int32_t best_idx = -1;
+    uint16_t best_mm = 0xFFFFu;
+
+    for (uint32_t i = 0; i < 64u; i++)
+    {
+        const uint16_t v = mm[i];
+        if (v >= TOF_LOCKED_NEAR_MM && v <= TOF_LOCKED_FAR_MM && v < best_mm)
+        {
+            best_mm = v;
+            best_idx = (int32_t)i;
+        }
+    }
+
+    return best_idx;
+}
+
+/* Spool-like frames: a surface band with dropouts, a few zones nearer than
+ * the locked range, some far or saturated zones, and now and then a whole
+ * row or frame missing.
+ */
+static void test_make_frame(uint16_t mm[64], uint32_t *rng)
+{
+    const uint32_t kind = tof_test_rand(rng) % 16u;
+    const uint16_t base = (uint16_t)(20u + (tof_test_rand(rng) % 180u));
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        const uint32_t r = tof_test_rand(rng);
+        switch (r % 20u)
+        {
+        case 0u:
+            mm[i] = 0u;
+            break;
+        case 1u:
+            mm[i] = (uint16_t)(12000u + ((r >> 8) % 4000u));
+            break;
+        case 2u:
+            mm[i] = (uint16_t)(1u + ((r >> 8) % 60u));
+            break;
+        case 3u:
+            mm[i] = (uint16_t)(200u + ((r >> 8) % 11800u));
+            break;
+        default:
+            mm[i] = (uint16_t)(base + ((r >> 8) % 40u));
+            break;
+        }
+    }
+    if (kind == 0u)
+    {
+        memset(mm, 0, 64u * sizeof(mm[0]));
+    }
+    else if (kind < 4u)
+    {
+        memset(&mm[(tof_test_rand(rng) % TOF_GRID_H) * TOF_GRID_W], 0, TOF_GRID_W * sizeof(mm[0]));
+    }
+}
+
+static void test_summary_fields(const uint16_t mm[64], const tof_frame_summary_t *s, uint32_t frame)
+{
+    uint32_t count = 0u;
+    uint16_t min_mm = 0u;
+    int32_t min_idx = -1;
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        if (!tof_mm_valid(mm[i]))
+        {
+            continue;
+        }
+        count++;
+        if (min_idx < 0 || mm[i] < min_mm)
+        {
+            min_mm = mm[i];
+            min_idx = (int32_t)i;
+        }
+    }
+    TOF_CHECK(s->valid_count == count, "frame %u: valid_count %u, want %u", frame, s->valid_count, count);
+    TOF_CHECK(s->min_mm == min_mm, "frame %u: min_mm %u, want %u", frame, s->min_mm, min_mm);
+    TOF_CHECK(s->min_idx == min_idx, "frame %u: min_idx %d, want %d", frame, s->min_idx, (int)min_idx);
+
+    for (uint32_t y = 0u; y < TOF_GRID_H; y++)
+    {
+        uint16_t row_min = 0u;
+        for (uint32_t x = 0u; x < TOF_GRID_W; x++)
+        {
+            const uint16_t v = mm[(y * TOF_GRID_W) + x];
+            if (tof_mm_valid(v) && (row_min == 0u || v < row_min))
+            {
+                row_min = v;
+            }
+        }
+        TOF_CHECK(s->row_min_mm[y] == row_min, "frame %u row %u: row_min %u, want %u", frame, y, s->row_min_mm[y],
+                  row_min);
+    }
+}
+
+int main(void)
+{
+    uint32_t rng = 0x9E3779B9u;
+    uint16_t mm[64];
+    tof_frame_summary_t s;
+    uint32_t hot_hits = 0u;
+
+    for (uint32_t frame = 0u; frame < TEST_FRAMES; frame++)
+    {
+        test_make_frame(mm, &rng);
+        tof_frame_summary_build(mm, &s);
+        test_summary_fields(mm, &s, frame);
+
+        const int32_t hot = tof_find_closest_idx(&s);
+        const int32_t hot_ref = ref_find_closest_idx(mm);
+        TOF_CHECK(hot == hot_ref, "frame %u: hotspot %d, want %d", frame, (int)hot, (int)hot_ref);
+        hot_hits += (hot >= 0) ? 1u : 0u;
+
+        s_range_near_mm = (uint16_t)(tof_test_rand(&rng) % 220u);
+        s_range_far_mm = (uint16_t)(s_range_near_mm + 1u + (tof_test_rand(&rng) % ((frame & 1u) ? 80u : 14000u)));
+        const uint16_t actual = tof_calc_actual_distance_mm(&s);
+        const uint16_t actual_ref = ref_actual_distance_mm(mm);
+        TOF_CHECK(actual == actual_ref, "frame %u: actual %u, want %u (range %u..%u)", frame, actual, actual_ref,
+                  s_range_near_mm, s_range_far_mm);
+
+        int16_t pick[TOF_GRID_H];
+        int16_t pick_ref[TOF_GRID_H];
+        const uint16_t curve = tof_calc_roll_curve_distance_mm(&s, pick);
+        const uint16_t curve_ref = ref_roll_curve_distance_mm(mm, pick_ref);
+        TOF_CHECK(curve == curve_ref, "frame %u: curve %u, want %u", frame, curve, curve_ref);
+        TOF_CHECK(memcmp(pick, pick_ref, sizeof(pick)) == 0, "frame %u: curve row picks differ", frame);
+
+        if (s_tof_test_failures > 20u)
+        {
+            break;
+        }
+    }
+
+    printf("test_frame_summary: %u frames, hotspot found in %u\n", TEST_FRAMES, hot_hits);
+    return tof_test_finish("test_frame_summary");
+}
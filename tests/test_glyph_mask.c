@@ -0,0 +1,116 @@
+#define TOF_DEMO_MAIN tof_demo_main
+#include "tof_demo.c"
+
+#include "tof_test.h"
+
+/* tof_draw_glyph_mask() into a canvas, which fills runs of lit pixels per
+ * mask row, against a per-pixel reference: every 5x7 and 3x5 glyph and the
+ * pre-doubled 3x5 rows, at several scales, placed partly outside the canvas
+ * and under random clip rectangles, plus 8-bit rows with the most runs.
+ */
+
+#define TEST_CANVAS_W 40
+#define TEST_CANVAS_H 30
+#define TEST_BG 0x1234u
+#define TEST_FG 0xFFFFu
+
+static uint16_t s_canvas_test_px[TEST_CANVAS_W * TEST_CANVAS_H];
+static uint16_t s_ref_px[TEST_CANVAS_W * TEST_CANVAS_H];
+
+static const tof_canvas_t s_test_canvas = {
+    .px = s_canvas_test_px,
+    .x0 = 100,
+    .y0 = 50,
+    .x1 = 100 + TEST_CANVAS_W - 1,
+    .y1 = 50 + TEST_CANVAS_H - 1,
+};
+
+static void ref_glyph(int32_t x, int32_t y, const uint8_t *rows, uint32_t h, uint32_t bits, uint32_t xscale,
+                      uint32_t yscale, int32_t clip_x0, int32_t clip_y0, int32_t clip_x1, int32_t clip_y1)
+{
+    for (int32_t py = s_test_canvas.y0; py <= s_test_canvas.y1; py++)
+    {
+        for (int32_t px = s_test_canvas.x0; px <= s_test_canvas.x1; px++)
+        {
+            if (px < x || py < y || px < clip_x0 || px > clip_x1 || py < clip_y0 || py > clip_y1)
+            {
+                continue;
+            }
+            const uint32_t col = (uint32_t)(px - x) / xscale;
+            const uint32_t ry = (uint32_t)(py - y) / yscale;
+            if (col >= bits || ry >= h || ((rows[ry] >> (bits - 1u - col)) & 0x1u) == 0u)
+            {
+                continue;
+            }
+            s_ref_px[((py - s_test_canvas.y0) * TEST_CANVAS_W) + (px - s_test_canvas.x0)] = TEST_FG;
+        }
+    }
+}
+
+static uint32_t s_cases = 0u;
+
+static void test_glyph(const uint8_t *rows, uint32_t h, uint32_t bits, uint32_t xscale, uint32_t yscale, uint32_t *rng)
+{
+    for (uint32_t k = 0u; k < 8u; k++)
+    {
+        const int32_t x = s_test_canvas.x0 - 12 + (int32_t)(tof_test_rand(rng) % 48u);
+        const int32_t y = s_test_canvas.y0 - 12 + (int32_t)(tof_test_rand(rng) % 36u);
+        int32_t clip_x0 = x - 2 + (int32_t)(tof_test_rand(rng) % 8u);
+        int32_t clip_y0 = y - 2 + (int32_t)(tof_test_rand(rng) % 8u);
+        int32_t clip_x1 = clip_x0 + (int32_t)(tof_test_rand(rng) % 30u);
+        int32_t clip_y1 = clip_y0 + (int32_t)(tof_test_rand(rng) % 30u);
+        if (k == 0u)
+        {
+            clip_x0 = 0;
+            clip_y0 = 0;
+            clip_x1 = TOF_LCD_W - 1;
+            clip_y1 = TOF_LCD_H - 1;
+        }
+
+        for (uint32_t i = 0u; i < (uint32_t)(TEST_CANVAS_W * TEST_CANVAS_H); i++)
+        {
+            s_canvas_test_px[i] = TEST_BG;
+            s_ref_px[i] = TEST_BG;
+        }
+        s_canvas = (tof_canvas_t *)&s_test_canvas;
+        tof_draw_glyph_mask(x, y, rows, h, bits, xscale, yscale, TEST_FG, clip_x0, clip_y0, clip_x1, clip_y1);
+        s_canvas = NULL;
+        ref_glyph(x, y, rows, h, bits, xscale, yscale, clip_x0, clip_y0, clip_x1, clip_y1);
+
+        TOF_CHECK(memcmp(s_canvas_test_px, s_ref_px, sizeof(s_ref_px)) == 0,
+                  "bits %u scale %ux%u at %d,%d clip %d,%d-%d,%d: canvas differs", (unsigned)bits, (unsigned)xscale,
+                  (unsigned)yscale, (int)x, (int)y, (int)clip_x0, (int)clip_y0, (int)clip_x1, (int)clip_y1);
+        s_cases++;
+    }
+}
+
+int main(void)
+{
+    uint32_t rng = 0x6A09E667u;
+
+    for (uint32_t idx = 0u; idx < TOF_FONT_GLYPHS; idx++)
+    {
+        uint8_t rows_3x5[TOF_DBG_CHAR_H];
+        uint8_t rows_x2[TOF_DBG_CHAR_H];
+        for (uint32_t ry = 0u; ry < TOF_DBG_CHAR_H; ry++)
+        {
+            rows_3x5[ry] = (uint8_t)((g_tof_font3x5[idx] >> (3u * (TOF_DBG_CHAR_H - 1u - ry))) & 0x7u);
+            rows_x2[ry] = (uint8_t)((g_tof_font3x5_x2[idx] >> (6u * (TOF_DBG_CHAR_H - 1u - ry))) & 0x3Fu);
+        }
+        for (uint32_t scale = 1u; scale <= 3u; scale++)
+        {
+            test_glyph(g_tof_font5x7[idx], 7u, 5u, scale, scale, &rng);
+            test_glyph(rows_3x5, TOF_DBG_CHAR_H, TOF_DBG_CHAR_W, scale, scale, &rng);
+        }
+        test_glyph(rows_x2, TOF_DBG_CHAR_H, 2u * TOF_DBG_CHAR_W, 1u, 2u, &rng);
+    }
+
+    static const uint8_t k_runs[] = {0xAAu, 0x55u, 0xFFu, 0x81u, 0x00u, 0x66u};
+    for (uint32_t scale = 1u; scale <= 3u; scale++)
+    {
+        test_glyph(k_runs, sizeof(k_runs), 8u, scale, 1u, &rng);
+    }
+
+    printf("test_glyph_mask: %u placements\n", (unsigned)s_cases);
+    return tof_test_finish("test_glyph_mask");
+}
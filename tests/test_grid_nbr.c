@@ -0,0 +1,183 @@
+#include "tof_grid_nbr.c"
+
+#include <stdbool.h>
+
+#include "tof_test.h"
+
+/* tof_grid_nbr against a bounds-checked 3x3 reference, for every shape and
+ * op over random frames and zone masks. Built twice: plain C, and the packed
+ * two-zone path with the DSP intrinsics from tests/acle/arm_acle.h, so both
+ * builds check against the same reference. test_denoise_median times the
+ * median against the insertion sort it replaced.
+ */
+
+#define TEST_FRAMES 200000u
+
+#if (TOF_GRID_NBR_LANES == 2u)
+#define TEST_NAME "test_grid_nbr_simd"
+#else
+#define TEST_NAME "test_grid_nbr"
+#endif
+
+static bool test_valid(uint16_t v)
+{
+    return (v > 0u) && (v < 12000u);
+}
+
+static uint64_t test_valid_mask(const uint16_t mm[64])
+{
+    uint64_t mask = 0u;
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        if (test_valid(mm[i]))
+        {
+            mask |= (uint64_t)1u << i;
+        }
+    }
+    return mask;
+}
+
+static void ref_reduce(const uint16_t mm[64],
+                       uint64_t valid_mask,
+                       tof_grid_nbr_shape_t shape,
+                       tof_grid_nbr_op_t op,
+                       uint32_t idx,
+                       uint16_t *value_out,
+                       uint8_t *count_out)
+{
+    uint16_t v[9];
+    uint32_t n = 0u;
+    const int32_t x = (int32_t)(idx & 7u);
+    const int32_t y = (int32_t)(idx >> 3);
+    for (int32_t dy = -1; dy <= 1; dy++)
+    {
+        for (int32_t dx = -1; dx <= 1; dx++)
+        {
+            const int32_t nx = x + dx;
+            const int32_t ny = y + dy;
+            if ((dx == 0 && dy == 0 && shape == kTofGridNbrRing) || nx < 0 || nx >= 8 || ny < 0 || ny >= 8)
+            {
+                continue;
+            }
+            const uint32_t j = ((uint32_t)ny * 8u) + (uint32_t)nx;
+            if ((valid_mask >> j) & 1u)
+            {
+                v[n++] = mm[j];
+            }
+        }
+    }
+
+    uint32_t value = 0u;
+    if (n > 0u && op == kTofGridNbrMedian)
+    {
+        for (uint32_t i = 1u; i < n; i++)
+        {
+            const uint16_t key = v[i];
+            uint32_t j = i;
+            while (j > 0u && v[j - 1u] > key)
+            {
+                v[j] = v[j - 1u];
+                j--;
+            }
+            v[j] = key;
+        }
+        value = v[n / 2u];
+    }
+    else if (n > 0u)
+    {
+        uint32_t sum = 0u;
+        for (uint32_t i = 0u; i < n; i++)
+        {
+            sum += v[i];
+        }
+        value = (op == kTofGridNbrMeanRound) ? ((sum + (n / 2u)) / n) : (sum / n);
+    }
+    *value_out = (uint16_t)value;
+    *count_out = (uint8_t)n;
+}
+
+/* Distances with ties, dropouts, out-of-range returns and the top of the
+ * 16-bit lane range the engine allows.
+ */
+static void test_make_frame(uint16_t mm[64], uint32_t *rng)
+{
+    const uint32_t kind = tof_test_rand(rng) % 6u;
+    const uint32_t holes = 1u + (tof_test_rand(rng) % 8u);
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        const uint32_t r = tof_test_rand(rng);
+        uint16_t v;
+        if (kind == 0u)
+        {
+            v = (uint16_t)(40u + ((r >> 8) % 4u));
+        }
+        else if (kind == 1u)
+        {
+            v = (uint16_t)(11990u + ((r >> 8) % 9u));
+        }
+        else
+        {
+            v = (uint16_t)(1u + ((r >> 8) % 11999u));
+        }
+        if ((r % holes) == 0u)
+        {
+            v = ((r >> 4) & 1u) ? 0u : (uint16_t)(12000u + ((r >> 5) % 50000u));
+        }
+        mm[i] = v;
+    }
+}
+
+static void test_reduce(void)
+{
+    static const tof_grid_nbr_op_t ops[4] = {kTofGridNbrCount, kTofGridNbrMean, kTofGridNbrMeanRound, kTofGridNbrMedian};
+    uint32_t rng = 0xC2B2AE35u;
+    uint32_t bad = 0u;
+
+    for (uint32_t f = 0u; f < TEST_FRAMES && bad < 10u; f++)
+    {
+        uint16_t mm[64];
+        test_make_frame(mm, &rng);
+        const uint64_t valid_mask = test_valid_mask(mm);
+        const tof_grid_nbr_shape_t shape = ((f & 1u) != 0u) ? kTofGridNbrBox : kTofGridNbrRing;
+        const tof_grid_nbr_op_t op = ops[(f >> 1) & 3u];
+        uint64_t zone_mask = ((uint64_t)tof_test_rand(&rng) << 32) | tof_test_rand(&rng);
+        if ((f % 7u) == 0u)
+        {
+            zone_mask = ~(uint64_t)0u;
+        }
+
+        tof_grid_nbr_frame_t nbr;
+        uint16_t value[64];
+        uint8_t count[64];
+        memset(value, 0xA5, sizeof(value));
+        memset(count, 0xA5, sizeof(count));
+        tof_grid_nbr_load(&nbr, mm, valid_mask);
+        tof_grid_nbr_reduce(&nbr, shape, op, zone_mask, value, count);
+
+        for (uint32_t idx = 0u; idx < 64u; idx++)
+        {
+            if (((zone_mask >> idx) & 1u) == 0u)
+            {
+                const bool untouched = (value[idx] == 0xA5A5u) && (count[idx] == 0xA5u);
+                TOF_CHECK(untouched, "frame %u zone %u: outside zone_mask but written", f, idx);
+                bad += untouched ? 0u : 1u;
+                continue;
+            }
+
+            uint16_t ref_value = 0u;
+            uint8_t ref_count = 0u;
+            ref_reduce(mm, valid_mask, shape, op, idx, &ref_value, &ref_count);
+            const bool same = (count[idx] == ref_count) && (op == kTofGridNbrCount || value[idx] == ref_value);
+            TOF_CHECK(same, "frame %u zone %u shape %d op %d: %u/%u, want %u/%u", f, idx, (int)shape, (int)op,
+                      value[idx], count[idx], ref_value, ref_count);
+            bad += same ? 0u : 1u;
+        }
+    }
+    printf("%s: reduce, %u frames, %u mismatches\n", TEST_NAME, TEST_FRAMES, bad);
+}
+
+int main(void)
+{
+    test_reduce();
+    return tof_test_finish(TEST_NAME);
+}
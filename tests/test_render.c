@@ -0,0 +1,138 @@
+#define TOF_DEMO_MAIN tof_demo_main
+#include "tof_demo.c"
+
+#include <stdlib.h>
+
+#include "platform/par_lcd_host.h"
+#include "tof_test.h"
+
+/* Render regression: runs the per-tick draw sequence of main() over a
+ * scripted spool sweep (full -> empty -> full with dropouts, out-of-range
+ * zones, a live gap and the alert popups) and fingerprints the framebuffer
+ * after every frame. A new hash means different pixels; update the golden
+ * value only for intended rendering changes. Built once per draw mode, and
+ * once more for the per-cell heatmap path (TOF_HEATMAP_BLIT 0).
+ */
+
+#define TEST_FRAMES 720u
+#define TEST_GAP_FIRST 260u
+#define TEST_GAP_LAST 300u
+
+#if TOF_DEBUG_RAW_DRAW
+#define TEST_GOLDEN_HASH 0x1c8d053a4040351dull
+#else
+#define TEST_GOLDEN_HASH 0xdbea23061570c867ull
+#endif
+
+static void test_make_frame(uint32_t f, uint32_t *rng, uint16_t mm[64])
+{
+    /* Surface distance sweeps 36 -> 84 mm and back over the run. */
+    const uint32_t half = TEST_FRAMES / 2u;
+    const uint32_t phase = (f < half) ? f : (TEST_FRAMES - f);
+    const uint32_t surface = 36u + ((phase * 48u) / half);
+
+    for (uint32_t y = 0u; y < 8u; y++)
+    {
+        for (uint32_t x = 0u; x < 8u; x++)
+        {
+            const uint32_t r = tof_test_rand(rng);
+            const uint32_t dx = (x < 4u) ? (3u - x) : (x - 4u);
+            uint32_t v = surface + (dx * dx) + (r % 5u);
+            if ((r >> 8) % 11u == 0u)
+            {
+                v = 0u;
+            }
+            else if ((r >> 8) % 53u == 1u)
+            {
+                v = 12500u;
+            }
+            else if ((x == 0u || x == 7u) && ((r >> 16) % 4u == 0u))
+            {
+                v = surface - 12u; /* flange hit */
+            }
+            mm[(y * 8u) + x] = (uint16_t)v;
+        }
+    }
+}
+
+int main(void)
+{
+    if (!display_hal_init())
+    {
+        printf("display_hal_init failed\n");
+        return 1;
+    }
+    tof_ui_init();
+
+    uint16_t mm[64];
+    memset(mm, 0, sizeof(mm));
+    uint32_t rng = 0x2545F491u;
+    uint64_t hash = TOF_TEST_HASH_INIT;
+    uint64_t fills = 0u;
+    uint64_t blits = 0u;
+    uint64_t selects = 0u;
+    uint64_t pixels = 0u;
+    par_lcd_host_take_stats(NULL);
+
+    for (uint32_t tick = 0u; tick < TEST_FRAMES; tick++)
+    {
+        if (tick == 120u || tick == 340u)
+        {
+            s_alert_runtime_on = !s_alert_runtime_on; /* as on a touch of the alert pill */
+        }
+        if (tick == 480u)
+        {
+            s_ai_runtime_on = !s_ai_runtime_on;
+        }
+
+        const bool live = (tick < TEST_GAP_FIRST) || (tick > TEST_GAP_LAST);
+        if (live)
+        {
+            test_make_frame(tick, &rng, mm);
+        }
+        s_frame_seq++;
+
+        /* Same order as the main loop. */
+        display_hal_wait_idle();
+        const bool popup_visible = s_alert_runtime_on && s_alert_popup_active;
+        if (!popup_visible)
+        {
+#if TOF_DEBUG_RAW_DRAW
+            tof_draw_heatmap_raw(mm, live);
+#else
+            tof_draw_heatmap_incremental(mm, live);
+#endif
+        }
+        tof_update_spool_model(mm, live, tick, true);
+        if (!popup_visible)
+        {
+            tof_update_debug_panel(mm, live, live, live, live ? 0u : (tick - TEST_GAP_FIRST), 0u, tick);
+        }
+        tof_update_roll_alert_ui(s_roll_fullness_q10, live, tick);
+        display_hal_frame_end();
+
+        hash = tof_test_hash(hash, par_lcd_host_framebuffer(), TOF_LCD_W * TOF_LCD_H * sizeof(uint16_t));
+        par_lcd_host_stats_t st;
+        par_lcd_host_take_stats(&st);
+        fills += st.fill_calls;
+        blits += st.blit_calls;
+        selects += st.window_selects;
+        pixels += st.pixels;
+    }
+
+    printf("frames=%u hash=0x%016llx per frame: fills=%llu blits=%llu selects=%llu px=%llu\n",
+           (unsigned)TEST_FRAMES,
+           (unsigned long long)hash,
+           (unsigned long long)(fills / TEST_FRAMES),
+           (unsigned long long)(blits / TEST_FRAMES),
+           (unsigned long long)(selects / TEST_FRAMES),
+           (unsigned long long)(pixels / TEST_FRAMES));
+    TOF_CHECK(hash == TEST_GOLDEN_HASH, "display hash 0x%016llx, golden 0x%016llx",
+              (unsigned long long)hash,
+              (unsigned long long)TEST_GOLDEN_HASH);
+    if (getenv("TOF_RENDER_PPM"))
+    {
+        TOF_CHECK(par_lcd_host_write_ppm(getenv("TOF_RENDER_PPM")), "cannot write %s", getenv("TOF_RENDER_PPM"));
+    }
+    return tof_test_finish("render");
+}
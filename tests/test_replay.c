@@ -0,0 +1,92 @@
+#define TOF_DEMO_MAIN tof_demo_main
+#include "tof_demo.c"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "tof_test.h"
+
+/* Replay through the real main loop: a binary capture with a long
+ * zero-valid stretch (long enough to trip the auto-recovery thresholds) must
+ * be consumed exactly once, one record per tick, and the loop must stop at
+ * the end of the capture. Built with TOF_DEBUG_INPUT_MODE 3 and incremental
+ * drawing, so the recovery paths are live; TEST_REALTIME replays on the
+ * recorded timeline instead.
+ */
+
+#define TEST_LIVE_HEAD 120u
+#define TEST_ZERO_RUN (TOF_ZERO_FRAME_REINIT_FRAMES + 100u)
+#define TEST_LIVE_TAIL 60u
+#define TEST_RECORDS (TEST_LIVE_HEAD + TEST_ZERO_RUN + TEST_LIVE_TAIL)
+#define TEST_RECORD_US (2u * TOF_FRAME_US)
+
+static void test_put_le(uint8_t *p, uint64_t v, uint32_t bytes)
+{
+    for (uint32_t i = 0u; i < bytes; i++)
+    {
+        p[i] = (uint8_t)(v >> (8u * i));
+    }
+}
+
+static bool test_write_capture(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f)
+    {
+        return false;
+    }
+
+    const uint8_t header[8] = {'T', 'O', 'F', 'C', 1u, 0u, 400u & 0xFFu, 400u >> 8};
+    bool ok = fwrite(header, sizeof(header), 1u, f) == 1u;
+    for (uint32_t r = 0u; ok && r < TEST_RECORDS; r++)
+    {
+        uint8_t rec[400];
+        memset(rec, 0, sizeof(rec));
+        test_put_le(&rec[0], (uint64_t)r * TEST_RECORD_US, 4u);
+        rec[4] = 0x03u; /* complete, has_conf */
+        test_put_le(&rec[8], ~(uint64_t)0u, 8u);
+        const bool zero = (r >= TEST_LIVE_HEAD) && (r < (TEST_LIVE_HEAD + TEST_ZERO_RUN));
+        for (uint32_t i = 0u; i < 64u; i++)
+        {
+            const uint32_t mm = zero ? 0u : (45u + ((r + i) % 7u));
+            test_put_le(&rec[16u + (i * 2u)], mm, 2u);
+            rec[272u + i] = zero ? 0u : 200u;
+        }
+        ok = fwrite(rec, sizeof(rec), 1u, f) == 1u;
+    }
+    return (fclose(f) == 0) && ok;
+}
+
+int main(void)
+{
+    char path[] = "/tmp/tof_replay_XXXXXX";
+    const int fd = mkstemp(path);
+    TOF_CHECK(fd >= 0, "mkstemp");
+    if (fd < 0)
+    {
+        return tof_test_finish("replay");
+    }
+    close(fd);
+    TOF_CHECK(test_write_capture(path), "cannot write %s", path);
+
+#if TEST_REALTIME
+    tof_source_replay_configure(path, true, TOF_FRAME_US);
+    /* Records are two ticks apart; the read after the last one ends it. */
+    const uint32_t expect_ticks = 2u * TEST_RECORDS;
+#else
+    tof_source_replay_configure(path, false, TOF_FRAME_US);
+    const uint32_t expect_ticks = TEST_RECORDS + 1u;
+#endif
+    (void)tof_demo_main();
+    remove(path);
+
+    display_hal_frame_stats_t frame;
+    display_hal_get_frame_stats(&frame);
+    printf("records=%u replayed=%u ticks=%u\n",
+           (unsigned)TEST_RECORDS,
+           (unsigned)tof_source_replay_frames(),
+           (unsigned)frame.frame);
+    TOF_CHECK(tof_source_replay_frames() == TEST_RECORDS, "replayed %u records", (unsigned)tof_source_replay_frames());
+    TOF_CHECK(frame.frame == expect_ticks, "ran %u ticks, expected %u", (unsigned)frame.frame, (unsigned)expect_ticks);
+    return tof_test_finish("replay");
+}
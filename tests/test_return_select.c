@@ -0,0 +1,210 @@
+#define TOF_DEMO_MAIN tof_demo_main
+#include "tof_demo.c"
+
+#include "tof_test.h"
+
+/* Return selection (TOF_RETURN_SELECT) on dual-return frames: primary and
+ * alternate picks against the reference, the TOF_RETURN_SELECT_MARGIN_MM
+ * tie, no reference yet, where the reference comes from, and a reference
+ * swept across the margin in both directions. Last, the lock-on case
+ * through the spool model: a flange patch on the primary return while the
+ * surface unwinds toward the flange and back, which must end on the
+ * surface again.
+ */
+
+static void test_frame_dual(tmf8828_dual_frame_t *f, uint16_t mm0, uint16_t mm1)
+{
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        f->mm[0][i] = mm0;
+        f->mm[1][i] = mm1;
+        f->conf[0][i] = 50u;
+        f->conf[1][i] = 20u;
+    }
+}
+
+/* Twelve zones, rows 1-4 by columns 1-3 (inside the curve picker's edge
+ * guard), see a flange on the primary return and the surface behind it;
+ * every other zone sees only the surface.
+ */
+static bool test_patch_zone(uint32_t idx)
+{
+    const uint32_t x = idx % TOF_GRID_W;
+    const uint32_t y = idx / TOF_GRID_W;
+    return (y >= 1u && y <= 4u) && (x >= 1u && x <= 3u);
+}
+
+static void test_frame_flange(tmf8828_dual_frame_t *f, uint16_t surface_mm, uint16_t flange_mm)
+{
+    memset(f, 0, sizeof(*f));
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        f->mm[0][i] = surface_mm;
+        f->conf[0][i] = 64u;
+        if (test_patch_zone(i))
+        {
+            f->mm[0][i] = flange_mm;
+            f->mm[1][i] = surface_mm;
+            f->conf[1][i] = 40u;
+        }
+    }
+}
+
+static void test_lock_on(bool ai_on)
+{
+    static const uint16_t k_down[] = {56u, 56u, 56u, 56u, 55u, 54u, 53u, 52u, 51u, 50u, 49u, 48u, 47u, 46u, 45u, 45u, 45u};
+    const uint16_t flange_mm = 40u;
+
+    s_ai_runtime_on = ai_on;
+    s_tp_mm_q8 = 0u;
+    s_tp_last_tick = 0u;
+    s_surface_ref_mm = 0u;
+    s_est_mm_q8 = 0u;
+    s_zone_conf_live = true;
+
+    uint16_t path[27u + 60u];
+    uint32_t n = 0u;
+    for (uint32_t i = 0u; i < sizeof(k_down) / sizeof(k_down[0]); i++)
+    {
+        path[n++] = k_down[i];
+    }
+    for (uint16_t s = 46u; s <= 55u; s++)
+    {
+        path[n++] = s;
+    }
+    while (n < sizeof(path) / sizeof(path[0]))
+    {
+        path[n++] = 56u;
+    }
+
+    uint32_t tick = 0u;
+    for (uint32_t k = 0u; k < n; k++)
+    {
+        const uint16_t surface_mm = path[k];
+        tmf8828_dual_frame_t f;
+        uint16_t mm[64];
+        test_frame_flange(&f, surface_mm, flange_mm);
+        tof_select_returns(&f, mm, s_zone_conf);
+
+        /* The surface zones set the reference, so the patch follows the
+         * surface until it comes within the margin of the flange.
+         */
+        TOF_CHECK(s_return_ref_mm == surface_mm, "ai %u frame %u: ref %u, surface %u", (unsigned)ai_on,
+                  (unsigned)k, (unsigned)s_return_ref_mm, (unsigned)surface_mm);
+        const uint16_t want = ((surface_mm - flange_mm) > TOF_RETURN_SELECT_MARGIN_MM) ? surface_mm : flange_mm;
+        for (uint32_t i = 0u; i < 64u; i++)
+        {
+            if (test_patch_zone(i))
+            {
+                TOF_CHECK(mm[i] == want, "ai %u frame %u surface %u zone %u: picked %u, want %u", (unsigned)ai_on,
+                          (unsigned)k, (unsigned)surface_mm, (unsigned)i, (unsigned)mm[i], (unsigned)want);
+            }
+        }
+
+        tick += TOF_TP_UPDATE_TICKS;
+        tof_update_spool_model(mm, true, tick, false);
+        if (s_surface_ref_mm != 0u)
+        {
+            TOF_CHECK(s_surface_ref_mm == tof_tp_mm_to_sensor_mm((uint16_t)((s_tp_mm_q8 + 128u) >> 8)),
+                      "ai %u frame %u: model ref %u", (unsigned)ai_on, (unsigned)k, (unsigned)s_surface_ref_mm);
+        }
+    }
+
+    /* Held at 56 mm after the sweep: the model is back on the surface. */
+    TOF_CHECK(s_surface_ref_mm >= 54u && s_surface_ref_mm <= 56u, "ai %u: model ref %u after the sweep",
+              (unsigned)ai_on, (unsigned)s_surface_ref_mm);
+}
+
+int main(void)
+{
+    tmf8828_dual_frame_t f;
+    uint16_t mm[64];
+    uint8_t conf[64];
+
+    /* No single-return zones and no model surface yet: the primary return
+     * passes through, invalid or not.
+     */
+    test_frame_dual(&f, 800u, 500u);
+    f.mm[0][3] = 0u;
+    s_surface_ref_mm = 0u;
+    s_return_swaps = 0u;
+    tof_select_returns(&f, mm, conf);
+    TOF_CHECK(s_return_ref_mm == 0u, "no reference: ref %u", (unsigned)s_return_ref_mm);
+    TOF_CHECK(memcmp(mm, f.mm[0], sizeof(mm)) == 0 && memcmp(conf, f.conf[0], sizeof(conf)) == 0,
+              "no reference: frame changed");
+    TOF_CHECK(s_return_swaps == 0u, "no reference: %u swaps", (unsigned)s_return_swaps);
+
+    /* All zones dual: the model surface (500 mm) is the reference. */
+    test_frame_dual(&f, 502u, 800u);
+    f.mm[0][1] = 800u; /* alternate closer */
+    f.mm[1][1] = 501u;
+    f.mm[0][2] = 510u; /* 4 + margin == 10: tie keeps the primary */
+    f.mm[1][2] = 496u;
+    f.mm[0][3] = 510u; /* 3 + margin < 10: swap */
+    f.mm[1][3] = 497u;
+    f.mm[0][4] = 0u; /* no primary */
+    f.mm[1][4] = 900u;
+    f.mm[0][5] = 900u; /* alternate out of range */
+    f.mm[1][5] = 12000u;
+    s_surface_ref_mm = 500u;
+    s_return_swaps = 0u;
+    tof_select_returns(&f, mm, conf);
+    TOF_CHECK(s_return_ref_mm == 500u, "model reference: ref %u", (unsigned)s_return_ref_mm);
+    static const struct
+    {
+        uint32_t zone;
+        uint16_t mm;
+        uint8_t conf;
+    } k_picks[] = {
+        {0u, 502u, 50u}, {1u, 501u, 20u}, {2u, 510u, 50u}, {3u, 497u, 20u}, {4u, 900u, 20u}, {5u, 900u, 50u},
+    };
+    for (uint32_t i = 0u; i < sizeof(k_picks) / sizeof(k_picks[0]); i++)
+    {
+        const uint32_t z = k_picks[i].zone;
+        TOF_CHECK(mm[z] == k_picks[i].mm && conf[z] == k_picks[i].conf, "zone %u: %u mm conf %u, want %u mm conf %u",
+                  (unsigned)z, (unsigned)mm[z], (unsigned)conf[z], (unsigned)k_picks[i].mm, (unsigned)k_picks[i].conf);
+    }
+    TOF_CHECK(s_return_swaps == 3u, "model reference: %u swaps", (unsigned)s_return_swaps);
+
+    /* 16 single-return zones at 600 mm outvote the model surface; with 15
+     * the model surface is used.
+     */
+    for (uint32_t singles = 15u; singles <= 16u; singles++)
+    {
+        test_frame_dual(&f, 450u, 603u);
+        for (uint32_t i = 0u; i < singles; i++)
+        {
+            f.mm[0][63u - i] = 600u;
+            f.mm[1][63u - i] = 0u;
+        }
+        s_surface_ref_mm = 450u;
+        tof_select_returns(&f, mm, conf);
+        const bool own_ref = (singles >= TOF_RETURN_SELECT_REF_ZONES_MIN);
+        TOF_CHECK(s_return_ref_mm == (own_ref ? 600u : 450u), "%u singles: ref %u", (unsigned)singles,
+                  (unsigned)s_return_ref_mm);
+        TOF_CHECK(mm[0] == (own_ref ? 603u : 450u), "%u singles: picked %u", (unsigned)singles, (unsigned)mm[0]);
+    }
+
+    /* Reference swept up across the margin and back: flange 500 mm on the
+     * primary, surface 530 mm on the alternate. (530 - ref) + 6 < ref - 500
+     * holds from ref 519 up, in both directions.
+     */
+    test_frame_dual(&f, 500u, 530u);
+    for (uint32_t pass = 0u; pass < 2u; pass++)
+    {
+        for (uint32_t step = 0u; step <= 80u; step++)
+        {
+            const uint16_t ref = (uint16_t)((pass == 0u) ? (480u + step) : (560u - step));
+            s_surface_ref_mm = ref;
+            tof_select_returns(&f, mm, conf);
+            const uint16_t want = (ref >= 519u) ? 530u : 500u;
+            TOF_CHECK(mm[0] == want, "sweep %u ref %u: picked %u, want %u", (unsigned)pass, (unsigned)ref,
+                      (unsigned)mm[0], (unsigned)want);
+        }
+    }
+
+    test_lock_on(false);
+    test_lock_on(true);
+
+    return tof_test_finish("test_return_select");
+}
@@ -0,0 +1,92 @@
+#include "tmf8828_decode.c"
+
+#include "tof_test.h"
+
+/* The compile-time (capture, raw slot) -> grid table against the per-zone
+ * mapping it replaced. Built once per TMF8828_ZONE_MAP_MODE (and once with
+ * the identity capture remap); each build checks every capture and raw slot
+ * of its mode and that the four captures tile the 8x8 grid.
+ */
+
+/* tmf_zone_index_8x8() as it was before the table. */
+static uint32_t ref_zone_index_8x8(uint32_t capture, uint32_t zone16)
+{
+    static const uint8_t cap_remap[TMF8828_CAPTURE_COUNT_8X8] = {
+        (uint8_t)(TMF8828_CAPTURE_REMAP_0 & 0x3u),
+        (uint8_t)(TMF8828_CAPTURE_REMAP_1 & 0x3u),
+        (uint8_t)(TMF8828_CAPTURE_REMAP_2 & 0x3u),
+        (uint8_t)(TMF8828_CAPTURE_REMAP_3 & 0x3u),
+    };
+
+    const uint32_t cap = cap_remap[capture & 0x3u];
+    uint32_t x = 0u;
+    uint32_t y = 0u;
+
+#if (TMF8828_ZONE_MAP_MODE == 1u)
+    x = (zone16 & 0x3u) + ((cap & 0x1u) << 2u);
+    y = ((zone16 >> 2u) & 0x3u) + (((cap >> 1u) & 0x1u) << 2u);
+#elif (TMF8828_ZONE_MAP_MODE == 2u)
+    x = zone16 & 0x7u;
+    y = ((zone16 >> 3u) & 0x1u) + (cap << 1u);
+#elif (TMF8828_ZONE_MAP_MODE == 3u)
+    x = ((zone16 >> 3u) & 0x1u) + (cap << 1u);
+    y = zone16 & 0x7u;
+#else
+    const uint32_t phase_x = cap & 0x1u;
+    const uint32_t phase_y = (cap >> 1u) & 0x1u;
+    const uint32_t local_x = zone16 & 0x3u;
+    const uint32_t local_y = (zone16 >> 2u) & 0x3u;
+    x = (local_x << 1u) | phase_x;
+    y = (local_y << 1u) | phase_y;
+#endif
+
+    return (y * 8u) + x;
+}
+
+int main(void)
+{
+    uint32_t mismatches = 0u;
+    uint64_t covered = 0u;
+    uint32_t overlaps = 0u;
+
+    for (uint32_t capture = 0u; capture < TMF8828_CAPTURE_COUNT_8X8; capture++)
+    {
+        /* Raw slots 8 and 17 are skipped; the others are zones 0..15 in order. */
+        uint32_t zone = 0u;
+        for (uint32_t raw = 0u; raw < TMF8828_OBJ_ENTRIES_RAW; raw++)
+        {
+            const uint8_t got = s_slot_grid[capture][raw];
+            if (raw == 8u || raw == 17u)
+            {
+                TOF_CHECK(got == TMF8828_SLOT_UNUSED, "capture %u raw %u: 0x%02x, expected unused", capture, raw, got);
+                mismatches += (got != TMF8828_SLOT_UNUSED) ? 1u : 0u;
+                continue;
+            }
+
+            const uint32_t want = ref_zone_index_8x8(capture, zone);
+            TOF_CHECK(got == want, "capture %u raw %u zone %u: grid %u, expected %u", capture, raw, zone, got, want);
+            mismatches += (got != want) ? 1u : 0u;
+            if (got < 64u)
+            {
+                const uint64_t bit = (uint64_t)1u << got;
+                overlaps += ((covered & bit) != 0u) ? 1u : 0u;
+                covered |= bit;
+            }
+            zone++;
+        }
+    }
+
+    TOF_CHECK(overlaps == 0u && covered == ~(uint64_t)0u,
+              "captures do not tile the grid: %u overlaps, coverage 0x%016llx",
+              overlaps,
+              (unsigned long long)covered);
+    printf("slot grid mode %u remap %u%u%u%u: %u mismatches, coverage 0x%016llx\n",
+           (unsigned)TMF8828_ZONE_MAP_MODE,
+           (unsigned)TMF8828_CAPTURE_REMAP_0,
+           (unsigned)TMF8828_CAPTURE_REMAP_1,
+           (unsigned)TMF8828_CAPTURE_REMAP_2,
+           (unsigned)TMF8828_CAPTURE_REMAP_3,
+           mismatches,
+           (unsigned long long)covered);
+    return tof_test_finish("slot grid");
+}
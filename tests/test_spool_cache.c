@@ -0,0 +1,189 @@
+#define TOF_DEMO_MAIN tof_demo_main
+#include "tof_demo.c"
+
+#include "platform/par_lcd_host.h"
+#include "tof_test.h"
+
+/* Spool sprite cache with an arena that holds only a few variants: every
+ * miss must store the variant it just encoded, evicting least recently used
+ * ones while encoding, so the next draw of it is a hit. Hits must put the
+ * same pixels on the panel as a fresh render, and the arena must stay
+ * packed. A variant larger than the whole arena is not stored.
+ */
+
+#define TEST_FB_PX ((uint32_t)TOF_LCD_W * (uint32_t)TOF_LCD_H)
+
+static uint16_t s_ref_fb[TOF_SPOOL_SPRITE_COUNT][TEST_FB_PX];
+static bool s_ref_valid[TOF_SPOOL_SPRITE_COUNT];
+
+static tof_roll_scene_t test_scene(uint32_t seg, bool live)
+{
+    const int32_t filament_ry = 56 + (int32_t)(seg * 4u);
+    const tof_roll_scene_t sc = {
+        .center_x = TOF_TP_X0 + 150,
+        .depth = 64,
+        .cy = 118,
+        .roll_bottom = 230,
+        .back_cx = TOF_TP_X0 + 118,
+        .front_cx = TOF_TP_X0 + 182,
+        .flange_rx = 120,
+        .flange_ry = 92,
+        .hub_outer_rx = 67,
+        .hub_outer_ry = 51,
+        .bore_rx = 28,
+        .bore_ry = 28,
+        .filament_rx = (filament_ry * 120) / 92,
+        .filament_ry = filament_ry,
+        .roll_x0 = TOF_TP_X0 + 18,
+        .roll_y0 = 23,
+        .roll_x1 = TOF_TP_X0 + 282,
+        .roll_y1 = 218,
+        .has_filament = (seg > 0u),
+        .render_live = live,
+        .bar_segments = (uint8_t)seg,
+    };
+    return sc;
+}
+
+/* Entries are packed from 0 with no overlap and no gaps. */
+static void test_check_packed(uint32_t step)
+{
+    uint32_t total = 0u;
+    for (uint32_t i = 0u; i < TOF_SPOOL_SPRITE_COUNT; i++)
+    {
+        const tof_spool_sprite_t *e = &s_spool_sprites[i];
+        if (e->words == 0u)
+        {
+            continue;
+        }
+        total += e->words;
+        TOF_CHECK((e->offset + e->words) <= s_spool_cache_used, "step %u: entry %u past the end", (unsigned)step,
+                  (unsigned)i);
+        for (uint32_t j = 0u; j < TOF_SPOOL_SPRITE_COUNT; j++)
+        {
+            const tof_spool_sprite_t *o = &s_spool_sprites[j];
+            if (j != i && o->words > 0u)
+            {
+                TOF_CHECK((e->offset + e->words) <= o->offset || (o->offset + o->words) <= e->offset,
+                          "step %u: entries %u and %u overlap", (unsigned)step, (unsigned)i, (unsigned)j);
+            }
+        }
+    }
+    TOF_CHECK(total == s_spool_cache_used, "step %u: %u words in entries, %u used", (unsigned)step, (unsigned)total,
+              (unsigned)s_spool_cache_used);
+}
+
+static void test_draw(uint32_t seg, bool live, uint32_t step)
+{
+    const tof_roll_scene_t sc = test_scene(seg, live);
+    const uint32_t key = (seg * 2u) + (live ? 1u : 0u);
+    const bool cached = (s_spool_sprites[key].words > 0u);
+    const uint32_t hits = s_spool_cache_hits;
+    const uint32_t misses = s_spool_cache_misses;
+
+    display_hal_fill(0u);
+    tof_render_roll_scene(&sc);
+    display_hal_flush();
+
+    TOF_CHECK((s_spool_cache_hits - hits) == (cached ? 1u : 0u) && (s_spool_cache_misses - misses) == (cached ? 0u : 1u),
+              "step %u seg %u live %u: hit/miss accounting", (unsigned)step, (unsigned)seg, (unsigned)live);
+    TOF_CHECK(s_spool_sprites[key].words > 0u, "step %u seg %u live %u: variant not stored", (unsigned)step,
+              (unsigned)seg, (unsigned)live);
+    test_check_packed(step);
+
+    const uint16_t *fb = par_lcd_host_framebuffer();
+    if (!s_ref_valid[key])
+    {
+        TOF_CHECK(!cached, "step %u: first draw of seg %u live %u was a hit", (unsigned)step, (unsigned)seg,
+                  (unsigned)live);
+        memcpy(s_ref_fb[key], fb, sizeof(s_ref_fb[key]));
+        s_ref_valid[key] = true;
+        return;
+    }
+    TOF_CHECK(memcmp(s_ref_fb[key], fb, sizeof(s_ref_fb[key])) == 0, "step %u seg %u live %u: %s pixels differ",
+              (unsigned)step, (unsigned)seg, (unsigned)live, cached ? "cached" : "re-encoded");
+}
+
+int main(void)
+{
+    if (!display_hal_init())
+    {
+        printf("display_hal_init failed\n");
+        return 1;
+    }
+
+    /* Sizes first, from an empty arena. */
+    uint32_t max_words = 0u;
+    uint32_t sum_words = 0u;
+    for (uint32_t key = 0u; key < TOF_SPOOL_SPRITE_COUNT; key++)
+    {
+        memset(s_spool_sprites, 0, sizeof(s_spool_sprites));
+        s_spool_cache_used = 0u;
+        const tof_roll_scene_t sc = test_scene(key / 2u, (key & 1u) != 0u);
+        tof_render_roll_scene(&sc);
+        const uint32_t words = s_spool_sprites[key].words;
+        TOF_CHECK(words > 0u, "variant %u not stored in an empty arena", (unsigned)key);
+        max_words = (words > max_words) ? words : max_words;
+        sum_words += words;
+    }
+    printf("variants: %u, largest %u B, all %u B, arena %u B\n", (unsigned)TOF_SPOOL_SPRITE_COUNT,
+           (unsigned)(max_words * 2u), (unsigned)(sum_words * 2u), (unsigned)TOF_SPOOL_CACHE_BYTES);
+    TOF_CHECK(sum_words > TOF_SPOOL_CACHE_WORDS, "arena holds every variant, nothing to evict");
+    TOF_CHECK((max_words * 2u) <= TOF_SPOOL_CACHE_WORDS, "arena holds fewer than two variants");
+    memset(s_spool_sprites, 0, sizeof(s_spool_sprites));
+    s_spool_cache_used = 0u;
+
+    /* Cycle through every variant a few times, then revisit at random. */
+    uint32_t step = 0u;
+    for (uint32_t pass = 0u; pass < 3u; pass++)
+    {
+        for (uint32_t key = 0u; key < TOF_SPOOL_SPRITE_COUNT; key++)
+        {
+            test_draw(key / 2u, (key & 1u) != 0u, step++);
+        }
+    }
+    uint32_t rng = 0x3C6EF372u;
+    for (uint32_t n = 0u; n < 200u; n++)
+    {
+        const uint32_t key = tof_test_rand(&rng) % TOF_SPOOL_SPRITE_COUNT;
+        test_draw(key / 2u, (key & 1u) != 0u, step++);
+        /* Right after a draw, the same variant is a hit. */
+        if ((n % 7u) == 0u)
+        {
+            const uint32_t hits = s_spool_cache_hits;
+            test_draw(key / 2u, (key & 1u) != 0u, step++);
+            TOF_CHECK(s_spool_cache_hits == (hits + 1u), "step %u: redraw of variant %u missed", (unsigned)step,
+                      (unsigned)key);
+        }
+    }
+
+    /* A variant larger than the whole arena: the encoder evicts what it
+     * can, gives up once the variant is past the arena size, and nothing
+     * is stored. The next miss is stored as usual.
+     */
+    tof_rle_writer_t wr = {
+        .start = s_spool_cache_used,
+        .pos = s_spool_cache_used,
+        .words = 0u,
+        .run_len = 0u,
+        .run_color = 0u,
+    };
+    uint16_t noise[64];
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        noise[i] = (uint16_t)(i * 0x9E37u);
+    }
+    for (uint32_t k = 0u; k <= (TOF_SPOOL_CACHE_WORDS / 128u); k++)
+    {
+        tof_rle_write(&wr, noise, 64u);
+    }
+    tof_rle_emit(&wr);
+    TOF_CHECK(wr.words > TOF_SPOOL_CACHE_WORDS, "oversized variant only %u words", (unsigned)wr.words);
+    TOF_CHECK((wr.pos - wr.start) < wr.words, "oversized variant fully written");
+    TOF_CHECK(wr.pos <= TOF_SPOOL_CACHE_WORDS, "oversized variant written past the arena");
+    test_check_packed(step++);
+    test_draw(5u, false, step++);
+
+    printf("hits %u misses %u\n", (unsigned)s_spool_cache_hits, (unsigned)s_spool_cache_misses);
+    return tof_test_finish("test_spool_cache");
+}
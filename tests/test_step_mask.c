@@ -0,0 +1,189 @@
+#define TOF_DEMO_MAIN tof_demo_main
+#include "tof_demo.c"
+
+#include "tof_test.h"
+
+/* Per-zone stepping of the temporal filters (s_step_mask), fed by the
+ * synthetic 4-subcapture source. Each read is run through the zone filter,
+ * the display EMA and the AI grid EMA with the read's zone mask, as main()
+ * does with partial updates: zones outside the mask must keep their filter
+ * state. Then one complete frame stepped as four sub-capture masks must
+ * leave the per-zone stages (zone filter, AI grid EMA) where a single
+ * full-frame step leaves them. The display smoothing pass reads its
+ * neighbours, so it is only checked for gating.
+ */
+
+#define TEST_CYCLES 64u
+
+typedef struct
+{
+    uint16_t filtered_mm[64];
+    uint8_t invalid_age[64];
+    uint16_t display_mm[64];
+    uint8_t display_age[64];
+    uint16_t ai_grid_mm[64];
+    uint8_t ai_grid_hold_age[64];
+} test_filter_state_t;
+
+static void test_state_save(test_filter_state_t *st)
+{
+    memcpy(st->filtered_mm, s_filtered_mm, sizeof(st->filtered_mm));
+    memcpy(st->invalid_age, s_invalid_age, sizeof(st->invalid_age));
+    memcpy(st->display_mm, s_display_mm, sizeof(st->display_mm));
+    memcpy(st->display_age, s_display_age, sizeof(st->display_age));
+    memcpy(st->ai_grid_mm, s_ai_grid_mm, sizeof(st->ai_grid_mm));
+    memcpy(st->ai_grid_hold_age, s_ai_grid_hold_age, sizeof(st->ai_grid_hold_age));
+}
+
+static void test_state_restore(const test_filter_state_t *st)
+{
+    memcpy(s_filtered_mm, st->filtered_mm, sizeof(s_filtered_mm));
+    memcpy(s_invalid_age, st->invalid_age, sizeof(s_invalid_age));
+    memcpy(s_display_mm, st->display_mm, sizeof(s_display_mm));
+    memcpy(s_display_age, st->display_age, sizeof(s_display_age));
+    memcpy(s_ai_grid_mm, st->ai_grid_mm, sizeof(s_ai_grid_mm));
+    memcpy(s_ai_grid_hold_age, st->ai_grid_hold_age, sizeof(s_ai_grid_hold_age));
+}
+
+/* The temporal stages of tof_draw_heatmap_incremental(). */
+static void test_step(const uint16_t mm[64], uint64_t mask)
+{
+    uint16_t denoised[64];
+    s_step_mask = mask;
+    tof_filter_frame(mm, true);
+    tof_spatial_postprocess(s_filtered_mm, true);
+    tof_compose_display_frame(true);
+    tof_ai_denoise_heatmap_frame(s_display_mm, denoised, true);
+    s_step_mask = TOF_ZONES_ALL;
+}
+
+/* The per-zone stages alone, all on the same input frame. */
+static void test_step_per_zone(const uint16_t mm[64], uint64_t mask)
+{
+    uint16_t denoised[64];
+    s_step_mask = mask;
+    tof_filter_frame(mm, true);
+    tof_ai_denoise_heatmap_frame(mm, denoised, true);
+    s_step_mask = TOF_ZONES_ALL;
+}
+
+static bool test_read(const tof_source_t *source, uint32_t *tick, uint16_t mm[64], tof_source_frame_t *frame)
+{
+    const bool ok = source->read(frame, (*tick)++);
+    if (ok)
+    {
+        tof_select_returns(&frame->ret, mm, s_zone_conf);
+        s_zone_conf_live = frame->has_conf;
+    }
+    return ok;
+}
+
+int main(void)
+{
+    const tof_source_t *source = &TOF_INPUT_SOURCE;
+    TOF_CHECK(source == &g_tof_source_synth_subcap, "input mode %u", (unsigned)TOF_DEBUG_INPUT_MODE);
+    TOF_CHECK(source->open(), "open");
+
+    uint16_t frame_mm[64];
+    uint32_t tick = 0u;
+    tof_source_frame_t frame;
+    uint64_t cycle_masks[4];
+
+    /* Prime: one full cycle stepped as whole frames. */
+    for (uint32_t q = 0u; q < 4u; q++)
+    {
+        TOF_CHECK(test_read(source, &tick, frame_mm, &frame), "prime read %u", (unsigned)q);
+        TOF_CHECK(frame.complete == (q == 3u), "prime complete %u", (unsigned)q);
+        cycle_masks[q] = frame.zone_mask;
+        test_step(frame_mm, TOF_ZONES_ALL);
+    }
+
+    /* The four sub-capture masks cover the grid once. */
+    uint64_t cover = 0u;
+    for (uint32_t q = 0u; q < 4u; q++)
+    {
+        TOF_CHECK(__builtin_popcountll(cycle_masks[q]) == 16, "capture %u: %u zones",
+                  (unsigned)q, (unsigned)__builtin_popcountll(cycle_masks[q]));
+        TOF_CHECK((cover & cycle_masks[q]) == 0u, "capture %u overlaps", (unsigned)q);
+        cover |= cycle_masks[q];
+    }
+    TOF_CHECK(cover == TOF_ZONES_ALL, "masks cover %016llx", (unsigned long long)cover);
+
+    /* Gating: every read steps its own zones only. */
+    uint32_t stepped_changes = 0u;
+    for (uint32_t n = 0u; n < TEST_CYCLES * 4u; n++)
+    {
+        TOF_CHECK(test_read(source, &tick, frame_mm, &frame), "read %u", (unsigned)n);
+        TOF_CHECK(frame.zone_mask == cycle_masks[n & 3u], "read %u mask", (unsigned)n);
+
+        test_filter_state_t before;
+        test_filter_state_t after;
+        test_state_save(&before);
+        test_step(frame_mm, frame.zone_mask);
+        test_state_save(&after);
+
+        for (uint32_t i = 0u; i < 64u; i++)
+        {
+            if ((frame.zone_mask & ((uint64_t)1u << i)) != 0u)
+            {
+                stepped_changes += (after.filtered_mm[i] != before.filtered_mm[i]) ? 1u : 0u;
+                continue;
+            }
+            TOF_CHECK(after.filtered_mm[i] == before.filtered_mm[i] && after.invalid_age[i] == before.invalid_age[i],
+                      "read %u zone %u: zone filter stepped", (unsigned)n, (unsigned)i);
+            TOF_CHECK(after.display_mm[i] == before.display_mm[i] && after.display_age[i] == before.display_age[i],
+                      "read %u zone %u: display EMA stepped", (unsigned)n, (unsigned)i);
+            TOF_CHECK(after.ai_grid_mm[i] == before.ai_grid_mm[i] && after.ai_grid_hold_age[i] == before.ai_grid_hold_age[i],
+                      "read %u zone %u: AI grid EMA stepped", (unsigned)n, (unsigned)i);
+        }
+    }
+    TOF_CHECK(stepped_changes > 0u, "masked zones never moved");
+
+    /* Four quarter steps against one full step, same complete frame, from
+     * the state the gating run left behind and from a cold start.
+     */
+    for (uint32_t pass = 0u; pass < 2u; pass++)
+    {
+        if (pass == 1u)
+        {
+            memset(s_filtered_mm, 0, sizeof(s_filtered_mm));
+            memset(s_invalid_age, 0, sizeof(s_invalid_age));
+            tof_ai_grid_reset();
+        }
+
+        for (uint32_t cycle = 0u; cycle < TEST_CYCLES; cycle++)
+        {
+            do
+            {
+                TOF_CHECK(test_read(source, &tick, frame_mm, &frame), "cycle %u read", (unsigned)cycle);
+            } while (!frame.complete);
+
+            test_filter_state_t start;
+            test_filter_state_t full;
+            test_filter_state_t quarters;
+            test_state_save(&start);
+
+            test_step_per_zone(frame_mm, TOF_ZONES_ALL);
+            test_state_save(&full);
+
+            test_state_restore(&start);
+            for (uint32_t q = 0u; q < 4u; q++)
+            {
+                test_step_per_zone(frame_mm, cycle_masks[q]);
+            }
+            test_state_save(&quarters);
+
+            for (uint32_t i = 0u; i < 64u; i++)
+            {
+                TOF_CHECK(quarters.filtered_mm[i] == full.filtered_mm[i] && quarters.invalid_age[i] == full.invalid_age[i],
+                          "pass %u cycle %u zone %u: zone filter %u, full %u", (unsigned)pass, (unsigned)cycle,
+                          (unsigned)i, (unsigned)quarters.filtered_mm[i], (unsigned)full.filtered_mm[i]);
+                TOF_CHECK(quarters.ai_grid_mm[i] == full.ai_grid_mm[i] && quarters.ai_grid_hold_age[i] == full.ai_grid_hold_age[i],
+                          "pass %u cycle %u zone %u: AI grid %u, full %u", (unsigned)pass, (unsigned)cycle,
+                          (unsigned)i, (unsigned)quarters.ai_grid_mm[i], (unsigned)full.ai_grid_mm[i]);
+            }
+        }
+    }
+
+    return tof_test_finish("test_step_mask");
+}
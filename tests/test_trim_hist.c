@@ -0,0 +1,237 @@
+#define TOF_DEMO_MAIN tof_demo_main
+#include "tof_demo.c"
+
+#include "tof_test.h"
+
+/* Estimator trimmed mean: the histogram version (s_trim_hist rebuilt from
+ * the frame summary) against the sort-based version it replaced, over 400k
+ * frames. Frames move as whole frames or as 16-zone sub-capture updates;
+ * values cover spool-like spreads, near-empty frames, one-value ties, the full validity range,
+ * bucket-edge pairs and the top of the range; confidence weighting toggles
+ * on and off. Also times both per frame, summary included.
+ */
+
+#define TEST_FRAMES 400000u
+#define TEST_BENCH_FRAMES 1000000u
+
+/* tof_estimator_measure_mm_q8() before the histogram: gather and
+ * insertion-sort the valid zones with their weights.
+ */
+static bool ref_estimator_measure_mm_q8(const tof_frame_summary_t *s, uint32_t *mm_q8_out)
+{
+    if (s->valid_count < TOF_EST_VALID_MIN)
+    {
+        return false;
+    }
+
+    uint16_t values[64];
+    uint16_t weights[64];
+    uint32_t count = 0u;
+    uint32_t center_sum = 0u;
+    uint32_t center_wsum = 0u;
+    uint32_t center_count = 0u;
+
+    for (uint32_t idx = 0u; idx < 64u; idx++)
+    {
+        if ((s->valid_mask & ((uint64_t)1u << idx)) == 0u)
+        {
+            continue;
+        }
+
+        const uint16_t v = s->mm[idx];
+        const uint32_t x = idx % TOF_GRID_W;
+        const uint32_t y = idx / TOF_GRID_W;
+        const uint32_t w = tof_zone_weight_q8(idx);
+        values[count] = v;
+        weights[count] = (uint16_t)w;
+        count++;
+        if ((x >= 2u && x <= 5u) && (y >= 2u && y <= 5u))
+        {
+            center_sum += (uint32_t)v * w;
+            center_wsum += w;
+            center_count++;
+        }
+    }
+
+    for (uint32_t i = 1u; i < count; i++)
+    {
+        uint16_t key = values[i];
+        uint16_t key_w = weights[i];
+        int32_t j = (int32_t)i - 1;
+        while (j >= 0 && values[(uint32_t)j] > key)
+        {
+            values[(uint32_t)j + 1u] = values[(uint32_t)j];
+            weights[(uint32_t)j + 1u] = weights[(uint32_t)j];
+            j--;
+        }
+        values[(uint32_t)j + 1u] = key;
+        weights[(uint32_t)j + 1u] = key_w;
+    }
+
+    uint32_t trim = count / 8u;
+    if ((trim * 2u) >= count)
+    {
+        trim = 0u;
+    }
+
+    /* Confidence-weighted trimmed mean; equals the plain trimmed mean when
+     * all weights are equal.
+     */
+    uint32_t sum = 0u;
+    uint32_t wsum = 0u;
+    for (uint32_t i = trim; i < (count - trim); i++)
+    {
+        sum += (uint32_t)values[i] * weights[i];
+        wsum += weights[i];
+    }
+    if (wsum == 0u)
+    {
+        return false;
+    }
+
+    uint32_t mean_mm = (sum + (wsum / 2u)) / wsum;
+    if (center_count >= 4u)
+    {
+        const uint32_t center_mm = (center_sum + (center_wsum / 2u)) / center_wsum;
+        mean_mm = (((mean_mm * 3u) + (center_mm * 2u)) + 2u) / 5u;
+    }
+
+    if (mm_q8_out)
+    {
+        *mm_q8_out = (mean_mm << 8);
+    }
+    return true;
+}
+
+static void test_update_frame(uint16_t mm[64], uint32_t *rng)
+{
+    const uint32_t mode = tof_test_rand(rng) % 5u;
+    const uint32_t changes = ((tof_test_rand(rng) % 3u) == 0u) ? 64u : 16u;
+    for (uint32_t c = 0u; c < changes; c++)
+    {
+        const uint32_t i = (changes == 64u) ? c : (tof_test_rand(rng) % 64u);
+        const uint32_t r = tof_test_rand(rng);
+        uint16_t v;
+        if ((r % 9u) == 0u)
+        {
+            v = 0u;
+        }
+        else if ((r % 17u) == 0u)
+        {
+            v = (uint16_t)(12000u + ((r >> 5) % 100u));
+        }
+        else if (mode == 0u)
+        {
+            v = (uint16_t)(35u + ((r >> 5) % 116u));
+        }
+        else if (mode == 1u)
+        {
+            v = (uint16_t)(100u + ((r >> 5) % 3u));
+        }
+        else if (mode == 2u)
+        {
+            v = (uint16_t)(1u + ((r >> 5) % 11999u));
+        }
+        else if (mode == 3u)
+        {
+            v = (r & 1u) ? 127u : 128u; /* either side of a bucket edge */
+        }
+        else
+        {
+            v = (uint16_t)(11990u + ((r >> 5) % 10u));
+        }
+        mm[i] = v;
+        s_zone_conf[i] = (uint8_t)tof_test_rand(rng);
+    }
+    if ((tof_test_rand(rng) % 50u) == 0u)
+    {
+        s_zone_conf_live = !s_zone_conf_live;
+    }
+    if ((tof_test_rand(rng) % 100u) == 0u)
+    {
+        /* Mostly blank: around TOF_EST_VALID_MIN valid zones. */
+        const uint32_t keep = tof_test_rand(rng) % 16u;
+        for (uint32_t i = keep; i < 64u; i++)
+        {
+            mm[i] = 0u;
+        }
+    }
+}
+
+static void test_equivalence(void)
+{
+    static uint16_t mm[64];
+    uint32_t rng = 7u;
+    uint32_t measured = 0u;
+    uint32_t mismatches = 0u;
+
+    for (uint32_t f = 0u; f < TEST_FRAMES && mismatches < 10u; f++)
+    {
+        test_update_frame(mm, &rng);
+        s_frame_seq++;
+        const tof_frame_summary_t *s = tof_frame_summary(mm);
+
+        uint32_t ref_q8 = 0xDEADu;
+        uint32_t new_q8 = 0xBEEFu;
+        const bool ref_ok = ref_estimator_measure_mm_q8(s, &ref_q8);
+        const bool new_ok = tof_estimator_measure_mm_q8(s, &new_q8);
+        const bool same = (ref_ok == new_ok) && (!ref_ok || ref_q8 == new_q8);
+        TOF_CHECK(same, "frame %u (%u valid): sort %d/%u, histogram %d/%u", f, s->valid_count, ref_ok, ref_q8,
+                  new_ok, new_q8);
+        mismatches += same ? 0u : 1u;
+        measured += ref_ok ? 1u : 0u;
+    }
+    printf("test_trim_hist: %u frames, %u measured, %u differ\n", TEST_FRAMES, measured, mismatches);
+}
+
+static void test_bench(void)
+{
+    static uint16_t mm[64];
+    uint32_t rng = 3u;
+    for (uint32_t i = 0u; i < 64u; i++)
+    {
+        mm[i] = (uint16_t)(35u + (tof_test_rand(&rng) % 116u));
+    }
+    s_zone_conf_live = false;
+
+    uint64_t ns[2];
+    uint32_t sink = 0u;
+    for (uint32_t pass = 0u; pass < 2u; pass++)
+    {
+        const uint64_t t0 = tof_test_now_ns();
+        for (uint32_t f = 0u; f < TEST_BENCH_FRAMES; f++)
+        {
+            /* One 16-zone sub-capture per frame. */
+            const uint32_t r = tof_test_rand(&rng);
+            for (uint32_t k = 0u; k < 16u; k++)
+            {
+                mm[((f * 16u) + k) & 63u] = (uint16_t)(35u + ((r >> (k & 7u)) % 116u));
+            }
+            s_frame_seq++;
+            const tof_frame_summary_t *s = tof_frame_summary(mm);
+            uint32_t q8 = 0u;
+            if (pass == 0u)
+            {
+                (void)ref_estimator_measure_mm_q8(s, &q8);
+            }
+            else
+            {
+                (void)tof_estimator_measure_mm_q8(s, &q8);
+            }
+            sink += q8;
+        }
+        ns[pass] = tof_test_now_ns() - t0;
+    }
+
+    printf("test_trim_hist: ns per frame incl. summary: %llu (sort) vs %llu (histogram) (sink %u)\n",
+           (unsigned long long)(ns[0] / TEST_BENCH_FRAMES),
+           (unsigned long long)(ns[1] / TEST_BENCH_FRAMES),
+           (unsigned)sink);
+}
+
+int main(void)
+{
+    test_equivalence();
+    test_bench();
+    return tof_test_finish("test_trim_hist");
+}
@@ -0,0 +1,86 @@
+#define TOF_DEMO_MAIN tof_demo_main
+#include "tof_demo.c"
+
+#include <stdlib.h>
+
+#include "platform/par_lcd_host.h"
+#include "tof_test.h"
+
+/* The demo loop on Linux, fed from a recorded capture:
+ *
+ *   tof_demo_host [--realtime] [--ppm last.ppm] capture
+ *
+ * capture is a serial log with AI_F64 lines or a binary TOFC file (see
+ * tof_source.h). Runs until the capture ends, then prints the records
+ * replayed, the ticks run, bus work per tick, a hash of the final frame and
+ * the host throughput.
+ */
+
+static void tof_host_usage(void)
+{
+    printf("usage: tof_demo_host [--realtime] [--ppm out.ppm] capture\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL;
+    const char *ppm = NULL;
+    bool realtime = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--realtime") == 0)
+        {
+            realtime = true;
+        }
+        else if (strcmp(argv[i], "--ppm") == 0 && (i + 1) < argc)
+        {
+            ppm = argv[++i];
+        }
+        else if (argv[i][0] != '-' && !path)
+        {
+            path = argv[i];
+        }
+        else
+        {
+            tof_host_usage();
+            return 2;
+        }
+    }
+    if (!path)
+    {
+        tof_host_usage();
+        return 2;
+    }
+
+    tof_source_replay_configure(path, realtime, TOF_FRAME_US);
+    const uint64_t t0 = tof_test_now_ns();
+    (void)tof_demo_main();
+    const uint64_t elapsed_ns = tof_test_now_ns() - t0;
+
+    display_hal_frame_stats_t frame;
+    display_hal_get_frame_stats(&frame);
+    par_lcd_host_stats_t lcd;
+    par_lcd_host_take_stats(&lcd);
+    const uint32_t records = tof_source_replay_frames();
+    const uint32_t ticks = (frame.frame > 0u) ? frame.frame : 1u;
+    const uint64_t hash =
+        tof_test_hash(TOF_TEST_HASH_INIT, par_lcd_host_framebuffer(), TOF_LCD_W * TOF_LCD_H * sizeof(uint16_t));
+
+    printf("replay: records=%u ticks=%u per tick: fills=%u blits=%u selects=%u px=%u\n",
+           (unsigned)records,
+           (unsigned)frame.frame,
+           (unsigned)(lcd.fill_calls / ticks),
+           (unsigned)(lcd.blit_calls / ticks),
+           (unsigned)(lcd.window_selects / ticks),
+           (unsigned)(lcd.pixels / ticks));
+    printf("replay: final frame hash=0x%016llx, %.1f ticks/s on this host\n",
+           (unsigned long long)hash,
+           (elapsed_ns > 0u) ? ((double)ticks * 1e9 / (double)elapsed_ns) : 0.0);
+
+    if (ppm && !par_lcd_host_write_ppm(ppm))
+    {
+        printf("replay: cannot write %s\n", ppm);
+        return 1;
+    }
+    return (records > 0u) ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/* Shared helpers for the host tests: counted checks, a deterministic
+ * generator and a monotonic clock for the benchmarks. Tests that reach into
+ * tof_demo.c statics include the source after renaming its entry point:
+ *
+ *   #define TOF_DEMO_MAIN tof_demo_main
+ *   #include "tof_demo.c"
+ */
+
+#if defined(__GNUC__)
+__attribute__((unused))
+#endif
+static uint32_t s_tof_test_failures = 0u;
+
+#define TOF_CHECK(cond, ...)                                                   \
+    do                                                                         \
+    {                                                                          \
+        if (!(cond))                                                           \
+        {                                                                      \
+            if (s_tof_test_failures < 20u)                                     \
+            {                                                                  \
+                printf("%s:%d: check failed: %s: ", __FILE__, __LINE__, #cond); \
+                printf(__VA_ARGS__);                                           \
+                printf("\n");                                                  \
+            }                                                                  \
+            s_tof_test_failures++;                                             \
+        }                                                                      \
+    } while (0)
+
+static inline int tof_test_finish(const char *name)
+{
+    if (s_tof_test_failures > 0u)
+    {
+        printf("%s: FAILED (%u checks)\n", name, (unsigned)s_tof_test_failures);
+        return 1;
+    }
+    printf("%s: ok\n", name);
+    return 0;
+}
+
+/* xorshift32; seed must be non-zero. */
+static inline uint32_t tof_test_rand(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static inline uint64_t tof_test_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+/* Cycle counter for the benchmarks: the TSC on x86, 0 elsewhere (the
+ * benchmarks then report time only).
+ */
+static inline uint64_t tof_test_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0u;
+#endif
+}
+
+/* FNV-1a, for display and state fingerprints. */
+static inline uint64_t tof_test_hash(uint64_t h, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0u; i < len; i++)
+    {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+#define TOF_TEST_HASH_INIT 1469598103934665603ull
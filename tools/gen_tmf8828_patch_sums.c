@@ -0,0 +1,98 @@
+/* Generator for the chunk-sum block at the end of src/tmf8828_patch.h.
+ *
+ * The bootloader takes the patch in TMF8828_PATCH_CHUNK_SIZE-byte WR_RAM
+ * frames, each carrying a checksum over its payload. The per-chunk byte sums
+ * are precomputed from g_tmf8828_patch_data so the download does not make a
+ * pass over the payload for them.
+ *
+ *   cc -O2 -Isrc -o gen_tmf8828_patch_sums tools/gen_tmf8828_patch_sums.c
+ *   ./gen_tmf8828_patch_sums            print the block; it replaces everything
+ *                                       from the "Byte sums" comment down
+ *   ./gen_tmf8828_patch_sums --check    exit 1 if the header's block is stale
+ *
+ * The host build (tests/CMakeLists.txt) runs --check as the patch_chunk_sums
+ * test.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "tmf8828_patch.h"
+
+#define GEN_CHUNK_SIZE 128u
+#define GEN_CHUNKS ((TMF8828_PATCH_SIZE + GEN_CHUNK_SIZE - 1u) / GEN_CHUNK_SIZE)
+
+static uint8_t gen_chunk_sum(uint32_t chunk)
+{
+    const uint32_t off = chunk * GEN_CHUNK_SIZE;
+    const uint32_t len = ((TMF8828_PATCH_SIZE - off) > GEN_CHUNK_SIZE) ? GEN_CHUNK_SIZE : (TMF8828_PATCH_SIZE - off);
+    uint32_t sum = 0u;
+    for (uint32_t i = 0u; i < len; i++)
+    {
+        sum += g_tmf8828_patch_data[off + i];
+    }
+    return (uint8_t)sum;
+}
+
+static int gen_check(void)
+{
+    if ((TMF8828_PATCH_CHUNK_SIZE != GEN_CHUNK_SIZE) || (TMF8828_PATCH_CHUNKS != GEN_CHUNKS))
+    {
+        fprintf(stderr,
+                "gen_tmf8828_patch_sums: header has %u chunks of %u, patch needs %u of %u\n",
+                (unsigned)TMF8828_PATCH_CHUNKS,
+                (unsigned)TMF8828_PATCH_CHUNK_SIZE,
+                (unsigned)GEN_CHUNKS,
+                (unsigned)GEN_CHUNK_SIZE);
+        return 1;
+    }
+    uint32_t bad = 0u;
+    for (uint32_t i = 0u; i < GEN_CHUNKS; i++)
+    {
+        if (g_tmf8828_patch_chunk_sum[i] != gen_chunk_sum(i))
+        {
+            fprintf(stderr,
+                    "gen_tmf8828_patch_sums: chunk %u sum 0x%02X, expected 0x%02X\n",
+                    i,
+                    g_tmf8828_patch_chunk_sum[i],
+                    gen_chunk_sum(i));
+            bad++;
+        }
+    }
+    printf("patch chunk sums: %u chunks, %u stale\n", (unsigned)GEN_CHUNKS, bad);
+    return (bad == 0u) ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 2 && strcmp(argv[1], "--check") == 0)
+    {
+        return gen_check();
+    }
+    if (argc != 1)
+    {
+        fprintf(stderr, "usage: %s [--check]\n", argv[0]);
+        return 2;
+    }
+
+    printf("/* Byte sums (mod 256) of g_tmf8828_patch_data per bootloader chunk, so WR_RAM\n"
+           " * checksums need no pass over the payload at download time. Generated by\n"
+           " * tools/gen_tmf8828_patch_sums.c.\n"
+           " */\n"
+           "#define TMF8828_PATCH_CHUNK_SIZE %uu\n"
+           "#define TMF8828_PATCH_CHUNKS %uu\n"
+           "\n"
+           "static const uint8_t g_tmf8828_patch_chunk_sum[TMF8828_PATCH_CHUNKS] = {\n",
+           (unsigned)GEN_CHUNK_SIZE,
+           (unsigned)GEN_CHUNKS);
+    for (uint32_t i = 0u; i < GEN_CHUNKS; i++)
+    {
+        printf("%s0x%02Xu,", ((i % 16u) == 0u) ? "    " : " ", gen_chunk_sum(i));
+        if (((i % 16u) == 15u) || ((i + 1u) == GEN_CHUNKS))
+        {
+            printf("\n");
+        }
+    }
+    printf("};\n");
+    return 0;
+}
@@ -0,0 +1,287 @@
+/* Generator for src/tof_font.h.
+ *
+ * The glyph sets below are the source of truth for the demo's two fonts: the
+ * 3x5 debug font and the 5x7 brand font. The generator expands them into the
+ * per-character tables the renderers index directly.
+ *
+ *   cc -O2 -o gen_tof_font tools/gen_tof_font.c
+ *   ./gen_tof_font > src/tof_font.h          regenerate
+ *   ./gen_tof_font --check src/tof_font.h    exit 1 if the header is stale
+ *
+ * The host build (tests/CMakeLists.txt) builds it and runs --check as the
+ * font_header test. Define GEN_TOF_FONT_NO_MAIN to include the glyph sets
+ * elsewhere.
+ */
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GEN_FONT_FIRST 0x20u
+#define GEN_FONT_GLYPHS 96u
+
+static void gen_glyph_3x5(char ch, uint8_t rows[5])
+{
+    if (ch >= 'a' && ch <= 'z')
+    {
+        ch = (char)(ch - ('a' - 'A'));
+    }
+
+    switch (ch)
+    {
+        case '0': rows[0] = 0x7; rows[1] = 0x5; rows[2] = 0x5; rows[3] = 0x5; rows[4] = 0x7; break;
+        case '1': rows[0] = 0x2; rows[1] = 0x6; rows[2] = 0x2; rows[3] = 0x2; rows[4] = 0x7; break;
+        case '2': rows[0] = 0x7; rows[1] = 0x1; rows[2] = 0x7; rows[3] = 0x4; rows[4] = 0x7; break;
+        case '3': rows[0] = 0x7; rows[1] = 0x1; rows[2] = 0x7; rows[3] = 0x1; rows[4] = 0x7; break;
+        case '4': rows[0] = 0x5; rows[1] = 0x5; rows[2] = 0x7; rows[3] = 0x1; rows[4] = 0x1; break;
+        case '5': rows[0] = 0x7; rows[1] = 0x4; rows[2] = 0x7; rows[3] = 0x1; rows[4] = 0x7; break;
+        case '6': rows[0] = 0x7; rows[1] = 0x4; rows[2] = 0x7; rows[3] = 0x5; rows[4] = 0x7; break;
+        case '7': rows[0] = 0x7; rows[1] = 0x1; rows[2] = 0x2; rows[3] = 0x2; rows[4] = 0x2; break;
+        case '8': rows[0] = 0x7; rows[1] = 0x5; rows[2] = 0x7; rows[3] = 0x5; rows[4] = 0x7; break;
+        case '9': rows[0] = 0x7; rows[1] = 0x5; rows[2] = 0x7; rows[3] = 0x1; rows[4] = 0x7; break;
+        case 'A': rows[0] = 0x2; rows[1] = 0x5; rows[2] = 0x7; rows[3] = 0x5; rows[4] = 0x5; break;
+        case 'B': rows[0] = 0x6; rows[1] = 0x5; rows[2] = 0x6; rows[3] = 0x5; rows[4] = 0x6; break;
+        case 'C': rows[0] = 0x3; rows[1] = 0x4; rows[2] = 0x4; rows[3] = 0x4; rows[4] = 0x3; break;
+        case 'D': rows[0] = 0x6; rows[1] = 0x5; rows[2] = 0x5; rows[3] = 0x5; rows[4] = 0x6; break;
+        case 'E': rows[0] = 0x7; rows[1] = 0x4; rows[2] = 0x6; rows[3] = 0x4; rows[4] = 0x7; break;
+        case 'F': rows[0] = 0x7; rows[1] = 0x4; rows[2] = 0x6; rows[3] = 0x4; rows[4] = 0x4; break;
+        case 'G': rows[0] = 0x3; rows[1] = 0x4; rows[2] = 0x5; rows[3] = 0x5; rows[4] = 0x3; break;
+        case 'H': rows[0] = 0x5; rows[1] = 0x5; rows[2] = 0x7; rows[3] = 0x5; rows[4] = 0x5; break;
+        case 'I': rows[0] = 0x7; rows[1] = 0x2; rows[2] = 0x2; rows[3] = 0x2; rows[4] = 0x7; break;
+        case 'J': rows[0] = 0x1; rows[1] = 0x1; rows[2] = 0x1; rows[3] = 0x5; rows[4] = 0x2; break;
+        case 'K': rows[0] = 0x5; rows[1] = 0x5; rows[2] = 0x6; rows[3] = 0x5; rows[4] = 0x5; break;
+        case 'L': rows[0] = 0x4; rows[1] = 0x4; rows[2] = 0x4; rows[3] = 0x4; rows[4] = 0x7; break;
+        case 'M': rows[0] = 0x5; rows[1] = 0x7; rows[2] = 0x7; rows[3] = 0x5; rows[4] = 0x5; break;
+        case 'N': rows[0] = 0x5; rows[1] = 0x7; rows[2] = 0x7; rows[3] = 0x7; rows[4] = 0x5; break;
+        case 'O': rows[0] = 0x2; rows[1] = 0x5; rows[2] = 0x5; rows[3] = 0x5; rows[4] = 0x2; break;
+        case 'P': rows[0] = 0x6; rows[1] = 0x5; rows[2] = 0x6; rows[3] = 0x4; rows[4] = 0x4; break;
+        case 'Q': rows[0] = 0x2; rows[1] = 0x5; rows[2] = 0x5; rows[3] = 0x2; rows[4] = 0x1; break;
+        case 'R': rows[0] = 0x6; rows[1] = 0x5; rows[2] = 0x6; rows[3] = 0x5; rows[4] = 0x5; break;
+        case 'S': rows[0] = 0x3; rows[1] = 0x4; rows[2] = 0x2; rows[3] = 0x1; rows[4] = 0x6; break;
+        case 'T': rows[0] = 0x7; rows[1] = 0x2; rows[2] = 0x2; rows[3] = 0x2; rows[4] = 0x2; break;
+        case 'U': rows[0] = 0x5; rows[1] = 0x5; rows[2] = 0x5; rows[3] = 0x5; rows[4] = 0x7; break;
+        case 'V': rows[0] = 0x5; rows[1] = 0x5; rows[2] = 0x5; rows[3] = 0x5; rows[4] = 0x2; break;
+        case 'W': rows[0] = 0x5; rows[1] = 0x5; rows[2] = 0x7; rows[3] = 0x7; rows[4] = 0x5; break;
+        case 'X': rows[0] = 0x5; rows[1] = 0x5; rows[2] = 0x2; rows[3] = 0x5; rows[4] = 0x5; break;
+        case 'Y': rows[0] = 0x5; rows[1] = 0x5; rows[2] = 0x2; rows[3] = 0x2; rows[4] = 0x2; break;
+        case 'Z': rows[0] = 0x7; rows[1] = 0x1; rows[2] = 0x2; rows[3] = 0x4; rows[4] = 0x7; break;
+        case ':': rows[0] = 0x0; rows[1] = 0x2; rows[2] = 0x0; rows[3] = 0x2; rows[4] = 0x0; break;
+        case '.': rows[0] = 0x0; rows[1] = 0x0; rows[2] = 0x0; rows[3] = 0x0; rows[4] = 0x2; break;
+        case '-': rows[0] = 0x0; rows[1] = 0x0; rows[2] = 0x7; rows[3] = 0x0; rows[4] = 0x0; break;
+        case '/': rows[0] = 0x1; rows[1] = 0x1; rows[2] = 0x2; rows[3] = 0x4; rows[4] = 0x4; break;
+        case '(': rows[0] = 0x1; rows[1] = 0x2; rows[2] = 0x2; rows[3] = 0x2; rows[4] = 0x1; break;
+        case ')': rows[0] = 0x4; rows[1] = 0x2; rows[2] = 0x2; rows[3] = 0x2; rows[4] = 0x4; break;
+        case '=': rows[0] = 0x0; rows[1] = 0x7; rows[2] = 0x0; rows[3] = 0x7; rows[4] = 0x0; break;
+        case ' ': rows[0] = 0x0; rows[1] = 0x0; rows[2] = 0x0; rows[3] = 0x0; rows[4] = 0x0; break;
+        default:  rows[0] = 0x7; rows[1] = 0x1; rows[2] = 0x2; rows[3] = 0x0; rows[4] = 0x2; break;
+    }
+}
+
+static void gen_glyph_5x7(char ch, uint8_t rows[7])
+{
+    if (ch >= 'a' && ch <= 'z')
+    {
+        ch = (char)(ch - ('a' - 'A'));
+    }
+
+    switch (ch)
+    {
+        case 'A': rows[0] = 0x0E; rows[1] = 0x11; rows[2] = 0x11; rows[3] = 0x1F; rows[4] = 0x11; rows[5] = 0x11; rows[6] = 0x11; break;
+        case 'B': rows[0] = 0x1E; rows[1] = 0x11; rows[2] = 0x11; rows[3] = 0x1E; rows[4] = 0x11; rows[5] = 0x11; rows[6] = 0x1E; break;
+        case 'C': rows[0] = 0x0E; rows[1] = 0x11; rows[2] = 0x10; rows[3] = 0x10; rows[4] = 0x10; rows[5] = 0x11; rows[6] = 0x0E; break;
+        case 'D': rows[0] = 0x1E; rows[1] = 0x11; rows[2] = 0x11; rows[3] = 0x11; rows[4] = 0x11; rows[5] = 0x11; rows[6] = 0x1E; break;
+        case 'E': rows[0] = 0x1F; rows[1] = 0x10; rows[2] = 0x10; rows[3] = 0x1E; rows[4] = 0x10; rows[5] = 0x10; rows[6] = 0x1F; break;
+        case 'H': rows[0] = 0x11; rows[1] = 0x11; rows[2] = 0x11; rows[3] = 0x1F; rows[4] = 0x11; rows[5] = 0x11; rows[6] = 0x11; break;
+        case 'I': rows[0] = 0x1F; rows[1] = 0x04; rows[2] = 0x04; rows[3] = 0x04; rows[4] = 0x04; rows[5] = 0x04; rows[6] = 0x1F; break;
+        case 'K': rows[0] = 0x11; rows[1] = 0x12; rows[2] = 0x14; rows[3] = 0x18; rows[4] = 0x14; rows[5] = 0x12; rows[6] = 0x11; break;
+        case 'N': rows[0] = 0x11; rows[1] = 0x19; rows[2] = 0x15; rows[3] = 0x13; rows[4] = 0x11; rows[5] = 0x11; rows[6] = 0x11; break;
+        case 'O': rows[0] = 0x0E; rows[1] = 0x11; rows[2] = 0x11; rows[3] = 0x11; rows[4] = 0x11; rows[5] = 0x11; rows[6] = 0x0E; break;
+        case 'R': rows[0] = 0x1E; rows[1] = 0x11; rows[2] = 0x11; rows[3] = 0x1E; rows[4] = 0x14; rows[5] = 0x12; rows[6] = 0x11; break;
+        case '(': rows[0] = 0x02; rows[1] = 0x04; rows[2] = 0x08; rows[3] = 0x08; rows[4] = 0x08; rows[5] = 0x04; rows[6] = 0x02; break;
+        case ')': rows[0] = 0x08; rows[1] = 0x04; rows[2] = 0x02; rows[3] = 0x02; rows[4] = 0x02; rows[5] = 0x04; rows[6] = 0x08; break;
+        case ' ': rows[0] = 0x00; rows[1] = 0x00; rows[2] = 0x00; rows[3] = 0x00; rows[4] = 0x00; rows[5] = 0x00; rows[6] = 0x00; break;
+        default:  rows[0] = 0x1F; rows[1] = 0x01; rows[2] = 0x02; rows[3] = 0x04; rows[4] = 0x04; rows[5] = 0x00; rows[6] = 0x04; break;
+    }
+}
+
+#ifndef GEN_TOF_FONT_NO_MAIN
+
+typedef struct
+{
+    char *buf;
+    size_t len;
+    size_t cap;
+} gen_out_t;
+
+static void gen_printf(gen_out_t *o, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+static void gen_printf(gen_out_t *o, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    const int n = vsnprintf(NULL, 0, fmt, ap);
+    va_end(ap);
+    if (n < 0)
+    {
+        exit(2);
+    }
+    if (o->len + (size_t)n + 1u > o->cap)
+    {
+        o->cap = (o->len + (size_t)n + 1u) * 2u;
+        o->buf = realloc(o->buf, o->cap);
+        if (!o->buf)
+        {
+            exit(2);
+        }
+    }
+    va_start(ap, fmt);
+    vsnprintf(o->buf + o->len, o->cap - o->len, fmt, ap);
+    va_end(ap);
+    o->len += (size_t)n;
+}
+
+/* C character literal for the table comments. */
+static const char *gen_char_name(uint32_t c)
+{
+    static char name[8];
+    if (c == 0x7Fu)
+    {
+        return "DEL";
+    }
+    if (c == '\'' || c == '\\')
+    {
+        snprintf(name, sizeof(name), "'\\%c'", (char)c);
+    }
+    else
+    {
+        snprintf(name, sizeof(name), "'%c'", (char)c);
+    }
+    return name;
+}
+
+static void gen_header(gen_out_t *o)
+{
+    gen_printf(o,
+               "#pragma once\n"
+               "#include <stdint.h>\n"
+               "\n"
+               "/* Generated by tools/gen_tof_font.c from the 3x5 debug and 5x7 brand glyph\n"
+               " * sets; do not edit. One entry per printable ASCII character from\n"
+               " * TOF_FONT_FIRST; lowercase maps to the uppercase glyph and anything without\n"
+               " * a glyph gets the '?' box.\n"
+               " */\n"
+               "#define TOF_FONT_FIRST 0x%02Xu\n"
+               "#define TOF_FONT_GLYPHS %uu\n"
+               "#define TOF_FONT_FALLBACK ((uint32_t)'?' - TOF_FONT_FIRST)\n"
+               "\n",
+               GEN_FONT_FIRST,
+               GEN_FONT_GLYPHS);
+
+    gen_printf(o,
+               "/* 3x5: five 3-bit rows, row 0 in bits 14..12, leftmost pixel is the MSB. */\n"
+               "static const uint16_t g_tof_font3x5[TOF_FONT_GLYPHS] = {\n");
+    for (uint32_t i = 0u; i < GEN_FONT_GLYPHS; i++)
+    {
+        uint8_t rows[5];
+        gen_glyph_3x5((char)(GEN_FONT_FIRST + i), rows);
+        uint32_t g = 0u;
+        for (uint32_t y = 0u; y < 5u; y++)
+        {
+            g = (g << 3) | (rows[y] & 0x7u);
+        }
+        gen_printf(o, "    0x%04Xu, /* %s */\n", g, gen_char_name(GEN_FONT_FIRST + i));
+    }
+    gen_printf(o, "};\n\n");
+
+    gen_printf(o,
+               "/* 3x5 pre-expanded 2x horizontally: five 6-bit rows, row 0 in bits 29..24. */\n"
+               "static const uint32_t g_tof_font3x5_x2[TOF_FONT_GLYPHS] = {\n");
+    for (uint32_t i = 0u; i < GEN_FONT_GLYPHS; i++)
+    {
+        uint8_t rows[5];
+        gen_glyph_3x5((char)(GEN_FONT_FIRST + i), rows);
+        uint32_t g = 0u;
+        for (uint32_t y = 0u; y < 5u; y++)
+        {
+            uint32_t wide = 0u;
+            for (uint32_t x = 0u; x < 3u; x++)
+            {
+                const uint32_t bit = (rows[y] >> (2u - x)) & 1u;
+                wide = (wide << 2) | (bit * 3u);
+            }
+            g = (g << 6) | wide;
+        }
+        gen_printf(o, "    0x%08Xu, /* %s */\n", g, gen_char_name(GEN_FONT_FIRST + i));
+    }
+    gen_printf(o, "};\n\n");
+
+    gen_printf(o,
+               "/* 5x7: one 5-bit row per byte, leftmost pixel is bit 4. */\n"
+               "static const uint8_t g_tof_font5x7[TOF_FONT_GLYPHS][7] = {\n");
+    for (uint32_t i = 0u; i < GEN_FONT_GLYPHS; i++)
+    {
+        uint8_t rows[7];
+        gen_glyph_5x7((char)(GEN_FONT_FIRST + i), rows);
+        gen_printf(o, "    {");
+        for (uint32_t y = 0u; y < 7u; y++)
+        {
+            gen_printf(o, "%s0x%02Xu", (y == 0u) ? "" : ", ", rows[y] & 0x1Fu);
+        }
+        gen_printf(o, "}, /* %s */\n", gen_char_name(GEN_FONT_FIRST + i));
+    }
+    gen_printf(o, "};\n\n");
+
+    gen_printf(o,
+               "static inline uint32_t tof_font_index(char ch)\n"
+               "{\n"
+               "    const uint32_t idx = (uint32_t)(uint8_t)ch - TOF_FONT_FIRST;\n"
+               "    return (idx < TOF_FONT_GLYPHS) ? idx : TOF_FONT_FALLBACK;\n"
+               "}\n");
+}
+
+static int gen_check(const gen_out_t *o, const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        fprintf(stderr, "gen_tof_font: cannot open %s\n", path);
+        return 1;
+    }
+    char *cur = malloc(o->len + 1u);
+    const size_t n = cur ? fread(cur, 1u, o->len + 1u, f) : 0u;
+    fclose(f);
+    const int same = (cur != NULL) && (n == o->len) && (memcmp(cur, o->buf, o->len) == 0);
+    free(cur);
+    if (!same)
+    {
+        fprintf(stderr, "gen_tof_font: %s is stale, regenerate it with tools/gen_tof_font.c\n", path);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    gen_out_t out = {0};
+    gen_header(&out);
+
+    int rc = 0;
+    if (argc == 3 && strcmp(argv[1], "--check") == 0)
+    {
+        rc = gen_check(&out, argv[2]);
+    }
+    else if (argc == 1)
+    {
+        rc = (fwrite(out.buf, 1u, out.len, stdout) == out.len) ? 0 : 1;
+    }
+    else
+    {
+        fprintf(stderr, "usage: %s [--check header]\n", argv[0]);
+        rc = 2;
+    }
+    free(out.buf);
+    return rc;
+}
+
+#endif /* GEN_TOF_FONT_NO_MAIN */